@@ -0,0 +1,39 @@
+#include "nanobench.hpp"
+
+#include "physics/broad_phase.hpp"
+
+constexpr int BodyNum = 3000;
+
+using namespace nickel;
+
+int main(int, char**) {
+    std::vector<physics::AABB> bounds;
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<physics::Real> posDist(0, 2000);
+    std::uniform_real_distribution<physics::Real> sizeDist(2, 15);
+
+    for (int i = 0; i < BodyNum; i++) {
+        bounds.push_back(physics::AABB::FromCenter(
+            {posDist(gen), posDist(gen)}, {sizeDist(gen), sizeDist(gen)}));
+    }
+
+    std::vector<physics::BroadPhasePair> pairs;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("broad phase").relative(true);
+
+    physics::BruteForceBroadPhase bruteForce;
+    bench.run("brute force", [&] {
+        bruteForce.FindPairs(bounds, pairs);
+        ankerl::nanobench::doNotOptimizeAway(pairs);
+    });
+
+    physics::SweepAndPruneBroadPhase sap;
+    bench.run("sweep and prune", [&] {
+        sap.FindPairs(bounds, pairs);
+        ankerl::nanobench::doNotOptimizeAway(pairs);
+    });
+
+    return 0;
+}
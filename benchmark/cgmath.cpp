@@ -0,0 +1,98 @@
+#include "nanobench.hpp"
+
+#include "common/cgmath.hpp"
+
+#include <random>
+
+constexpr int PointNum = 10000;
+
+using namespace nickel;
+
+int main(int, char**) {
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dist(-100, 100);
+
+    cgmath::Mat44 m1, m2;
+    for (int i = 0; i < 16; i++) {
+        m1.data[i] = dist(gen);
+        m2.data[i] = dist(gen);
+    }
+
+    std::vector<cgmath::Vec4> points(PointNum);
+    std::vector<float> xs(PointNum), ys(PointNum), zs(PointNum);
+    for (int i = 0; i < PointNum; i++) {
+        xs[i] = dist(gen);
+        ys[i] = dist(gen);
+        zs[i] = dist(gen);
+        points[i] = cgmath::Vec4{xs[i], ys[i], zs[i], 1};
+    }
+    std::vector<float> outXs(PointNum), outYs(PointNum), outZs(PointNum);
+    std::vector<cgmath::Vec4> outPoints(PointNum);
+
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("Mat44 multiply").relative(true);
+
+        bench.run("scalar loop", [&] {
+            cgmath::Mat44 result;
+            for (int i = 0; i < 4; i++) {
+                for (int j = 0; j < 4; j++) {
+                    float sum = 0;
+                    for (int k = 0; k < 4; k++) {
+                        sum += m1.Get(k, i) * m2.Get(j, k);
+                    }
+                    result.Set(j, i, sum);
+                }
+            }
+            ankerl::nanobench::doNotOptimizeAway(result);
+        });
+
+        bench.run("cgmath", [&] {
+            auto result = m1 * m2;
+            ankerl::nanobench::doNotOptimizeAway(result);
+        });
+    }
+
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("Vec4 add and scale").relative(true);
+
+        bench.run("scalar loop", [&] {
+            for (int i = 0; i < PointNum; i++) {
+                for (int j = 0; j < 4; j++) {
+                    outPoints[i].data[j] =
+                        (points[i].data[j] + points[i & 3].data[j]) * 0.5f;
+                }
+            }
+            ankerl::nanobench::doNotOptimizeAway(outPoints);
+        });
+
+        bench.run("cgmath", [&] {
+            for (int i = 0; i < PointNum; i++) {
+                outPoints[i] = (points[i] + points[i & 3]) * 0.5f;
+            }
+            ankerl::nanobench::doNotOptimizeAway(outPoints);
+        });
+    }
+
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("transform points").relative(true);
+
+        bench.run("Mat44 * Vec4 per point", [&] {
+            for (int i = 0; i < PointNum; i++) {
+                outPoints[i] = m1 * points[i];
+            }
+            ankerl::nanobench::doNotOptimizeAway(outPoints);
+        });
+
+        bench.run("structure of arrays", [&] {
+            cgmath::TransformPoints(m1, xs.data(), ys.data(), zs.data(),
+                                    outXs.data(), outYs.data(), outZs.data(),
+                                    PointNum);
+            ankerl::nanobench::doNotOptimizeAway(outXs);
+        });
+    }
+
+    return 0;
+}
@@ -38,11 +38,91 @@ int main(int, char**) {
         geomPairs.push_back({std::move(g1), std::move(g2)});
     }
 
-    ankerl::nanobench::Bench().run("gjk algorithm", [&] {
-        for (auto& [g1, g2] : geomPairs) {
-            geom2d::Gjk(g1, g2);
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("gjk intersect").relative(true);
+
+        bench.run("gjk on vectors", [&] {
+            for (auto& [g1, g2] : geomPairs) {
+                ankerl::nanobench::doNotOptimizeAway(geom2d::Gjk(g1, g2));
+            }
+        });
+
+        bench.run("gjk on support functions", [&] {
+            for (auto& [g1, g2] : geomPairs) {
+                ankerl::nanobench::doNotOptimizeAway(geom2d::GjkIntersect(
+                    geom2d::PolygonView<float>(g1),
+                    geom2d::PolygonView<float>(g2)));
+            }
+        });
+    }
+
+    {
+        ankerl::nanobench::Bench bench;
+        bench.title("gjk + epa").relative(true);
+
+        bench.run("gjk + epa on vectors", [&] {
+            std::array<cgmath::Vec2, 3> tri;
+            std::vector<cgmath::Vec2> simplex;
+            for (auto& [g1, g2] : geomPairs) {
+                if (geom2d::Gjk(g1, g2, nullptr, nullptr, &tri)) {
+                    simplex.assign(tri.begin(), tri.end());
+                    ankerl::nanobench::doNotOptimizeAway(
+                        geom2d::EPA(simplex, g1, g2));
+                }
+            }
+        });
+
+        bench.run("gjk + epa on support functions", [&] {
+            geom2d::GjkSimplex<float> simplex;
+            for (auto& [g1, g2] : geomPairs) {
+                geom2d::PolygonView<float> p1(g1), p2(g2);
+                if (geom2d::GjkIntersect(p1, p2, &simplex)) {
+                    ankerl::nanobench::doNotOptimizeAway(
+                        geom2d::EPA(simplex, p1, p2));
+                }
+            }
+        });
+    }
+
+    {
+        // implicit shapes compared with their polygon approximation
+        constexpr int CircleSegment = 16;
+        std::vector<std::pair<geom2d::Circle<float>, geom2d::Circle<float>>>
+            circles;
+        std::vector<std::pair<geom_type, geom_type>> circlePolygons;
+        for (int i = 0; i < BenchNum; i++) {
+            geom2d::Circle<float> c1{cgmath::Vec2(dist(d), dist(d)), 8};
+            geom2d::Circle<float> c2{cgmath::Vec2(dist(d), dist(d)), 8};
+            circles.push_back({c1, c2});
+
+            geom_type p1, p2;
+            for (int j = 0; j < CircleSegment; j++) {
+                float radians = 2 * cgmath::PI * j / CircleSegment;
+                cgmath::Vec2 offset{std::cos(radians) * 8,
+                                    std::sin(radians) * 8};
+                p1.push_back(c1.center + offset);
+                p2.push_back(c2.center + offset);
+            }
+            circlePolygons.push_back({std::move(p1), std::move(p2)});
         }
-    });
+
+        ankerl::nanobench::Bench bench;
+        bench.title("gjk on circles").relative(true);
+
+        bench.run("polygonized circles on vectors", [&] {
+            for (auto& [p1, p2] : circlePolygons) {
+                ankerl::nanobench::doNotOptimizeAway(geom2d::Gjk(p1, p2));
+            }
+        });
+
+        bench.run("implicit circles", [&] {
+            for (auto& [c1, c2] : circles) {
+                ankerl::nanobench::doNotOptimizeAway(
+                    geom2d::GjkIntersect(c1, c2));
+            }
+        });
+    }
 
     return 0;
 }
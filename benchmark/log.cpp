@@ -0,0 +1,44 @@
+#include "nanobench.hpp"
+
+#include "common/log.hpp"
+
+using namespace logger;
+
+int main() {
+    constexpr int LogNum = 1000;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("LOGW to file").relative(true).minEpochIterations(10);
+
+    std::string filename = "log_bench.txt";
+    for (bool async : {false, true}) {
+        std::ofstream file{filename};
+        Logger logger{file};
+        std::unique_ptr<AsyncLogBackend> backend;
+        if (async) {
+            // rate limit off, measure the raw cost of pushing
+            backend = std::make_unique<AsyncLogBackend>(
+                AsyncLogBackend::DefaultCapacity, 0, std::cerr);
+            logger.SetAsyncBackend(backend.get());
+        }
+
+        int asset = 0;
+        bench.run(async ? "async" : "sync", [&] {
+            for (int i = 0; i < LogNum; i++) {
+                logger.Warning(__FUNCTION__, __FILE__, __LINE__, "[",
+                               "Asset", "]:", "texture ", asset++,
+                               " not exists, size ", 1.5f);
+            }
+            // count the formatting on backend thread too
+            if (backend) {
+                backend->Flush();
+            }
+        });
+        if (backend) {
+            std::cout << "dropped: " << backend->DroppedCount() << std::endl;
+        }
+    }
+
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "nanobench.hpp"
+
+#include "physics/world.hpp"
+
+#include <atomic>
+#include <new>
+
+constexpr int BodyNum = 2000;
+constexpr int WarmupStepNum = 10;
+constexpr int CountStepNum = 100;
+constexpr int StackNum = 200;
+constexpr int StackHeight = 10;
+
+static std::atomic<size_t> gAllocCount = 0;
+
+void* operator new(size_t size) {
+    gAllocCount++;
+    if (auto ptr = std::malloc(size); ptr) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+using namespace nickel;
+
+int main(int, char**) {
+    std::vector<physics::Body> bodies;
+    std::vector<physics::CollideShape> shapes;
+    bodies.reserve(BodyNum + 1);
+    shapes.reserve(BodyNum + 1);
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<physics::Real> posDist(0, 2000);
+
+    bodies.push_back(physics::Body::CreateStatic({1000, 2100}));
+    shapes.emplace_back(
+        physics::OBBShape::FromCenter({}, {1000, 50}, 0.0));
+
+    for (int i = 0; i < BodyNum; i++) {
+        bodies.push_back(
+            physics::Body::CreateDynamic({posDist(gen), posDist(gen)}));
+        shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+    }
+
+    ankerl::nanobench::Bench bench;
+    bench.title("physics world step").relative(true);
+
+    for (auto type : {physics::BroadPhase::Type::BruteForce,
+                      physics::BroadPhase::Type::SweepAndPrune}) {
+        physics::World world{type};
+        auto stepBodies = bodies;
+
+        for (int i = 0; i < WarmupStepNum; i++) {
+            world.Step(0.016, stepBodies, shapes);
+        }
+
+        // buffers are reused after warmup, steady steps should not allocate
+        size_t allocCount = gAllocCount;
+        for (int i = 0; i < CountStepNum; i++) {
+            world.Step(0.016, stepBodies, shapes);
+        }
+        std::cout << "heap allocations in " << CountStepNum
+                  << " steady steps: " << gAllocCount - allocCount
+                  << std::endl;
+
+        bench.run(type == physics::BroadPhase::Type::BruteForce
+                      ? "step(brute force)"
+                      : "step(sweep and prune)",
+                  [&] { world.Step(0.016, stepBodies, shapes); });
+    }
+
+    // many separated stacks, each one is an island
+    bodies.clear();
+    shapes.clear();
+    bodies.push_back(physics::Body::CreateStatic({0, 100}));
+    shapes.emplace_back(
+        physics::OBBShape::FromCenter({}, {StackNum * 50.0f, 10}, 0.0));
+    for (int stack = 0; stack < StackNum; stack++) {
+        for (int i = 0; i < StackHeight; i++) {
+            bodies.push_back(physics::Body::CreateDynamic(
+                {stack * 50.0f - StackNum * 25.0f, 80.0f - i * 20}));
+            shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+        }
+    }
+
+    ankerl::nanobench::Bench islandBench;
+    islandBench.title("island solving").relative(true);
+
+    for (uint32_t workerCount : {0u, 1u, 3u, 7u}) {
+        physics::World world;
+        world.EnableSleeping(false);
+        world.SetWorkerCount(workerCount);
+        world.forceGenerators.emplace_back([](physics::Body& body) {
+            body.force += physics::Vec2{0, 980};
+        });
+        auto stepBodies = bodies;
+
+        for (int i = 0; i < WarmupStepNum; i++) {
+            world.Step(0.016, stepBodies, shapes);
+        }
+
+        islandBench.run("step(" + std::to_string(workerCount) + " workers)",
+                        [&] { world.Step(0.016, stepBodies, shapes); });
+    }
+
+    // settled stacks on overlapped static tiles
+    for (int i = 0; i < StackNum * 4; i++) {
+        bodies.push_back(
+            physics::Body::CreateStatic({i * 12.0f - StackNum * 25.0f, 200}));
+        shapes.emplace_back(physics::OBBShape::FromCenter({}, {8, 8}, 0.0));
+    }
+
+    ankerl::nanobench::Bench idleBench;
+    idleBench.title("idle world").relative(true);
+
+    for (bool sleeping : {false, true}) {
+        physics::World world;
+        world.EnableSleeping(sleeping);
+        world.forceGenerators.emplace_back([](physics::Body& body) {
+            body.force += physics::Vec2{0, 980};
+        });
+        auto stepBodies = bodies;
+
+        for (int i = 0; i < 300; i++) {
+            world.Step(0.016, stepBodies, shapes);
+        }
+
+        std::cout << "awake islands: " << world.GetIslandCount() << std::endl;
+        idleBench.run(sleeping ? "step(sleeping)" : "step(no sleeping)",
+                      [&] { world.Step(0.016, stepBodies, shapes); });
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "nanobench.hpp"
+
+#include "common/timer_wheel.hpp"
+
+#include <random>
+
+using namespace nickel;
+
+constexpr int TimerNum = 50000;
+constexpr uint64_t FrameTicks = 16;
+
+int main() {
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<uint64_t> cooldownDist{100, 5000};
+
+    ankerl::nanobench::Bench bench;
+    bench.title("50000 cooldown timers, one frame").relative(true);
+
+    // every timer polled each frame, like `Timer::Update()`
+    {
+        struct PolledTimer {
+            uint64_t cur = 0;
+            uint64_t dst;
+        };
+        std::vector<PolledTimer> timers;
+        for (int i = 0; i < TimerNum; i++) {
+            timers.push_back({0, cooldownDist(gen)});
+        }
+        uint64_t fired = 0;
+        bench.run("poll", [&] {
+            for (auto& timer : timers) {
+                timer.cur += FrameTicks;
+                if (timer.cur > timer.dst) {
+                    timer.cur = 0;
+                    timer.dst = cooldownDist(gen);
+                    fired++;
+                }
+            }
+        });
+        ankerl::nanobench::doNotOptimizeAway(fired);
+    }
+
+    {
+        TimerWheel wheel;
+        std::vector<TimerWheel::Expired> expired;
+        for (int i = 0; i < TimerNum; i++) {
+            wheel.Schedule(cooldownDist(gen), i);
+        }
+        bench.run("timer wheel", [&] {
+            expired.clear();
+            wheel.Advance(FrameTicks, expired);
+            // expired cooldowns start again
+            for (auto& e : expired) {
+                wheel.Schedule(cooldownDist(gen), e.userData);
+            }
+        });
+    }
+
+    return 0;
+}
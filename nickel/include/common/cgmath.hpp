@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "common/assert.hpp"
+#include "common/simd.hpp"
 
 namespace nickel {
 
@@ -108,13 +109,51 @@ Vec<T, 3> Cross(const Vec<T, 3>& v1, const Vec<T, 3>& v2);
 template <typename T, CGMATH_LEN_TYPE N>
 Vec<T, N> Normalize(const Vec<T, N>& v);
 
+namespace internal {
+
+// float Vec3/Vec4 fit in one SIMD register
+template <typename T, CGMATH_LEN_TYPE N>
+constexpr bool IsSimdVec = std::is_same_v<T, float> && (N == 3 || N == 4);
+
+#ifdef CGMATH_MATRIX_ROW_FIRST
+constexpr bool IsColMajor = false;
+#else
+constexpr bool IsColMajor = true;
+#endif
+
+template <CGMATH_LEN_TYPE N>
+simd::Float4 SimdLoad(const float* p) {
+    if constexpr (N == 4) {
+        return simd::Load4(p);
+    } else {
+        return simd::Load3(p);
+    }
+}
+
+template <CGMATH_LEN_TYPE N>
+void SimdStore(float* p, simd::Float4 v) {
+    if constexpr (N == 4) {
+        simd::Store4(p, v);
+    } else {
+        simd::Store3(p, v);
+    }
+}
+
+}  // namespace internal
+
 // Vec function implementations
 
 template <typename T, CGMATH_LEN_TYPE N>
 Vec<T, N> operator+(const Vec<T, N>& v1, const Vec<T, N>& v2) {
     Vec<T, N> result;
-    for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
-        result.data[i] = v1.data[i] + v2.data[i];
+    if constexpr (internal::IsSimdVec<T, N>) {
+        internal::SimdStore<N>(
+            result.data, simd::Add(internal::SimdLoad<N>(v1.data),
+                                   internal::SimdLoad<N>(v2.data)));
+    } else {
+        for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
+            result.data[i] = v1.data[i] + v2.data[i];
+        }
     }
     return result;
 }
@@ -122,17 +161,32 @@ Vec<T, N> operator+(const Vec<T, N>& v1, const Vec<T, N>& v2) {
 template <typename T, CGMATH_LEN_TYPE N>
 Vec<T, N> operator-(const Vec<T, N>& v1, const Vec<T, N>& v2) {
     Vec<T, N> result;
-    for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
-        result.data[i] = v1.data[i] - v2.data[i];
+    if constexpr (internal::IsSimdVec<T, N>) {
+        internal::SimdStore<N>(
+            result.data, simd::Sub(internal::SimdLoad<N>(v1.data),
+                                   internal::SimdLoad<N>(v2.data)));
+    } else {
+        for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
+            result.data[i] = v1.data[i] - v2.data[i];
+        }
     }
     return result;
 }
 
+// NOTE: scalar of other types(e.g. double) promotes the element, SIMD is
+// only used when scalar is float so the result is unchanged
+
 template <typename T, typename U, CGMATH_LEN_TYPE N, typename>
 Vec<T, N> operator*(U value, const Vec<T, N>& v) {
     Vec<T, N> result;
-    for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
-        result.data[i] = v.data[i] * value;
+    if constexpr (internal::IsSimdVec<T, N> && std::is_same_v<U, float>) {
+        internal::SimdStore<N>(result.data,
+                               simd::Mul(internal::SimdLoad<N>(v.data),
+                                         simd::Splat4(value)));
+    } else {
+        for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
+            result.data[i] = v.data[i] * value;
+        }
     }
     return result;
 }
@@ -145,8 +199,14 @@ Vec<T, N> operator*(const Vec<T, N>& v, U value) {
 template <typename T, typename U, CGMATH_LEN_TYPE N, typename>
 Vec<T, N> operator/(const Vec<T, N>& v, U value) {
     Vec<T, N> result;
-    for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
-        result.data[i] = v.data[i] / value;
+    if constexpr (internal::IsSimdVec<T, N> && std::is_same_v<U, float>) {
+        internal::SimdStore<N>(result.data,
+                               simd::Div(internal::SimdLoad<N>(v.data),
+                                         simd::Splat4(value)));
+    } else {
+        for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
+            result.data[i] = v.data[i] / value;
+        }
     }
     return result;
 }
@@ -154,8 +214,14 @@ Vec<T, N> operator/(const Vec<T, N>& v, U value) {
 template <typename T, CGMATH_LEN_TYPE N>
 Vec<T, N> operator*(const Vec<T, N>& v1, const Vec<T, N>& v2) {
     Vec<T, N> result;
-    for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
-        result.data[i] = v1.data[i] * v2.data[i];
+    if constexpr (internal::IsSimdVec<T, N>) {
+        internal::SimdStore<N>(
+            result.data, simd::Mul(internal::SimdLoad<N>(v1.data),
+                                   internal::SimdLoad<N>(v2.data)));
+    } else {
+        for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
+            result.data[i] = v1.data[i] * v2.data[i];
+        }
     }
     return result;
 }
@@ -163,8 +229,15 @@ Vec<T, N> operator*(const Vec<T, N>& v1, const Vec<T, N>& v2) {
 template <typename T, CGMATH_LEN_TYPE N>
 Vec<T, N> operator/(const Vec<T, N>& v1, const Vec<T, N>& v2) {
     Vec<T, N> result;
-    for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
-        result.data[i] = v1.data[i] / v2.data[i];
+    if constexpr (internal::IsSimdVec<T, N>) {
+        // last lane of Vec3 is 0 / 0, it is dropped when storing
+        internal::SimdStore<N>(
+            result.data, simd::Div(internal::SimdLoad<N>(v1.data),
+                                   internal::SimdLoad<N>(v2.data)));
+    } else {
+        for (CGMATH_LEN_TYPE i = 0; i < N; i++) {
+            result.data[i] = v1.data[i] / v2.data[i];
+        }
     }
     return result;
 }
@@ -629,6 +702,25 @@ template <typename T, CGMATH_LEN_TYPE Common, CGMATH_LEN_TYPE Mat1Row,
 auto operator*(const Mat<T, Common, Mat1Row>& m1,
                const Mat<T, Mat2Col, Common>& m2) {
     auto result = Mat<T, Mat2Col, Mat1Row>::Zeros();
+    if constexpr (std::is_same_v<T, float> && internal::IsColMajor &&
+                  Common == 4 && Mat1Row == 4 && Mat2Col == 4) {
+        // each result column is a linear combination of m1's columns, summed
+        // in same order as the scalar loop
+        simd::Float4 cols[4];
+        for (int k = 0; k < 4; k++) {
+            cols[k] = simd::Load4(m1.data + k * 4);
+        }
+        for (int j = 0; j < 4; j++) {
+            auto sum = simd::Zero4();
+            for (int k = 0; k < 4; k++) {
+                sum = simd::Add(
+                    sum, simd::Mul(cols[k], simd::Splat4(m2.data[j * 4 + k])));
+            }
+            simd::Store4(result.data + j * 4, sum);
+        }
+        return result;
+    }
+
     for (CGMATH_LEN_TYPE i = 0; i < Mat1Row; i++) {
         for (CGMATH_LEN_TYPE j = 0; j < Mat2Col; j++) {
             T sum{};
@@ -685,6 +777,17 @@ auto operator-(const Mat<T, Col, Row>& m1, const Mat<T, Col, Row>& m2) {
 template <typename T, CGMATH_LEN_TYPE Col, CGMATH_LEN_TYPE Row>
 auto operator*(const Mat<T, Col, Row>& m, const Vec<T, Col>& v) {
     Vec<T, Row> result;
+    if constexpr (std::is_same_v<T, float> && internal::IsColMajor &&
+                  Col == 4 && Row == 4) {
+        auto sum = simd::Zero4();
+        for (int x = 0; x < 4; x++) {
+            sum = simd::Add(sum, simd::Mul(simd::Load4(m.data + x * 4),
+                                           simd::Splat4(v.data[x])));
+        }
+        simd::Store4(result.data, sum);
+        return result;
+    }
+
     for (CGMATH_LEN_TYPE y = 0; y < Row; y++) {
         T sum{};
         for (CGMATH_LEN_TYPE x = 0; x < Col; x++) {
@@ -857,6 +960,185 @@ inline Mat44 CreateScale(const Vec3& scale) {
     // clang-format on
 }
 
+/**
+ * @brief 2D affine transform, a 2x3 matrix whose last row is (0, 0, 1)
+ *
+ * composing and applying it costs far less than Mat44, use it for 2D
+ * transforms and convert to Mat44 only when uploading to GPU
+ */
+struct Affine2D final {
+    using value_type = CGMATH_NUMERIC_TYPE;
+
+    // column major: x axis, y axis, translation. The two axes are
+    // continuous, so they can be loaded as one 4-float vector
+    value_type data[6] = {1, 0, 0, 1, 0, 0};
+
+    static Affine2D Identity() { return {}; }
+
+    static Affine2D FromTranslation(const Vec2& position) {
+        return {
+            {1, 0, 0, 1, position.x, position.y}
+        };
+    }
+
+    static Affine2D FromScale(const Vec2& scale) {
+        return {
+            {scale.x, 0, 0, scale.y, 0, 0}
+        };
+    }
+
+    static Affine2D FromRotation(value_type radians) {
+        value_type cos = std::cos(radians);
+        value_type sin = std::sin(radians);
+        return {
+            {cos, sin, -sin, cos, 0, 0}
+        };
+    }
+
+    /**
+     * @brief same as translation * rotation * scale without matrix multiply
+     */
+    static Affine2D FromTRS(const Vec2& translation, value_type radians,
+                            const Vec2& scale) {
+        value_type cos = std::cos(radians);
+        value_type sin = std::sin(radians);
+        return {
+            {cos * scale.x, sin * scale.x, -sin * scale.y, cos * scale.y,
+             translation.x, translation.y}
+        };
+    }
+
+    Vec2 Translation() const { return Vec2{data[4], data[5]}; }
+
+    Vec2 TransformPoint(const Vec2& p) const {
+        return Vec2{data[0] * p.x + data[2] * p.y + data[4],
+                    data[1] * p.x + data[3] * p.y + data[5]};
+    }
+
+    Vec2 TransformVector(const Vec2& v) const {
+        return Vec2{data[0] * v.x + data[2] * v.y,
+                    data[1] * v.x + data[3] * v.y};
+    }
+
+    Affine2D operator*(const Affine2D& o) const {
+        const value_type* a = data;
+        const value_type* b = o.data;
+        // each line is a 2-float column, written element-wise so compiler
+        // can pack them into vector registers
+        return {
+            {a[0] * b[0] + a[2] * b[1], a[1] * b[0] + a[3] * b[1],
+             a[0] * b[2] + a[2] * b[3], a[1] * b[2] + a[3] * b[3],
+             a[0] * b[4] + a[2] * b[5] + a[4],
+             a[1] * b[4] + a[3] * b[5] + a[5]}
+        };
+    }
+
+    Affine2D& operator*=(const Affine2D& o) { return *this = *this * o; }
+
+    /**
+     * @param z translation in z axis(e.g. layer of sprite)
+     */
+    Mat44 ToMat44(value_type z = 0) const {
+        // clang-format off
+        return Mat44::FromRow({
+            data[0], data[2], 0.0f, data[4],
+            data[1], data[3], 0.0f, data[5],
+               0.0f,    0.0f, 1.0f,       z,
+               0.0f,    0.0f, 0.0f,    1.0f,
+        });
+        // clang-format on
+    }
+};
+
+/**
+ * @brief transform points in batch, `src` and `dst` can be the same
+ */
+inline void TransformPoints(const Affine2D& m, const Vec2* src, Vec2* dst,
+                            size_t count) {
+    const auto m0 = m.data[0], m1 = m.data[1], m2 = m.data[2],
+                m3 = m.data[3], tx = m.data[4], ty = m.data[5];
+    for (size_t i = 0; i < count; i++) {
+        auto x = src[i].x, y = src[i].y;
+        dst[i].x = m0 * x + m2 * y + tx;
+        dst[i].y = m1 * x + m3 * y + ty;
+    }
+}
+
+/**
+ * @brief transform points(w = 1) stored as structure of arrays, without
+ * perspective division. Same result as `m * Vec4{x, y, z, 1}`
+ * @note output arrays can be the same as input
+ */
+inline void TransformPoints(const Mat<float, 4, 4>& m, const float* xs,
+                            const float* ys, const float* zs, float* outXs,
+                            float* outYs, float* outZs, size_t count) {
+    size_t i = 0;
+    simd::FloatN cols[4][3];
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 3; y++) {
+            cols[x][y] = simd::SplatN(m.Get(x, y));
+        }
+    }
+    float* outs[3] = {outXs, outYs, outZs};
+    for (; i + simd::Width <= count; i += simd::Width) {
+        auto x = simd::LoadN(xs + i);
+        auto y = simd::LoadN(ys + i);
+        auto z = simd::LoadN(zs + i);
+        for (int r = 0; r < 3; r++) {
+            auto sum = simd::Add(simd::ZeroN(), simd::Mul(cols[0][r], x));
+            sum = simd::Add(sum, simd::Mul(cols[1][r], y));
+            sum = simd::Add(sum, simd::Mul(cols[2][r], z));
+            sum = simd::Add(sum, cols[3][r]);
+            simd::StoreN(outs[r] + i, sum);
+        }
+    }
+
+    for (; i < count; i++) {
+        float x = xs[i], y = ys[i], z = zs[i];
+        for (int r = 0; r < 3; r++) {
+            float sum = 0;
+            sum += m.Get(0, r) * x;
+            sum += m.Get(1, r) * y;
+            sum += m.Get(2, r) * z;
+            sum += m.Get(3, r);
+            outs[r][i] = sum;
+        }
+    }
+}
+
+/**
+ * @brief transform 2D points stored as structure of arrays
+ * @note output arrays can be the same as input
+ */
+inline void TransformPoints(const Affine2D& m, const float* xs,
+                            const float* ys, float* outXs, float* outYs,
+                            size_t count) {
+    size_t i = 0;
+    const float m0 = m.data[0], m1 = m.data[1], m2 = m.data[2],
+                m3 = m.data[3], tx = m.data[4], ty = m.data[5];
+    if constexpr (std::is_same_v<Affine2D::value_type, float>) {
+        auto v0 = simd::SplatN(m0), v1 = simd::SplatN(m1),
+             v2 = simd::SplatN(m2), v3 = simd::SplatN(m3),
+             vx = simd::SplatN(tx), vy = simd::SplatN(ty);
+        for (; i + simd::Width <= count; i += simd::Width) {
+            auto x = simd::LoadN(xs + i);
+            auto y = simd::LoadN(ys + i);
+            simd::StoreN(outXs + i, simd::Add(simd::Add(simd::Mul(v0, x),
+                                                        simd::Mul(v2, y)),
+                                              vx));
+            simd::StoreN(outYs + i, simd::Add(simd::Add(simd::Mul(v1, x),
+                                                        simd::Mul(v3, y)),
+                                              vy));
+        }
+    }
+
+    for (; i < count; i++) {
+        float x = xs[i], y = ys[i];
+        outXs[i] = m0 * x + m2 * y + tx;
+        outYs[i] = m1 * x + m3 * y + ty;
+    }
+}
+
 struct Rect {
     Vec2 position, size;
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/job_pool.hpp"
 #include "common/transform.hpp"
 #include "gecs/gecs.hpp"
 
@@ -19,12 +20,77 @@ struct Child {
     std::vector<gecs::entity> entities;
 };
 
+/**
+ * @brief [resource] flat cache of transform hierarchy
+ *
+ * nodes are stored in arrays, each root's subtree is continuous and sorted by
+ * depth, so parents are always updated before children in one linear pass.
+ * Local transforms are compared with the cached ones, only changed nodes and
+ * their descendants recompute matrices and write `GlobalTransform`. Subtrees
+ * are updated in parallel when there are many nodes.
+ *
+ * Component pointers are fetched from registry when rebuilding. Each update
+ * checks cached nodes against registry first(entity alive, component address,
+ * children order), any difference rebuilds the cache. So destroying entities,
+ * removing components or editing `Child` needs no notification
+ */
+class TransformHierarchy final {
+public:
+    /**
+     * @param pool run subtrees on it when there are many nodes, nullptr
+     * updates all on caller thread
+     */
+    void Update(gecs::querier<GlobalTransform, Transform,
+                              gecs::without<Parent>>,
+                gecs::registry, JobPool* pool = nullptr);
+
+    uint32_t NodeCount() const { return static_cast<uint32_t>(nodes_.size()); }
+
+private:
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+    // nodes in one job, subtrees are never split between jobs
+    static constexpr uint32_t BatchNodeCount = 1024;
+    static constexpr uint32_t ParallelNodeCount = BatchNodeCount * 4;
+
+    struct Node final {
+        gecs::entity entity;
+        uint32_t parent;
+        // components fetched when rebuilding
+        const Transform* transform;
+        GlobalTransform* global;
+        // children are continuous, sorted as `Child::entities`
+        uint32_t firstChild;
+        uint32_t childCount;
+        Transform local;
+        cgmath::Affine2D localMat;
+        cgmath::Affine2D world;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> roots_;  // node index of each root in query order
+    std::vector<uint8_t> dirty_;  // world matrix changed in this update
+    std::vector<uint32_t> batches_;  // begin of each batch, last one is end
+
+    void rebuild(gecs::querier<GlobalTransform, Transform,
+                               gecs::without<Parent>>&,
+                 gecs::registry);
+    /**
+     * @return false if roots differ from cache, or their components moved
+     */
+    bool rootsMatch(gecs::querier<GlobalTransform, Transform,
+                                  gecs::without<Parent>>&) const;
+    /**
+     * @return false if any node in [begin, end) was destroyed, lost or moved
+     * its components, or its children changed
+     */
+    bool nodesMatch(uint32_t begin, uint32_t end, gecs::registry) const;
+    void updateBatch(uint32_t begin, uint32_t end, bool force);
+};
+
 void UpdateGlobalTransform(
-    gecs::querier<gecs::mut<GlobalTransform>, gecs::mut<Transform>, Child,
-                  gecs::without<Parent>>,
-    gecs::querier<gecs::mut<GlobalTransform>, gecs::mut<Transform>,
-                  gecs::without<Parent>>,
-    gecs::registry);
+    gecs::querier<GlobalTransform, Transform, gecs::without<Parent>>,
+    gecs::resource<gecs::mut<TransformHierarchy>>,
+    gecs::resource<gecs::mut<JobPool>>, gecs::registry);
 
 struct HierarchyTool final {
 public:
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nickel {
+
+/**
+ * @brief a fixed group of worker threads to run data-parallel jobs
+ * @note caller thread joins the work, so `JobPool(0)` runs everything on
+ * the caller thread
+ *
+ * engine keeps one pool as a resource, shared by physics, transform
+ * hierarchy and texture loading
+ */
+class JobPool final {
+public:
+    explicit JobPool(uint32_t workerCount);
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+    ~JobPool();
+
+    /**
+     * @brief hardware threads minus the caller thread
+     */
+    static uint32_t DefaultWorkerCount();
+
+    uint32_t WorkerCount() const {
+        return static_cast<uint32_t>(workers_.size());
+    }
+
+    /**
+     * @brief call `f(i)` for each i in [0, count) and wait all of them
+     * @note order between indices is unspecified, jobs must not touch same
+     * data. Won't allocate memory
+     * @note a call made while the pool is running another batch(nested in a
+     * job or from another thread) runs on the caller thread
+     */
+    template <typename F>
+    void ParallelFor(size_t count, F&& f) {
+        using func_type = std::remove_reference_t<F>;
+        dispatch(
+            count,
+            [](void* ctx, size_t i) { (*static_cast<func_type*>(ctx))(i); },
+            const_cast<void*>(static_cast<const void*>(&f)));
+    }
+
+private:
+    using JobFn = void (*)(void*, size_t);
+
+    std::vector<std::thread> workers_;
+    std::atomic<bool> dispatching_{false};  // a batch is running
+    std::mutex mutex_;
+    std::condition_variable wakeCond_;
+    std::condition_variable doneCond_;
+
+    // current job batch, only changed when all workers are idle
+    JobFn fn_ = nullptr;
+    void* ctx_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    uint32_t busy_ = 0;
+    uint64_t generation_ = 0;
+    bool quit_ = false;
+
+    void dispatch(size_t count, JobFn fn, void* ctx);
+    void runJobs();
+    void workerLoop();
+};
+
+}  // namespace nickel
@@ -1,14 +1,26 @@
 // Copyright 2023 VisualGMQ
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <string_view>
 #include <vector>
+#include <deque>
 #include <fstream>
 #include <map>
 #include <utility>
 #include <string>
 #include <memory>
+#include <sstream>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 
 namespace logger {
 
@@ -22,6 +34,222 @@ enum Level {
     All,
 };
 
+template <typename T>
+inline std::ostream& operator<<(std::ostream& stream, const std::vector<T>& container) {
+    stream << "[";
+    for (int i = 0; i < container.size(); i++) {
+        stream << container[i];
+        if (i < container.size() - 1) {
+            stream << ", ";
+        }
+    }
+    stream << "]";
+    return stream;
+}
+
+template <typename T, size_t N>
+inline std::ostream& operator<<(std::ostream& stream, const std::array<T, N>& container) {
+    stream << "[";
+    for (int i = 0; i < container.size(); i++) {
+        stream << container[i];
+        if (i < container.size() - 1) {
+            stream << ", ";
+        }
+    }
+    stream << "]";
+    return stream;
+}
+
+inline std::string_view Level2Str(Level level) {
+    #define CASE(level) case Level::level: return #level;
+    switch (level) {
+        CASE(Trace)
+        CASE(Debug)
+        CASE(Info)
+        CASE(Warning)
+        CASE(Error)
+        CASE(FatalError)
+        default:
+            return "";
+    }
+    #undef CASE
+}
+
+/**
+ * @brief one log message in binary form, arguments are formatted later on
+ * the backend thread
+ */
+struct AsyncRecord final {
+    enum class ArgType : uint8_t {
+        Int,
+        UInt,
+        Float,
+        Bool,
+        Char,
+        Pointer,
+        String,
+    };
+
+    static constexpr size_t ArgsCapacity = 192;
+
+    std::ostream* stream;
+    // from `__FUNCTION__` and `__FILE__`, so only pointers are kept
+    std::string_view funcName;
+    std::string_view filename;
+    unsigned int line;
+    Level level;
+    uint32_t suppressed = 0;  // similar messages dropped before this one
+    uint16_t argsSize = 0;
+    bool truncated = false;
+    char args[ArgsCapacity];
+
+    template <typename T>
+    void Append(const T& value) {
+        using type = std::decay_t<T>;
+        if constexpr (std::is_same_v<type, bool>) {
+            put(ArgType::Bool, value);
+        } else if constexpr (std::is_same_v<type, char> ||
+                             std::is_same_v<type, signed char> ||
+                             std::is_same_v<type, unsigned char>) {
+            put(ArgType::Char, static_cast<char>(value));
+        } else if constexpr (std::is_integral_v<type> &&
+                             std::is_signed_v<type>) {
+            put(ArgType::Int, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<type>) {
+            put(ArgType::UInt, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<type>) {
+            put(ArgType::Float, static_cast<double>(value));
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            putString(std::string_view(value));
+        } else if constexpr (std::is_pointer_v<type>) {
+            put(ArgType::Pointer, static_cast<const void*>(value));
+        } else {
+            // uncommon types are formatted on caller thread
+            std::ostringstream stream;
+            stream << value;
+            putString(stream.str());
+        }
+    }
+
+    size_t UsedSize() const {
+        return offsetof(AsyncRecord, args) + argsSize;
+    }
+
+ private:
+    template <typename T>
+    void put(ArgType type, const T& value) {
+        if (argsSize + 1 + sizeof(T) > ArgsCapacity) {
+            truncated = true;
+            return;
+        }
+        args[argsSize] = static_cast<char>(type);
+        std::memcpy(args + argsSize + 1, &value, sizeof(T));
+        argsSize += static_cast<uint16_t>(1 + sizeof(T));
+    }
+
+    void putString(std::string_view str) {
+        constexpr size_t header = 1 + sizeof(uint16_t);
+        if (argsSize + header > ArgsCapacity) {
+            truncated = true;
+            return;
+        }
+        size_t len = std::min(str.size(), ArgsCapacity - argsSize - header);
+        truncated = truncated || len < str.size();
+        auto len16 = static_cast<uint16_t>(len);
+        args[argsSize] = static_cast<char>(ArgType::String);
+        std::memcpy(args + argsSize + 1, &len16, sizeof(len16));
+        std::memcpy(args + argsSize + header, str.data(), len);
+        argsSize += static_cast<uint16_t>(header + len);
+    }
+};
+
+/**
+ * @brief writes logs on a background thread
+ *
+ * callers push `AsyncRecord` into a bounded lock-free MPSC ring and return,
+ * the backend thread formats them and flushes each stream once per batch.
+ * When the ring is full new records are dropped and counted. Messages from
+ * one call site(file + line) beyond `rateLimit` per second are suppressed
+ */
+class AsyncLogBackend final {
+ public:
+    static constexpr size_t DefaultCapacity = 4096;
+    static constexpr uint32_t DefaultRateLimit = 32;
+
+    /**
+     * @param capacity max records in ring, rounded up to power of 2
+     * @param rateLimit max messages per second from one call site
+     * @param reportStream where to report dropped messages
+     */
+    AsyncLogBackend(size_t capacity, uint32_t rateLimit,
+                    std::ostream& reportStream);
+    AsyncLogBackend(const AsyncLogBackend&) = delete;
+    AsyncLogBackend& operator=(const AsyncLogBackend&) = delete;
+
+    /**
+     * @brief write all pending records and stop the thread
+     */
+    ~AsyncLogBackend();
+
+    /**
+     * @return false if dropped(ring full or rate limited)
+     * @note thread safe, lock free, won't allocate. `FatalError` record
+     * blocks until it is written
+     */
+    bool Push(const AsyncRecord&);
+
+    /**
+     * @brief block until records pushed before this call are written
+     */
+    void Flush();
+
+    uint64_t DroppedCount() const {
+        return totalDropped_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    struct Slot final {
+        std::atomic<size_t> seq;
+        AsyncRecord record;
+    };
+
+    struct CallSite final {
+        std::atomic<uint64_t> key{0};
+        std::atomic<int64_t> windowStart{0};
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint32_t> suppressed{0};
+    };
+
+    static constexpr size_t CallSiteCount = 256;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    uint32_t rateLimit_;
+    std::unique_ptr<CallSite[]> callSites_;
+    std::ostream& reportStream_;
+
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> totalDropped_{0};
+
+    // only touched by backend thread
+    size_t dequeuePos_ = 0;
+    std::vector<std::ostream*> dirtyStreams_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeCond_;
+    std::condition_variable flushedCond_;
+    size_t writtenPos_ = 0;
+    bool flushRequested_ = false;
+    bool quit_ = false;
+    std::thread thread_;
+
+    bool rateLimit(const AsyncRecord&, uint32_t& suppressed);
+    bool pop();
+    void write(const AsyncRecord&);
+    void threadLoop();
+};
+
 class Logger final {
  public:
     Logger(std::ostream& o): stream_(o), level_(All) {}
@@ -58,14 +286,30 @@ class Logger final {
 
     void SetLevel(Level level) { level_ = level; }
 
+    /**
+     * @brief route logs to `backend`(nullptr goes back to synchronous)
+     * @note call it when no other thread is logging
+     */
+    void SetAsyncBackend(AsyncLogBackend* backend) { async_ = backend; }
+
  private:
     std::ostream& stream_;
     Level level_;
+    AsyncLogBackend* async_ = nullptr;
 
     template <typename... Args>
     void log(Level level, std::string_view funcName, std::string_view filename, unsigned int line, Args&&... args) {
-        if (level <= level_) {
-            printf("[%s][%s][%s][%u]", Level2Str(level).data(), filename.data(), funcName.data(), line);
+        if (level <= level_ && async_) {
+            AsyncRecord record;
+            record.stream = &stream_;
+            record.funcName = funcName;
+            record.filename = filename;
+            record.line = line;
+            record.level = level;
+            (record.Append(args), ...);
+            async_->Push(record);
+        } else if (level <= level_) {
+            stream_ << "[" << Level2Str(level) << "][" << filename << "][" << funcName << "][" << line << "]";
             doLog(std::forward<Args>(args)...);
             stream_ << std::endl;
         }
@@ -82,20 +326,6 @@ class Logger final {
         stream_ << param;
     }
 
-    std::string_view Level2Str(Level level) {
-        #define CASE(level) case Level::level: return #level;
-        switch (level) {
-            CASE(Trace)
-            CASE(Debug)
-            CASE(Info)
-            CASE(Warning)
-            CASE(Error)
-            CASE(FatalError)
-            default:
-                return "";
-        }
-        #undef CASE
-    }
 };
 
 class LoggerMgr final {
@@ -111,51 +341,72 @@ class LoggerMgr final {
     static Logger& CreateFromFile(const std::string& name, const std::string& filename, bool append = false) {
         auto& instance = Instance();
         instance.files_.emplace_back(filename, append ? std::ios::app : std::ios::trunc);
-        return instance.loggers_.emplace(name, Logger(instance.files_.back())).first->second;
+        auto& logger = instance.loggers_.emplace(name, Logger(instance.files_.back())).first->second;
+        logger.SetAsyncBackend(instance.async_.get());
+        return logger;
     }
 
     static Logger& CreateFromOstream(const std::string& name, std::ostream& o) {
         auto& instance = Instance();
-        return instance.loggers_.emplace(name, o).first->second;
+        auto& logger = instance.loggers_.emplace(name, o).first->second;
+        logger.SetAsyncBackend(instance.async_.get());
+        return logger;
     }
 
     Logger& GetDefault() { return *defaultLogger_; }
 
- private:
-    std::vector<std::ofstream> files_;
-    std::map<std::string, Logger> loggers_;
-    std::unique_ptr<Logger> defaultLogger_;
+    /**
+     * @brief format and write logs of all loggers on a background thread
+     * @note call it when no other thread is logging
+     */
+    void EnableAsync(size_t capacity = AsyncLogBackend::DefaultCapacity,
+                     uint32_t rateLimit = AsyncLogBackend::DefaultRateLimit) {
+        if (async_) {
+            return;
+        }
+        async_ = std::make_unique<AsyncLogBackend>(capacity, rateLimit, std::cout);
+        setAsyncBackend(async_.get());
+    }
 
-    LoggerMgr() {
-        defaultLogger_.reset(new Logger(std::cout));
+    /**
+     * @brief write pending logs and go back to synchronous logging
+     * @note call it when no other thread is logging
+     */
+    void DisableAsync() {
+        setAsyncBackend(nullptr);
+        async_.reset();
     }
-};
 
-template <typename T>
-inline std::ostream& operator<<(std::ostream& stream, const std::vector<T>& container) {
-    stream << "[";
-    for (int i = 0; i < container.size(); i++) {
-        stream << container[i];
-        if (i < container.size() - 1) {
-            stream << ", ";
+    bool IsAsync() const { return async_ != nullptr; }
+
+    /**
+     * @brief block until pending logs are written, no-op if synchronous
+     */
+    void Flush() {
+        if (async_) {
+            async_->Flush();
         }
     }
-    stream << "]";
-    return stream;
-}
 
-template <typename T, size_t N>
-inline std::ostream& operator<<(std::ostream& stream, const std::array<T, N>& container) {
-    stream << "[";
-    for (int i = 0; i < container.size(); i++) {
-        stream << container[i];
-        if (i < container.size() - 1) {
-            stream << ", ";
+ private:
+    // deque keeps streams in place when new file is opened
+    std::deque<std::ofstream> files_;
+    std::map<std::string, Logger> loggers_;
+    std::unique_ptr<Logger> defaultLogger_;
+    // destroyed first, so pending logs are written before streams close
+    std::unique_ptr<AsyncLogBackend> async_;
+
+    void setAsyncBackend(AsyncLogBackend* backend) {
+        defaultLogger_->SetAsyncBackend(backend);
+        for (auto& [_, logger] : loggers_) {
+            logger.SetAsyncBackend(backend);
         }
     }
-    stream << "]";
-    return stream;
-}
+
+    LoggerMgr() {
+        defaultLogger_.reset(new Logger(std::cout));
+    }
+};
 
 #define LOGT(tag, ...) logger::LoggerMgr::Instance().GetDefault().Trace(__FUNCTION__, __FILE__, __LINE__, "[", tag, "]:", ## __VA_ARGS__)
 #define LOGD(tag, ...) logger::LoggerMgr::Instance().GetDefault().Debug(__FUNCTION__, __FILE__, __LINE__, "[", tag, "]:", ## __VA_ARGS__)
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+
+namespace nickel {
+
+/**
+ * @brief sub-allocate ranges of a fixed size space(e.g. a device memory block)
+ *
+ * best fit on a free list ordered by offset, neighbouring free ranges are
+ * merged when freed. Only does bookkeeping, never touches the memory
+ */
+class RangeAllocator final {
+public:
+    static constexpr uint64_t InvalidOffset =
+        std::numeric_limits<uint64_t>::max();
+
+    explicit RangeAllocator(uint64_t size);
+
+    /**
+     * @brief allocate a range
+     * @param alignment must be power of 2
+     * @return offset of range, `InvalidOffset` when no free range can hold it
+     */
+    uint64_t Allocate(uint64_t size, uint64_t alignment = 1);
+
+    /**
+     * @brief free range allocated at offset
+     */
+    void Free(uint64_t offset);
+
+    uint64_t Size() const { return size_; }
+
+    uint64_t UsedSize() const { return used_; }
+
+    uint64_t LargestFreeRange() const;
+
+    uint32_t FreeRangeCount() const {
+        return static_cast<uint32_t>(freeRanges_.size());
+    }
+
+    uint32_t AllocationCount() const {
+        return static_cast<uint32_t>(allocated_.size());
+    }
+
+    bool Empty() const { return allocated_.empty(); }
+
+private:
+    uint64_t size_;
+    uint64_t used_ = 0;
+    std::map<uint64_t, uint64_t> freeRanges_;  // offset -> size
+    std::map<uint64_t, uint64_t> allocated_;   // offset -> size
+};
+
+/**
+ * @brief bump pointer allocator, free all ranges at once by `Reset()`
+ * @note for transient data which only lives in one frame
+ */
+class LinearAllocator final {
+public:
+    static constexpr uint64_t InvalidOffset = RangeAllocator::InvalidOffset;
+
+    explicit LinearAllocator(uint64_t size) : size_{size} {}
+
+    /**
+     * @param alignment must be power of 2
+     * @return offset of range, `InvalidOffset` when out of space
+     */
+    uint64_t Allocate(uint64_t size, uint64_t alignment = 1) {
+        uint64_t offset = (head_ + alignment - 1) & ~(alignment - 1);
+        if (offset > size_ || size > size_ - offset) {
+            return InvalidOffset;
+        }
+        head_ = offset + size;
+        peak_ = head_ > peak_ ? head_ : peak_;
+        return offset;
+    }
+
+    void Reset() { head_ = 0; }
+
+    uint64_t Size() const { return size_; }
+
+    uint64_t UsedSize() const { return head_; }
+
+    /**
+     * @brief max used size since created, for tuning the size
+     */
+    uint64_t PeakUsedSize() const { return peak_; }
+
+private:
+    uint64_t size_;
+    uint64_t head_ = 0;
+    uint64_t peak_ = 0;
+};
+
+}  // namespace nickel
@@ -0,0 +1,167 @@
+#pragma once
+
+// thin wrapper of SSE/AVX/NEON intrinsics, define `NICKEL_DISABLE_SIMD` to
+// fallback to plain C++. Only element-wise operations are wrapped, so results
+// are bit-identical to scalar code
+
+#if !defined(NICKEL_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NICKEL_SIMD_SSE
+#if defined(__AVX__)
+#define NICKEL_SIMD_AVX
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// armv7 NEON has no IEEE division, only enable on aarch64
+#define NICKEL_SIMD_NEON
+#endif
+#endif
+
+#if defined(NICKEL_SIMD_AVX)
+#include <immintrin.h>
+#elif defined(NICKEL_SIMD_SSE)
+#include <emmintrin.h>
+#elif defined(NICKEL_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <cstddef>
+
+namespace nickel::simd {
+
+#if defined(NICKEL_SIMD_SSE)
+
+using Float4 = __m128;
+
+inline Float4 Load4(const float* p) { return _mm_loadu_ps(p); }
+
+inline void Store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+
+/**
+ * @brief load 3 floats, last lane is 0
+ */
+inline Float4 Load3(const float* p) {
+    return _mm_movelh_ps(
+        _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p))),
+        _mm_load_ss(p + 2));
+}
+
+inline void Store3(float* p, Float4 v) {
+    _mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+    _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+}
+
+inline Float4 Splat4(float value) { return _mm_set1_ps(value); }
+
+inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+
+inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+
+inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+
+inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+
+#elif defined(NICKEL_SIMD_NEON)
+
+using Float4 = float32x4_t;
+
+inline Float4 Load4(const float* p) { return vld1q_f32(p); }
+
+inline void Store4(float* p, Float4 v) { vst1q_f32(p, v); }
+
+inline Float4 Load3(const float* p) {
+    return vcombine_f32(vld1_f32(p), vld1_lane_f32(p + 2, vdup_n_f32(0), 0));
+}
+
+inline void Store3(float* p, Float4 v) {
+    vst1_f32(p, vget_low_f32(v));
+    vst1q_lane_f32(p + 2, v, 2);
+}
+
+inline Float4 Splat4(float value) { return vdupq_n_f32(value); }
+
+inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+
+inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+
+inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+
+inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+
+#else
+
+struct Float4 final {
+    float v[4];
+};
+
+inline Float4 Load4(const float* p) { return {p[0], p[1], p[2], p[3]}; }
+
+inline void Store4(float* p, Float4 v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = v.v[i];
+    }
+}
+
+inline Float4 Load3(const float* p) { return {p[0], p[1], p[2], 0}; }
+
+inline void Store3(float* p, Float4 v) {
+    for (int i = 0; i < 3; i++) {
+        p[i] = v.v[i];
+    }
+}
+
+inline Float4 Splat4(float value) { return {value, value, value, value}; }
+
+#define NICKEL_SIMD_SCALAR_OP(name, op)          \
+    inline Float4 name(Float4 a, Float4 b) {     \
+        Float4 r;                                \
+        for (int i = 0; i < 4; i++) {            \
+            r.v[i] = a.v[i] op b.v[i];           \
+        }                                        \
+        return r;                                \
+    }
+
+NICKEL_SIMD_SCALAR_OP(Add, +)
+NICKEL_SIMD_SCALAR_OP(Sub, -)
+NICKEL_SIMD_SCALAR_OP(Mul, *)
+NICKEL_SIMD_SCALAR_OP(Div, /)
+
+#undef NICKEL_SIMD_SCALAR_OP
+
+#endif
+
+inline Float4 Zero4() { return Splat4(0); }
+
+// widest vector for batch kernels over float arrays
+
+#if defined(NICKEL_SIMD_AVX)
+
+using FloatN = __m256;
+constexpr size_t Width = 8;
+
+inline FloatN LoadN(const float* p) { return _mm256_loadu_ps(p); }
+
+inline void StoreN(float* p, FloatN v) { _mm256_storeu_ps(p, v); }
+
+inline FloatN SplatN(float value) { return _mm256_set1_ps(value); }
+
+inline FloatN Add(FloatN a, FloatN b) { return _mm256_add_ps(a, b); }
+
+inline FloatN Mul(FloatN a, FloatN b) { return _mm256_mul_ps(a, b); }
+
+#else
+
+using FloatN = Float4;
+constexpr size_t Width = 4;
+
+inline FloatN LoadN(const float* p) { return Load4(p); }
+
+inline void StoreN(float* p, FloatN v) { Store4(p, v); }
+
+inline FloatN SplatN(float value) { return Splat4(value); }
+
+#endif
+
+inline FloatN ZeroN() { return SplatN(0); }
+
+}  // namespace nickel::simd
@@ -3,20 +3,42 @@
 #include "common/asset.hpp"
 #include "common/manager.hpp"
 #include "common/filetype.hpp"
+#include "common/timer_wheel.hpp"
 
 
 namespace nickel {
 
 using TimeType = uint32_t;
 
+/**
+ * @brief timing of one frame, in nanoseconds
+ */
+struct FrameTiming final {
+    uint64_t frame = 0;  // from last frame start to this frame start
+    uint64_t work = 0;   // spent by systems before frame pacing
+    uint64_t wait = 0;   // slept and spun by frame pacing
+};
+
 /**
  * @brief a resource that make you get time elapse between two frame
+ *
+ * also paces frames to FPS: sleep most of the remaining time, then spin to
+ * the deadline, since OS sleep usually overshoots by a millisecond or more
  */
 class Time final {
 public:
+    static constexpr size_t HistorySize = 128;
+    // delta in seconds is clamped to this, so a long hitch(e.g. breakpoint)
+    // won't make subsystems catch up for many frames
+    static constexpr uint64_t MaxDeltaNs = 250'000'000;
+
+    /**
+     * @param fps 0 means no frame pacing
+     * @note takes effect from next `Tick()`, which re-schedules its deadline
+     */
     static void SetFPS(uint32_t fps) {
         fps_ = fps;
-        fpsDuration_ = static_cast<uint64_t>(1000.0 / fps);
+        fpsDuration_ = fps == 0 ? 0 : 1'000'000'000ull / fps;
     }
 
     static uint64_t GetFPS() { return fps_; }
@@ -32,12 +54,49 @@ public:
      * @return elapsed milliseconds
      * */
     TimeType Elapse() const {
-        auto elapse =
-            std::chrono::duration_cast<std::chrono::milliseconds>(elapse_)
-                .count();
-        return elapse > 0 ? elapse : 1;
+        auto elapse = elapseNs_ / 1'000'000;
+        return elapse > 0 ? static_cast<TimeType>(elapse) : 1;
     }
 
+    uint64_t ElapseNs() const { return elapseNs_; }
+
+    uint64_t ElapseUs() const { return elapseNs_ / 1000; }
+
+    /**
+     * @brief elapse time between two frame in seconds, clamped by
+     * `MaxDeltaNs`
+     */
+    double DeltaSeconds() const {
+        return std::min(elapseNs_, MaxDeltaNs) / 1e9;
+    }
+
+    /**
+     * @brief moving average of `DeltaSeconds()`, steady under jitter
+     */
+    double SmoothedDeltaSeconds() const { return smoothedDelta_; }
+
+    size_t HistoryCount() const { return historyCount_; }
+
+    /**
+     * @param framesAgo 0 is the last frame, must < `HistoryCount()`
+     */
+    const FrameTiming& GetFrameTiming(size_t framesAgo = 0) const {
+        Assert(framesAgo < historyCount_, "frame timing out of history");
+        return history_[(historyHead_ + HistorySize - 1 - framesAgo) %
+                        HistorySize];
+    }
+
+    /**
+     * @brief average and max frame time in recorded history
+     */
+    uint64_t AverageFrameNs() const;
+    uint64_t MaxFrameNs() const;
+
+    /**
+     * @brief wait until next frame should start, then measure the frame
+     */
+    void Tick();
+
     static void Update(gecs::resource<gecs::mut<Time>> timer);
 
 private:
@@ -46,10 +105,21 @@ private:
     using time_point_t = typename clock_t::time_point;
 
     static uint64_t fps_;
-    static uint64_t fpsDuration_;
+    static uint64_t fpsDuration_;  // in nanoseconds
+
+    time_point_t curTime_;   // start of this frame
+    time_point_t deadline_;  // when next frame should start
+    uint64_t deadlinePeriodNs_;  // `fpsDuration_` when deadline was set
+    uint64_t elapseNs_;
+    double smoothedDelta_;
+    // how much OS sleep overshoots, spin this long before deadline
+    uint64_t sleepOvershootNs_ = 1'000'000;
 
-    time_point_t curTime_;
-    duration_t elapse_;
+    std::array<FrameTiming, HistorySize> history_;
+    size_t historyHead_ = 0;
+    size_t historyCount_ = 0;
+
+    void pace();
 };
 
 /**
@@ -96,33 +166,10 @@ public:
 
     auto ID() const { return id_; }
 
-    void Update(const Time& t) {
-        if (!isTicking_) return;
-
-        curTime_ += t.Elapse();
-        if (curTime_ > dstTime_) {
-            curTime_ = 0;
-            if (loop_ > 0) {
-                loop_--;
-            }
-            if (shouldSendEvent && id_) {
-                // gWorld->cur_registry()->event_dispatcher<TimerEvent>().enqueue(
-                //     TimerEvent{id_.value()});
-            }
-            if (loop_ == 0) {
-                Stop();
-            }
-        }
-    }
-
-    void Start() { isTicking_ = true; }
-
-    void Pause() {
-        isTicking_ = false;
-        curTime_ = 0;
-    }
-
-    void Stop() { isTicking_ = false; }
+    /**
+     * @brief ticking is driven by `TimerManager::Start()/Stop()/Pause()`
+     */
+    bool IsTicking() const { return isTicking_; }
 
     void Save(const std::filesystem::path& path);
 
@@ -146,6 +193,7 @@ private:
     bool isTicking_ = false;
     TimeType curTime_{};
     TimeType dstTime_;
+    TimerWheel::EntryID wheelEntry_ = TimerWheel::NullEntry;
 
     Timer() {}
 };
@@ -153,12 +201,67 @@ private:
 template <>
 std::unique_ptr<Timer> LoadAssetFromMetaTable(const toml::table& tbl);
 
+/**
+ * @brief manage timer assets, and drive all timers by a timing wheel
+ *
+ * timers are not polled each frame, only expired ones are visited and sent
+ * as `TimerEvent` in one batch
+ */
 class TimerManager : public Manager<Timer> {
 public:
     static FileType GetFileType() { return FileType::Timer; }
 
     TimerHandle Create(const std::filesystem::path& path, TimerID, TimeType, int loop = 0);
     TimerHandle Load(const std::filesystem::path& path);
+
+    /**
+     * @brief start ticking timer asset from where it stopped
+     */
+    void Start(TimerHandle);
+
+    /**
+     * @brief stop ticking timer asset, keep its progress
+     */
+    void Stop(TimerHandle);
+
+    /**
+     * @brief stop ticking timer asset, and reset its progress
+     */
+    void Pause(TimerHandle);
+
+    /**
+     * @brief schedule a lightweight timer(e.g. cooldown) without asset
+     * @param time milliseconds to trigger `TimerEvent{id}`
+     * @param loop same as `Timer`, trigger `loop` times(at least once),
+     * negative repeats until canceled
+     */
+    TimerWheel::EntryID Schedule(TimerID id, TimeType time, int loop = 0);
+
+    /**
+     * @return false if timer already finished or canceled
+     */
+    bool Cancel(TimerWheel::EntryID entry) { return wheel_.Cancel(entry); }
+
+    /**
+     * @brief milliseconds until scheduled timer triggers, 0 if not scheduled
+     */
+    TimeType Remaining(TimerWheel::EntryID entry) const {
+        return static_cast<TimeType>(wheel_.RemainingTicks(entry));
+    }
+
+    static void Update(gecs::resource<gecs::mut<TimerManager>>,
+                       gecs::resource<Time>,
+                       gecs::event_dispatcher<TimerEvent>);
+
+private:
+    // userData of asset timers in wheel, others are `TimerID`
+    static constexpr uint64_t AssetTimerFlag = 1ull << 63;
+
+    TimerWheel wheel_;  // one tick is one millisecond
+    std::vector<TimerWheel::Expired> expired_;
+    uint64_t pendingNs_ = 0;  // elapsed time less than a tick
+
+    void stop(Timer&, bool keepProgress);
 };
 
 }  // namespace nickel
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace nickel {
+
+/**
+ * @brief hierarchical timing wheel
+ *
+ * near timers live in a wheel of 256 one-tick slots, farther ones in four
+ * coarser wheels of 64 slots and cascade down when their slot comes up.
+ * Schedule and cancel are O(1), `Advance()` costs O(ticks + expired)
+ * no matter how many timers are waiting
+ */
+class TimerWheel final {
+public:
+    using EntryID = uint64_t;
+
+    static constexpr EntryID NullEntry = 0;
+
+    struct Expired final {
+        EntryID entry;
+        uint64_t userData;
+    };
+
+    /**
+     * @brief schedule a timer
+     * @param delay expire after this many ticks, at least 1
+     * @param period ticks between repeated expirations
+     * @param count times to expire, negative repeats until canceled
+     */
+    EntryID Schedule(uint64_t delay, uint64_t userData, uint64_t period = 0,
+                     int count = 1);
+
+    /**
+     * @return false if entry already expired or canceled
+     */
+    bool Cancel(EntryID);
+
+    bool IsScheduled(EntryID) const;
+
+    /**
+     * @brief ticks until entry expires, 0 if not scheduled
+     */
+    uint64_t RemainingTicks(EntryID) const;
+
+    /**
+     * @brief move time forward, append expired timers to `expired` in
+     * expiration order
+     * @note repeating timers stay scheduled after expiring
+     */
+    void Advance(uint64_t ticks, std::vector<Expired>& expired);
+
+    uint64_t CurrentTick() const { return curTick_; }
+
+    size_t Size() const { return size_; }
+
+    /**
+     * @brief cancel all timers, their ids stay invalid
+     */
+    void Clear();
+
+private:
+    static constexpr uint32_t NullIndex =
+        std::numeric_limits<uint32_t>::max();
+    static constexpr int NearBits = 8;
+    static constexpr int FarBits = 6;
+    static constexpr int FarLevels = 4;
+    static constexpr uint32_t NearSize = 1u << NearBits;
+    static constexpr uint32_t FarSize = 1u << FarBits;
+    static constexpr uint32_t SlotCount = NearSize + FarSize * FarLevels;
+    // farther timers are put at the end of wheels, and placed again there
+    static constexpr uint64_t MaxRange =
+        (1ull << (NearBits + FarBits * FarLevels)) - 1;
+
+    struct Node final {
+        uint64_t expire = 0;
+        uint64_t period = 0;
+        uint64_t userData = 0;
+        uint32_t prev = NullIndex;
+        uint32_t next = NullIndex;  // next free node when in free list
+        uint32_t slot = NullIndex;  // NullIndex when not scheduled
+        uint32_t generation = 1;
+        int count = 0;
+    };
+
+    std::vector<Node> nodes_;
+    std::array<uint32_t, SlotCount> heads_ = initHeads();
+    uint32_t freeList_ = NullIndex;
+    uint64_t curTick_ = 0;
+    size_t size_ = 0;
+
+    static std::array<uint32_t, SlotCount> initHeads() {
+        std::array<uint32_t, SlotCount> heads;
+        heads.fill(NullIndex);
+        return heads;
+    }
+
+    const Node* find(EntryID) const;
+    void link(uint32_t node);
+    void unlink(uint32_t node);
+    void freeNode(uint32_t node);
+    void cascade(int level);
+};
+
+}  // namespace nickel
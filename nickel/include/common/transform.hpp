@@ -34,13 +34,13 @@ struct Transform final {
         return *this;
     }
 
-    cgmath::Mat44 ToMat() const {
-        return cgmath::CreateTranslation(
-                   cgmath::Vec3{translation.x, translation.y, 0.0}) *
-               cgmath::CreateZRotation(cgmath::Deg2Rad(rotation)) *
-               cgmath::CreateScale(cgmath::Vec3{scale.x, scale.y, 1.0});
+    cgmath::Affine2D ToAffine() const {
+        return cgmath::Affine2D::FromTRS(translation,
+                                         cgmath::Deg2Rad(rotation), scale);
     }
 
+    cgmath::Mat44 ToMat() const { return ToAffine().ToMat44(); }
+
     static Transform Create(const cgmath::Vec2& translation, float rotation,
                                 const cgmath::Vec2& scale) {
         return {translation, rotation, scale};
@@ -55,10 +55,17 @@ struct Transform final {
     static Transform FromScale(const cgmath::Vec2& scale) {
         return {{}, 0, scale};
     }
+
+    bool operator==(const Transform& o) const {
+        return translation == o.translation && rotation == o.rotation &&
+               scale == o.scale;
+    }
+
+    bool operator!=(const Transform& o) const { return !(*this == o); }
 };
 
 struct GlobalTransform final {
-    cgmath::Mat44 mat;
+    cgmath::Affine2D mat;  // call `ToMat44()` when upload to GPU
 };
 
 }  // namespace nickel
\ No newline at end of file
@@ -429,8 +429,10 @@ struct NearestPtInfo final {
 // some function for GJKNearestPt
 namespace internal {
 
-template <typename T>
-void gjkSolve2(Simplex<T, 2>& simplex, const cgmath::Vec<T, 2>& pt) {
+// SimplexT can be `Simplex<T, 2>` or `GjkSimplex<T>`
+
+template <typename SimplexT, typename T>
+void gjkSolve2(SimplexT& simplex, const cgmath::Vec<T, 2>& pt) {
     auto axis = simplex[1].p - simplex[0].p;
     auto lenSqrd = axis.LengthSqrd();
 
@@ -465,8 +467,8 @@ void gjkSolve2(Simplex<T, 2>& simplex, const cgmath::Vec<T, 2>& pt) {
     simplex.count = 2;
 }
 
-template <typename T>
-void gjkSolve3(Simplex<T, 2>& simplex, const cgmath::Vec<T, 2>& pt) {
+template <typename SimplexT, typename T>
+void gjkSolve3(SimplexT& simplex, const cgmath::Vec<T, 2>& pt) {
     auto AB = simplex[1].p - simplex[0].p;
     auto BC = simplex[2].p - simplex[1].p;
     auto CA = simplex[0].p - simplex[2].p;
@@ -903,6 +905,397 @@ std::optional<MTV<T, 2>> EPA(std::vector<cgmath::Vec<T, 2>>& simplex,
     }
 }
 
+// GJK/EPA on support functions, never allocate memory
+
+/**
+ * @brief non-owning view of a convex polygon's vertices
+ */
+template <typename T>
+struct PolygonView final {
+    const cgmath::Vec<T, 2>* pts = nullptr;
+    size_t count = 0;
+
+    PolygonView() = default;
+
+    PolygonView(const cgmath::Vec<T, 2>* pts, size_t count)
+        : pts{pts}, count{count} {}
+
+    PolygonView(const std::vector<cgmath::Vec<T, 2>>& polygon)
+        : pts{polygon.data()}, count{polygon.size()} {}
+
+    template <size_t N>
+    PolygonView(const std::array<cgmath::Vec<T, 2>, N>& polygon)
+        : pts{polygon.data()}, count{N} {}
+};
+
+/**
+ * @brief give the value type of shapes which has `SupportPoint()`
+ */
+template <typename Shape>
+struct SupportShapeTraits;
+
+template <typename T>
+struct SupportShapeTraits<PolygonView<T>> {
+    using value_type = T;
+};
+
+template <typename T>
+struct SupportShapeTraits<Circle<T>> {
+    using value_type = T;
+};
+
+template <typename T>
+struct SupportShapeTraits<Capsule<T>> {
+    using value_type = T;
+};
+
+template <typename T>
+struct SupportShapeTraits<OBB<T>> {
+    using value_type = T;
+};
+
+/**
+ * @brief the farthest point of shape in direction
+ * @note dir may not be normalized
+ */
+template <typename T>
+cgmath::Vec<T, 2> SupportPoint(const PolygonView<T>& polygon,
+                               const cgmath::Vec<T, 2>& dir) {
+    Assert(polygon.count > 0, "polygon has no vertex");
+
+    size_t idx = 0;
+    T max = polygon.pts[0].Dot(dir);
+    for (size_t i = 1; i < polygon.count; i++) {
+        T value = polygon.pts[i].Dot(dir);
+        if (value > max) {
+            max = value;
+            idx = i;
+        }
+    }
+    return polygon.pts[idx];
+}
+
+namespace internal {
+
+template <typename T>
+cgmath::Vec<T, 2> normalizeOrXAxis(const cgmath::Vec<T, 2>& dir) {
+    T len = dir.Length();
+    return len > 0 ? dir / len : cgmath::Vec<T, 2>{1, 0};
+}
+
+}  // namespace internal
+
+template <typename T>
+cgmath::Vec<T, 2> SupportPoint(const Circle<T>& circle,
+                               const cgmath::Vec<T, 2>& dir) {
+    return circle.center + internal::normalizeOrXAxis(dir) * circle.radius;
+}
+
+template <typename T>
+cgmath::Vec<T, 2> SupportPoint(const Capsule<T>& capsule,
+                               const cgmath::Vec<T, 2>& dir) {
+    auto& seg = capsule.seg;
+    auto end = seg.p + seg.dir * seg.len;
+    auto pt = seg.p.Dot(dir) >= end.Dot(dir) ? seg.p : end;
+    return pt + internal::normalizeOrXAxis(dir) * capsule.radius;
+}
+
+template <typename T>
+cgmath::Vec<T, 2> SupportPoint(const OBB<T>& obb,
+                               const cgmath::Vec<T, 2>& dir) {
+    auto [xAxis, yAxis] = obb.GetAxis();
+    auto x = xAxis.Dot(dir) >= 0 ? obb.halfLen.x : -obb.halfLen.x;
+    auto y = yAxis.Dot(dir) >= 0 ? obb.halfLen.y : -obb.halfLen.y;
+    return obb.center + xAxis * x + yAxis * y;
+}
+
+/**
+ * @brief a shape moved by offset, avoid copying vertices of polygon
+ */
+template <typename Shape>
+struct Translated final {
+    Shape shape;
+    cgmath::Vec<typename SupportShapeTraits<Shape>::value_type, 2> offset;
+};
+
+template <typename Shape>
+struct SupportShapeTraits<Translated<Shape>> {
+    using value_type = typename SupportShapeTraits<Shape>::value_type;
+};
+
+template <typename Shape,
+          typename T = typename SupportShapeTraits<Shape>::value_type>
+cgmath::Vec<T, 2> SupportPoint(const Translated<Shape>& translated,
+                               const cgmath::Vec<T, 2>& dir) {
+    return SupportPoint(translated.shape, dir) + translated.offset;
+}
+
+/**
+ * @brief fixed size simplex of Minkowski difference(shape1 - shape2), keeps
+ * support points of both shapes to get witness points
+ */
+template <typename T>
+struct GjkSimplex final {
+    struct Vertex {
+        cgmath::Vec<T, 2> a;  // support point on shape1
+        cgmath::Vec<T, 2> b;  // support point on shape2
+        cgmath::Vec<T, 2> p;  // p = a - b
+        T u;                  // barycentric param, divided by `divisor`
+    };
+
+    const auto& operator[](size_t idx) const { return vertices[idx]; }
+
+    auto& operator[](size_t idx) { return vertices[idx]; }
+
+    cgmath::Vec<T, 2> ClosestPoint() const {
+        return weighted([](const Vertex& v) { return v.p; });
+    }
+
+    /**
+     * @brief closest points on shape1 and shape2
+     */
+    std::pair<cgmath::Vec<T, 2>, cgmath::Vec<T, 2>> WitnessPoints() const {
+        return {weighted([](const Vertex& v) { return v.a; }),
+                weighted([](const Vertex& v) { return v.b; })};
+    }
+
+    std::array<Vertex, 3> vertices;
+    int count = 0;
+    T divisor = 1;
+
+private:
+    template <typename F>
+    cgmath::Vec<T, 2> weighted(F f) const {
+        cgmath::Vec<T, 2> result;
+        for (int i = 0; i < count; i++) {
+            result += f(vertices[i]) * vertices[i].u;
+        }
+        return result / divisor;
+    }
+};
+
+template <typename T>
+struct GjkClosestPoints final {
+    cgmath::Vec<T, 2> pt1;  // on shape1
+    cgmath::Vec<T, 2> pt2;  // on shape2
+    T distance;
+};
+
+namespace internal {
+
+/**
+ * @tparam Witness keep support points of both shapes, intersection test
+ * doesn't need them and skips the copies
+ */
+template <bool Witness = true, typename T, typename Shape1, typename Shape2>
+typename GjkSimplex<T>::Vertex gjkSupport(const Shape1& shape1,
+                                          const Shape2& shape2,
+                                          const cgmath::Vec<T, 2>& dir) {
+    typename GjkSimplex<T>::Vertex v;
+    if constexpr (Witness) {
+        v.a = SupportPoint(shape1, dir);
+        v.b = SupportPoint(shape2, -dir);
+        v.p = v.a - v.b;
+    } else {
+        v.p = SupportPoint(shape1, dir) - SupportPoint(shape2, -dir);
+    }
+    v.u = 1;
+    return v;
+}
+
+/**
+ * @brief run GJK distance until simplex contains origin or converged
+ * @tparam Intersect intersection test only: quit when a separating axis is
+ * found(simplex is not the closest one then) and don't keep witness points
+ * @return true if shapes are intersected(distance <= tol)
+ */
+template <bool Intersect, typename T, typename Shape1, typename Shape2>
+bool gjkRun(const Shape1& shape1, const Shape2& shape2, GjkSimplex<T>& simplex,
+            T tol) {
+    // curved shapes may never reach exact support point, iterate limited
+    constexpr int MaxIteration = 32;
+
+    simplex[0] =
+        gjkSupport<!Intersect>(shape1, shape2, cgmath::Vec<T, 2>{1, 0});
+    simplex.count = 1;
+    simplex.divisor = 1;
+
+    for (int i = 0; i < MaxIteration; i++) {
+        if (simplex.count == 2) {
+            gjkSolve2(simplex, cgmath::Vec<T, 2>{0, 0});
+        } else if (simplex.count == 3) {
+            gjkSolve3(simplex, cgmath::Vec<T, 2>{0, 0});
+        }
+
+        if (simplex.count == 3) {
+            return true;
+        }
+
+        auto closest =
+            simplex.count == 1 ? simplex[0].p : simplex.ClosestPoint();
+        auto distSqrd = closest.LengthSqrd();
+        if (distSqrd <= tol * tol) {
+            return true;
+        }
+
+        auto dir = -closest;
+        auto vertex = gjkSupport<!Intersect>(shape1, shape2, dir);
+        if (Intersect && vertex.p.Dot(dir) < 0) {
+            return false;
+        }
+
+        // no more progress toward origin
+        if ((vertex.p - closest).Dot(dir) <= tol * std::sqrt(distSqrd)) {
+            return false;
+        }
+
+        bool duplicate = false;
+        for (int j = 0; j < simplex.count; j++) {
+            if (simplex[j].p == vertex.p) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) {
+            return false;
+        }
+
+        simplex[simplex.count++] = vertex;
+    }
+
+    return false;
+}
+
+}  // namespace internal
+
+/**
+ * @brief GJK intersection test on any shapes which have `SupportPoint()`
+ *
+ * @param outputSimplex the final simplex, can be passed to `EPA()`. Witness
+ * points are not kept in it
+ * @see GjkClosestPt
+ * @see EPA
+ */
+template <typename Shape1, typename Shape2,
+          typename T = typename SupportShapeTraits<Shape1>::value_type>
+bool GjkIntersect(const Shape1& shape1, const Shape2& shape2,
+                  GjkSimplex<T>* outputSimplex = nullptr, T tol = 0.0001) {
+    GjkSimplex<T> simplex;
+    bool result = internal::gjkRun<true>(shape1, shape2, simplex, tol);
+    if (outputSimplex) {
+        *outputSimplex = simplex;
+    }
+    return result;
+}
+
+/**
+ * @brief closest points between two separated shapes
+ * @return std::nullopt if shapes are intersected
+ */
+template <typename Shape1, typename Shape2,
+          typename T = typename SupportShapeTraits<Shape1>::value_type>
+std::optional<GjkClosestPoints<T>> GjkClosestPt(const Shape1& shape1,
+                                                const Shape2& shape2,
+                                                T tol = 0.0001) {
+    GjkSimplex<T> simplex;
+    if (internal::gjkRun<false>(shape1, shape2, simplex, tol)) {
+        return std::nullopt;
+    }
+
+    auto [pt1, pt2] = simplex.WitnessPoints();
+    return GjkClosestPoints<T>{pt1, pt2, (pt1 - pt2).Length()};
+}
+
+/**
+ * @brief EPA on any shapes which have `SupportPoint()`, polytope is kept in
+ * a fixed size array
+ *
+ * @param simplex simplex from `GjkIntersect()` which returns true
+ * @return MTV, moving shape2 along `v` by `len` separates shapes.
+ * std::nullopt if simplex can't be expanded(e.g. shapes have no area)
+ */
+template <typename Shape1, typename Shape2,
+          typename T = typename SupportShapeTraits<Shape1>::value_type>
+std::optional<MTV<T, 2>> EPA(const GjkSimplex<T>& simplex,
+                             const Shape1& shape1, const Shape2& shape2,
+                             T tol = 0.0001) {
+    constexpr size_t MaxVertex = 32;
+    using Vec = cgmath::Vec<T, 2>;
+
+    auto support = [&](const Vec& dir) {
+        return internal::gjkSupport<false>(shape1, shape2, dir).p;
+    };
+
+    std::array<Vec, MaxVertex> polytope;
+    size_t count = simplex.count;
+    for (size_t i = 0; i < count; i++) {
+        polytope[i] = simplex[i].p;
+    }
+
+    // GJK stopped with touching shapes, blow simplex up to a triangle
+    if (count == 1) {
+        polytope[1] = support(-polytope[0]);
+        if (polytope[1] == polytope[0]) {
+            polytope[1] = support(Vec{1, 0});
+        }
+        count = 2;
+    }
+    if (count == 2) {
+        auto edge = polytope[1] - polytope[0];
+        auto pt = support(Vec{-edge.y, edge.x});
+        if (std::abs(edge.Cross(pt - polytope[0])) <= tol) {
+            pt = support(Vec{edge.y, -edge.x});
+        }
+        polytope[2] = pt;
+        count = 3;
+    }
+
+    // keep polytope counter-clockwise, so outward normal of edge(a, b) is
+    // (b - a) rotated clockwise
+    auto area = (polytope[1] - polytope[0]).Cross(polytope[2] - polytope[0]);
+    if (area == 0) {
+        return std::nullopt;
+    }
+    if (area < 0) {
+        std::swap(polytope[1], polytope[2]);
+    }
+
+    MTV<T, 2> mtv;
+    while (true) {
+        size_t closestEdge = 0;
+        mtv.len = std::numeric_limits<T>::max();
+        for (size_t i = 0; i < count; i++) {
+            auto& a = polytope[i];
+            auto& b = polytope[(i + 1) % count];
+            auto edge = b - a;
+            auto normal = Vec{edge.y, -edge.x};
+            auto len = normal.Length();
+            if (len == 0) {
+                continue;
+            }
+            normal /= len;
+            auto dist = normal.Dot(a);
+            if (dist < mtv.len) {
+                mtv.len = dist;
+                mtv.v = normal;
+                closestEdge = i;
+            }
+        }
+
+        auto pt = support(mtv.v);
+        if (pt.Dot(mtv.v) - mtv.len <= tol || count == MaxVertex) {
+            mtv.len = std::max<T>(mtv.len, 0);
+            return mtv;
+        }
+
+        for (size_t i = count; i > closestEdge + 1; i--) {
+            polytope[i] = polytope[i - 1];
+        }
+        polytope[closestEdge + 1] = pt;
+        count++;
+    }
+}
+
 template <typename T>
 struct Barycentric final {
     Barycentric() = default;
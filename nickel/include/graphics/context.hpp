@@ -3,10 +3,11 @@
 #include "common/cgmath.hpp"
 #include "common/log_tag.hpp"
 #include "graphics/material.hpp"
+#include "graphics/sprite_queue.hpp"
 #include "graphics/texture.hpp"
+#include "graphics/texture_upload.hpp"
 #include "graphics/vertex.hpp"
 #include "video/event.hpp"
-#include <stack>
 
 namespace nickel {
 
@@ -28,15 +29,32 @@ struct Mesh2D final {
 };
 
 struct Render2DContext {
+    // rects drawn in one call, longer batches are split
+    static constexpr uint32_t MaxRectPerDraw = 16384;
+
+    /**
+     * @brief continuous sprites sharing one material, drawn in one call
+     */
+    struct SpriteBatch final {
+        const Material2D* material;
+        uint32_t firstRect;
+        uint32_t rectCount;
+    };
+
     rhi::RenderPipeline pipeline;
     rhi::PipelineLayout pipelineLayout;
     rhi::BindGroupLayout bindGroupLayout;
     rhi::ShaderModule vertexShader;
     rhi::ShaderModule fragmentShader;
     rhi::BindGroup defaultBindGroup;    // bind a white texture
-    rhi::Buffer vertexBuffer;           // for 2D texture vertices
     rhi::Buffer indexBuffer;            // for 2D texture vertices
 
+    SpriteRenderQueue spriteQueue;
+
+    // reused every frame
+    std::vector<SpriteBatch> spriteBatches;
+    std::vector<Vertex2D> spriteVertices;
+
     Render2DContext(rhi::Adapter, rhi::Device,
                     const cgmath::Rect& viewport, RenderContext&);
     ~Render2DContext();
@@ -48,16 +66,9 @@ struct Render2DContext {
 
     void RecreatePipeline(rhi::APIPreference api, RenderContext& ctx);
 
-    uint32_t GenVertexSlot();
-    void ReuseVertexSlot(uint32_t);
-
 private:
-    static constexpr size_t MaxRectCount = 1024;
-    static constexpr size_t VertexBufferSize = sizeof(Vertex2D) * MaxRectCount * 4;
-
     rhi::Device device_;
     std::unordered_map<uint32_t, rhi::Sampler> samplers_;
-    std::stack<uint32_t> usableVertexSlots_;
 
     rhi::PipelineLayout createPipelineLayout();
     void initPipelineShader(rhi::APIPreference);
@@ -67,7 +78,6 @@ private:
     void initSamplers();
     rhi::BindGroup createDefaultBindGroup();
     void initBuffers();
-    void initUsableVertexSlots();
 };
 
 struct Render3DContext {
@@ -106,9 +116,14 @@ struct RenderContext final {
 
     std::unique_ptr<Render2DContext> ctx2D;
     std::unique_ptr<Render3DContext> ctx3D;
+    std::unique_ptr<TextureUploadQueue> textureUploadQueue;
+
+    // one slot per frame in flight, bound with dynamic offset `mvpOffset`
+    static constexpr uint64_t MVPSlotSize = 256;
 
     // common resources
     rhi::Buffer mvpBuffer;
+    uint32_t mvpOffset = 0;  // current frame's slot in mvpBuffer
     rhi::Buffer cameraBuffer;
     rhi::Texture depthTexture;
     rhi::TextureView depthTextureView;
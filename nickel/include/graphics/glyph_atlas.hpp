@@ -0,0 +1,110 @@
+#pragma once
+
+#include "graphics/font.hpp"
+#include "graphics/rhi/transient.hpp"
+
+namespace nickel {
+
+/**
+ * @brief rasterized glyphs of all fonts/pt sizes packed into a few textures
+ *
+ * pages are created once, new glyphs are packed into shelves and uploaded by
+ * `Upload()`. When all pages are full the least recently used page is
+ * cleared and reused
+ */
+class GlyphAtlas final {
+public:
+    static constexpr uint32_t PageSize = 1024;
+    static constexpr uint32_t PageCount = 2;
+
+    struct Glyph final {
+        cgmath::Vec2 size;
+        cgmath::Vec2 bearing;
+        float advance = 0;     // in pixel
+        TextureHandle page;    // null when glyph has no pixel(e.g. space)
+        cgmath::Vec2 uv0, uv1;
+    };
+
+    explicit GlyphAtlas(rhi::Device);
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+    ~GlyphAtlas();
+
+    /**
+     * @brief find glyph, rasterize and pack it when not exists
+     * @return nullptr if font is invalid or no page can be evicted
+     * @note returned glyph is valid until next `Find()`
+     */
+    const Glyph* Find(const Font&, FontHandle, int size, uint32_t code);
+
+    /**
+     * @brief mark a new frame, pages used in current frame are never evicted
+     */
+    void BeginFrame() { frame_++; }
+
+    /**
+     * @brief record copies of new glyphs' pixels into encoder
+     */
+    void Upload(rhi::CommandEncoder&, rhi::TransientAllocator& staging);
+
+    TextureHandle GetPage(uint32_t idx) const { return pages_[idx].handle; }
+
+    rhi::TextureView GetPageView(uint32_t idx) const {
+        return pages_[idx].texture->View();
+    }
+
+private:
+    struct Shelf final {
+        uint32_t y;
+        uint32_t height;
+        uint32_t x;
+    };
+
+    struct Page final {
+        std::unique_ptr<Texture> texture;
+        TextureHandle handle;
+        std::vector<uint32_t> pixels;  // RGBA8 copy of texture
+        std::vector<Shelf> shelves;
+        uint32_t shelfBottom = 0;
+        uint64_t lastUsedFrame = 0;
+
+        // dirty rows waiting for upload, [dirtyBegin, dirtyEnd)
+        uint32_t dirtyBegin = PageSize;
+        uint32_t dirtyEnd = 0;
+    };
+
+    struct Slot final {
+        Glyph glyph;
+        uint32_t page;
+    };
+
+    struct GlyphKey final {
+        FontHandle font;
+        int size;
+        uint32_t code;
+
+        bool operator==(const GlyphKey& o) const {
+            return font == o.font && size == o.size && code == o.code;
+        }
+
+        struct Hash final {
+            size_t operator()(const GlyphKey& key) const {
+                // mix every field fully, ids of fonts may be far apart
+                uint64_t hash = FontHandle::Hash{}(key.font);
+                hash = hash * 0x9E3779B97F4A7C15ull +
+                       static_cast<uint32_t>(key.size);
+                hash = hash * 0x9E3779B97F4A7C15ull + key.code;
+                return static_cast<size_t>(hash ^ (hash >> 32));
+            }
+        };
+    };
+
+    std::array<Page, PageCount> pages_;
+    std::unordered_map<GlyphKey, Slot, GlyphKey::Hash> glyphs_;
+    uint64_t frame_ = 1;
+
+    bool pack(Page&, uint32_t w, uint32_t h, uint32_t& x, uint32_t& y);
+    void clearPage(uint32_t idx);
+};
+
+}  // namespace nickel
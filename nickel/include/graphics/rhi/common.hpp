@@ -5,6 +5,12 @@
 
 namespace nickel::rhi {
 
+/**
+ * @brief frames CPU may record ahead of GPU, per-frame resources are
+ * duplicated this many times
+ */
+constexpr uint32_t MaxFramesInFlight = 3;
+
 enum class APIPreference {
     Undefine,
     Null,
@@ -231,6 +237,30 @@ struct Offset3D {
     uint32_t x{}, y{}, z{};
 };
 
+/**
+ * @brief device memory usage, all sizes in bytes
+ */
+struct MemoryStatistics final {
+    uint32_t blockCount = 0;       // device memory objects owned by pools
+    uint32_t dedicatedCount = 0;   // device memory objects for one resource
+    uint32_t allocationCount = 0;  // resources placed in pool blocks
+    uint64_t blockBytes = 0;
+    uint64_t usedBytes = 0;  // used bytes in pool blocks
+    uint64_t dedicatedBytes = 0;
+    uint64_t peakBytes = 0;  // max of blockBytes + dedicatedBytes
+    uint64_t largestFreeRange = 0;
+    uint32_t freeRangeCount = 0;
+
+    /**
+     * @brief 0 when all free space is continuous, near 1 when badly split
+     */
+    float Fragmentation() const {
+        uint64_t free = blockBytes - usedBytes;
+        return free == 0 ? 0
+                         : 1.0f - static_cast<float>(largestFreeRange) / free;
+    }
+};
+
 enum class TextureAspect {
     Unknown = 0x00,
     ColorOnly = 0x01,
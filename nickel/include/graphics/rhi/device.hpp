@@ -5,6 +5,7 @@
 #include "graphics/rhi/render_pipeline.hpp"
 #include "graphics/rhi/renderpass.hpp"
 #include "graphics/rhi/texture.hpp"
+#include "graphics/rhi/transient.hpp"
 namespace nickel::rhi {
 
 class DeviceImpl;
@@ -42,6 +43,12 @@ public:
     void EndFrame();
     void WaitIdle();
     Queue GetQueue();
+    MemoryStatistics GetMemoryStatistics() const;
+
+    /**
+     * @brief per-frame memory for vertices/indices/uniforms/staging
+     */
+    TransientAllocator& GetTransientAllocator();
 
     void Destroy();
 
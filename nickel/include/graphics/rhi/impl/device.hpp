@@ -5,6 +5,7 @@
 #include "graphics/rhi/render_pipeline.hpp"
 #include "graphics/rhi/renderpass.hpp"
 #include "graphics/rhi/texture.hpp"
+#include "graphics/rhi/transient.hpp"
 namespace nickel::rhi {
 
 class DeviceImpl {
@@ -30,7 +31,12 @@ public:
     virtual void OnWindowResize(int x, int y) = 0;
     virtual void WaitIdle() = 0;
 
+    virtual MemoryStatistics GetMemoryStatistics() const { return {}; }
+
     virtual ~DeviceImpl() = default;
+
+    // created at first use, see `Device::GetTransientAllocator()`
+    std::unique_ptr<TransientAllocator> transientAllocator;
 };
 
 }  // namespace nickel::rhi
\ No newline at end of file
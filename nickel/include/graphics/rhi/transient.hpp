@@ -0,0 +1,83 @@
+#pragma once
+
+#include "common/range_allocator.hpp"
+#include "graphics/rhi/buffer.hpp"
+#include <vector>
+
+namespace nickel::rhi {
+
+class DeviceImpl;
+
+/**
+ * @brief memory for data rewritten every frame(vertices, indices, uniforms,
+ * staging pixels)
+ *
+ * one persistent mapped buffer is split into `MaxFramesInFlight` regions,
+ * each frame bump allocates in its own region so CPU never overwrites data
+ * GPU is still reading. When a region is full the buffer is replaced by a
+ * larger one, the old buffer is destroyed after all frames using it finished
+ * @note WebGL can't bind one buffer as both vertex and index buffer, keep
+ * index data in static buffers there
+ */
+class TransientAllocator final {
+public:
+    // satisfies uniform offset alignment of all backends
+    static constexpr uint64_t Alignment = 256;
+
+    struct Allocation final {
+        Buffer buffer;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        void* ptr = nullptr;
+    };
+
+    TransientAllocator(DeviceImpl&, uint64_t regionSize);
+    TransientAllocator(const TransientAllocator&) = delete;
+    TransientAllocator& operator=(const TransientAllocator&) = delete;
+    ~TransientAllocator();
+
+    /**
+     * @brief switch to next region, called by `Device::BeginFrame()` after
+     * GPU finished the frame which used it last time
+     */
+    void BeginFrame();
+
+    /**
+     * @brief allocate memory valid until end of current frame
+     * @note call `Flush()` after writing
+     */
+    Allocation Allocate(uint64_t size);
+
+    /**
+     * @brief make CPU writes visible to GPU, no-op on coherent memory
+     */
+    void Flush(const Allocation&);
+
+    uint32_t FrameIndex() const { return frameIndex_; }
+
+    uint64_t RegionSize() const { return regionSize_; }
+
+    /**
+     * @brief max bytes allocated in one frame, for tuning initial size
+     */
+    uint64_t PeakUsedSize() const { return peak_; }
+
+private:
+    struct Garbage final {
+        Buffer buffer;
+        uint64_t retireFrame;
+    };
+
+    DeviceImpl& device_;
+    Buffer buffer_;
+    uint64_t regionSize_ = 0;
+    std::vector<LinearAllocator> regions_;
+    std::vector<Garbage> garbage_;
+    uint32_t frameIndex_ = 0;
+    uint64_t frame_ = 0;
+    uint64_t peak_ = 0;
+
+    void createBuffer(uint64_t regionSize);
+};
+
+}  // namespace nickel::rhi
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graphics/rhi/impl/buffer.hpp"
+#include "graphics/rhi/vk/memory.hpp"
 #include "graphics/rhi/vk/pch.hpp"
 #include "graphics/rhi/vk/util.hpp"
 
@@ -26,12 +27,13 @@ public:
     bool IsMappingCoherence() const override;
 
     vk::Buffer buffer;
-    vk::DeviceMemory mem;
+    MemoryAllocation mem;
 
 private:
     uint64_t size_{};
     enum Buffer::MapState mapState_ = Buffer::MapState::Unmapped;
     vk::Device device_;
+    MemoryAllocator& allocator_;
     void* map_{};
     uint64_t mappedOffset_{};
     uint64_t mappedSize_{};
@@ -40,8 +42,7 @@ private:
     vk::MemoryPropertyFlags getMemoryProperty(vk::PhysicalDevice phyDevice, const Buffer::Descriptor&);
     void createBuffer(uint64_t size, vk::BufferUsageFlags usage,
                       const std::vector<uint32_t>& indices, bool hostVisible);
-    void allocateMem(vk::PhysicalDevice phyDevice,
-                     vk::MemoryPropertyFlags flags);
+    void allocateMem(vk::MemoryPropertyFlags flags);
 };
 
 }  // namespace nickel::rhi::vulkan
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "graphics/rhi/vk/adapter.hpp"
 #include "graphics/rhi/vk/command.hpp"
 #include "graphics/rhi/vk/framebuffer.hpp"
+#include "graphics/rhi/vk/memory.hpp"
 #include "graphics/rhi/vk/pch.hpp"
 #include "graphics/rhi/vk/renderpass.hpp"
 #include "graphics/rhi/vk/swapchain.hpp"
@@ -57,12 +58,14 @@ public:
     void WaitIdle() override;
 
     Queue GetQueue() override;
+    MemoryStatistics GetMemoryStatistics() const override;
 
     vk::CommandBuffer RequireCmdBuf();
     void ResetCmdBuf(vk::CommandBuffer cmdBuf);
 
     AdapterImpl& adapter;
     vk::Device device;
+    std::unique_ptr<MemoryAllocator> memoryAllocator;
     vk::CommandPool cmdPool;
     QueueFamilyIndices queueIndices;
     Swapchain swapchain;
@@ -73,6 +76,7 @@ public:
 
     uint32_t curFrame = 0;
     std::vector<vk::Fence> fences;
+    std::vector<uint8_t> fenceSubmitted;  // fence will signal, can be waited
     std::vector<vk::Semaphore> imageAvaliableSems;
     std::vector<vk::Semaphore> renderFinishSems;
 
@@ -81,6 +85,8 @@ public:
 
     std::vector<vk::CommandBuffer> cmdBufs;
     std::vector<vk::CommandBuffer> cmdBufInVacant;
+    // returned in frame, reusable after the frame's fence signaled
+    std::vector<std::vector<vk::CommandBuffer>> cmdBufInFlight;
 
 private:
     void createDevice(vk::Instance, vk::PhysicalDevice, vk::SurfaceKHR);
@@ -89,6 +95,7 @@ private:
         const std::vector<vk::QueueFamilyProperties>& props);
     void createCmdPool();
     void createSyncObject();
+    void recycleCmdBufs(uint32_t frame);
 };
 
 }  // namespace nickel::rhi::vulkan
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "common/range_allocator.hpp"
+#include "graphics/rhi/common.hpp"
 #include "graphics/rhi/vk/pch.hpp"
 
 namespace nickel::rhi::vulkan {
@@ -16,4 +18,79 @@ inline std::optional<uint32_t> FindMemoryType(vk::PhysicalDevice device,
     return {};
 }
 
-}
\ No newline at end of file
+struct MemoryBlock;
+
+/**
+ * @brief a range of device memory given by `MemoryAllocator`
+ */
+struct MemoryAllocation final {
+    vk::DeviceMemory memory;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    void* mapped = nullptr;  // points to `offset`, null if not host visible
+    uint32_t memoryType = 0;
+    MemoryBlock* block = nullptr;  // null if memory is dedicated
+
+    explicit operator bool() const { return static_cast<bool>(memory); }
+};
+
+/**
+ * @brief sub-allocate buffers and images from big device memory blocks
+ *
+ * each memory type has two pools, one for buffers and one for images, so
+ * linear and optimal resources never share a page(bufferImageGranularity).
+ * Host visible blocks are mapped persistently. Resources larger than half a
+ * block get their own dedicated memory
+ */
+class MemoryAllocator final {
+public:
+    enum class ResourceType {
+        Buffer = 0,
+        Image,
+    };
+
+    MemoryAllocator(vk::PhysicalDevice, vk::Device);
+    MemoryAllocator(const MemoryAllocator&) = delete;
+    MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+    ~MemoryAllocator();
+
+    /**
+     * @return invalid allocation when no memory type matches or out of memory
+     */
+    MemoryAllocation Allocate(const vk::MemoryRequirements&,
+                              vk::MemoryPropertyFlags, ResourceType);
+    void Free(const MemoryAllocation&);
+
+    bool IsCoherent(uint32_t memoryType) const;
+
+    /**
+     * @brief make a flush range of allocation legal for non-coherent memory
+     * @param offset relative to allocation
+     */
+    vk::MappedMemoryRange GetFlushRange(const MemoryAllocation&,
+                                        uint64_t offset, uint64_t size) const;
+
+    MemoryStatistics GetStatistics() const;
+
+private:
+    struct Pool final {
+        std::vector<std::unique_ptr<MemoryBlock>> blocks;
+    };
+
+    vk::Device device_;
+    vk::PhysicalDeviceMemoryProperties props_;
+    uint64_t nonCoherentAtomSize_;
+    std::vector<Pool> pools_;  // memoryType * 2 + ResourceType
+    uint32_t dedicatedCount_ = 0;
+    uint64_t dedicatedBytes_ = 0;
+    uint64_t blockBytes_ = 0;
+    uint64_t peakBytes_ = 0;
+
+    uint64_t blockSize(uint32_t memoryType) const;
+    std::unique_ptr<MemoryBlock> createBlock(uint32_t pool, uint64_t size);
+    void destroyBlock(MemoryBlock&);
+    void* mapIfHostVisible(vk::DeviceMemory, uint32_t memoryType);
+    void updatePeak();
+};
+
+}  // namespace nickel::rhi::vulkan
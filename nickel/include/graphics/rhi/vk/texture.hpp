@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graphics/rhi/impl/texture.hpp"
+#include "graphics/rhi/vk/memory.hpp"
 #include "graphics/rhi/vk/pch.hpp"
 #include "graphics/rhi/vk/util.hpp"
 #include "graphics/rhi/adapter.hpp"
@@ -14,14 +15,14 @@ class TextureImpl : public rhi::TextureImpl {
 public:
     TextureImpl(AdapterImpl&, DeviceImpl&, const Texture::Descriptor& desc,
                 const std::vector<uint32_t>& queueIndices);
-    TextureImpl(DeviceImpl&, vk::Image, vk::DeviceMemory, const Texture::Descriptor& desc);
+    TextureImpl(DeviceImpl&, vk::Image, const Texture::Descriptor& desc);
     ~TextureImpl();
 
     TextureView CreateView(const TextureView::Descriptor&) override;
 
     vk::Image GetImage() const;
 
-    vk::DeviceMemory mem;
+    MemoryAllocation mem;  // empty for swapchain images
     vk::Image image;
     std::vector<vk::ImageLayout>
         layouts;  // if image is array, they layout will store separatly
@@ -31,7 +32,7 @@ private:
 
     void createImage(const Texture::Descriptor& desc,
                      const std::vector<uint32_t>& queueIndices);
-    void allocMem(vk::PhysicalDevice phyDevice, enum TextureFormat, const Extent3D&);
+    void allocMem();
 };
 
 }  // namespace nickel::rhi::vulkan
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "common/ecs.hpp"
+#include "common/transform.hpp"
+#include "graphics/material.hpp"
+
+namespace nickel {
+
+struct Sprite;
+
+/**
+ * @brief keep sprites sorted by render state between frames
+ *
+ * sprites are ordered by layer first, then by material and texture inside one
+ * layer, so continuous sprites can share one bind group. Order is only
+ * re-computed when some key changed or sprites were added/removed
+ */
+class SpriteRenderQueue final {
+public:
+    /**
+     * @brief ordered by layer, then by material and texture
+     */
+    struct Key final {
+        uint32_t layer = 0;  // sign flipped, negative layers come first
+        uint64_t state = 0;  // full material id in high 32 bits, texture id
+                             // in low 32 bits
+
+        bool operator==(const Key& o) const {
+            return layer == o.layer && state == o.state;
+        }
+
+        bool operator!=(const Key& o) const { return !(*this == o); }
+
+        bool operator<(const Key& o) const {
+            return layer < o.layer || (layer == o.layer && state < o.state);
+        }
+    };
+
+    struct Entry final {
+        Key key;
+        gecs::entity entity;
+
+        // only valid in the frame it was pushed
+        const Transform* transform;
+        const Sprite* sprite;
+        const Material2D* material;
+        const Texture* texture;
+
+        uint32_t frame;
+    };
+
+    static Key MakeKey(int orderInLayer, Material2DHandle, TextureHandle);
+
+    /**
+     * @brief start collecting sprites of a new frame
+     */
+    void BeginFrame();
+
+    /**
+     * @brief update sprite of this frame, mark queue dirty if key changed
+     */
+    void Push(gecs::entity, Key, const Transform&, const Sprite&,
+              const Material2D&, const Texture&);
+
+    /**
+     * @brief drop sprites not pushed this frame and re-sort if dirty
+     */
+    void Sort();
+
+    const std::vector<Entry>& Entries() const { return entries_; }
+
+    /**
+     * @brief how many entries changed since last sort, for profiling
+     */
+    uint32_t DirtyCount() const { return dirtyCount_; }
+
+private:
+    std::vector<Entry> entries_;
+    std::unordered_map<gecs::entity, uint32_t> indices_;
+    uint32_t frame_ = 0;
+    uint32_t dirtyCount_ = 0;
+
+    void rebuildIndices();
+};
+
+}  // namespace nickel
@@ -15,6 +15,7 @@
 namespace nickel {
 
 class Texture;
+class TextureUploadQueue;
 
 using TextureHandle = Handle<Texture>;
 
@@ -58,6 +59,12 @@ public:
 
     rhi::TextureView View() const { return view_; }
 
+    /**
+     * @brief whether pixels are uploaded, texture loaded from file is
+     * uploaded asynchronously and can't be sampled before ready
+     */
+    bool IsReady() const;
+
     toml::table Save2Toml() const override;
 
 private:
@@ -65,10 +72,17 @@ private:
     rhi::TextureView view_;
     int w_ = 0;
     int h_ = 0;
+    TextureUploadQueue* uploadQueue_ = nullptr;
+    uint64_t uploadTicket_ = 0;
 
     rhi::Texture createTexture(rhi::Device, void* data, uint32_t w, uint32_t h,
                                rhi::TextureFormat gpuFmt,
                                rhi::Flags<rhi::TextureUsage> usage);
+
+    // create texture from decoded image and queue its upload, take ownership
+    // of pixels
+    void initAsync(rhi::Device, void* pixels, rhi::TextureFormat gpuFmt,
+                   rhi::Flags<rhi::TextureUsage> usage);
 };
 
 template <>
@@ -84,6 +98,24 @@ public:
         rhi::Flags<rhi::TextureUsage> usage =
             rhi::Flags(rhi::TextureUsage::TextureBinding) |
             rhi::TextureUsage::CopyDst);
+
+    /**
+     * @brief load many images, decoding runs in parallel on engine job pool
+     * @return handles in same order as `filenames`, null if load failed
+     */
+    std::vector<TextureHandle> LoadBatch(
+        const std::vector<std::filesystem::path>& filenames,
+        rhi::TextureFormat gpuFmt = rhi::TextureFormat::RGBA8_UNORM,
+        rhi::Flags<rhi::TextureUsage> usage =
+            rhi::Flags(rhi::TextureUsage::TextureBinding) |
+            rhi::TextureUsage::CopyDst);
+
+    /**
+     * @brief load textures from config, images are decoded as one batch
+     */
+    void LoadFromToml(const std::filesystem::path& filename);
+    void LoadFromToml(const toml::table& tbl);
+
     std::tuple<TextureHandle, Texture&> LoadAndGet(
         const std::filesystem::path& filename,
         rhi::TextureFormat gpuFmt = rhi::TextureFormat::RGBA8_UNORM,
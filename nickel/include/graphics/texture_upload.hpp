@@ -0,0 +1,71 @@
+#pragma once
+
+#include "graphics/rhi/rhi.hpp"
+#include <deque>
+
+namespace nickel {
+
+/**
+ * @brief upload texture pixels in batch without stalling GPU
+ *
+ * pixels are kept on CPU until `Flush()`, which packs them into device's
+ * transient memory and records all copies into the frame's command encoder.
+ * They are submitted with the frame, and staging memory is recycled after
+ * the frame finished on GPU
+ */
+class TextureUploadQueue final {
+public:
+    using Ticket = uint64_t;
+    using PixelDeleter = void (*)(void*);
+
+    // upload at most this many bytes per frame to avoid spikes
+    static constexpr uint64_t MaxBytesPerFrame = 64 * 1024 * 1024;
+
+    explicit TextureUploadQueue(rhi::Device);
+    TextureUploadQueue(const TextureUploadQueue&) = delete;
+    TextureUploadQueue& operator=(const TextureUploadQueue&) = delete;
+
+    /**
+     * @brief queue pixels of whole texture(mip 0, layer 0)
+     * @param pixels take ownership, released by `deleter` after uploaded
+     * @return ticket to check whether upload finished
+     */
+    Ticket Enqueue(rhi::Texture, void* pixels, PixelDeleter deleter,
+                   uint32_t w, uint32_t h, uint32_t bytesPerPixel);
+
+    /**
+     * @brief drop pending uploads of texture, call before destroy it
+     */
+    void Cancel(rhi::Texture);
+
+    /**
+     * @brief record pending copies into encoder, call once per frame before
+     * any render pass
+     */
+    void Flush(rhi::CommandEncoder&);
+
+    /**
+     * @brief whether copy was recorded, the texture can be sampled after it
+     * in the same or later submission
+     */
+    bool IsFinished(Ticket ticket) const { return ticket <= finished_; }
+
+    size_t PendingCount() const { return requests_.size(); }
+
+private:
+    struct Request final {
+        Ticket ticket;
+        rhi::Texture texture;
+        std::unique_ptr<void, PixelDeleter> pixels;
+        uint32_t w;
+        uint32_t h;
+        uint64_t size;
+    };
+
+    rhi::Device device_;
+    std::deque<Request> requests_;
+    Ticket next_ = 1;
+    Ticket finished_ = 0;
+};
+
+}  // namespace nickel
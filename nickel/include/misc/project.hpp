@@ -20,6 +20,8 @@ struct ProjectInitInfo final {
     std::filesystem::path projectPath;
     std::filesystem::path startupScene = "./MainScene.scene";
     WindowBuilder::Data windowData = WindowBuilder::Data::Default();
+    // compile all scripts into bytecode caches when project is saved
+    bool precompileScripts = true;
 };
 
 struct ChangeSceneEvent {
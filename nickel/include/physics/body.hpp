@@ -22,18 +22,56 @@ struct Body final {
     Vec2 force;
     Real massInv = 1.0;  // 1.0 / mass
     Real restitution = 0.02; // restitution factor from collision
+    Real friction = 0.2;     // friction factor from collision
+    Vec2 prevPos;  // position before last step, for render interpolation
+    bool sleeping = false;  // sleeping body is skipped by `World::Step()`
+    Real sleepTime = 0;     // how long the body keeps resting
+    // nonzero since falling asleep, same for bodies fell asleep together
+    uint32_t sleepIsland = 0;
+
+    /**
+     * @brief let a sleeping body join simulation again
+     * @note body is waken up automatically when touched by awake body or
+     * has force/velocity set. Bodies fell asleep with it wake up in next
+     * step, too
+     */
+    void WakeUp() {
+        sleeping = false;
+        sleepTime = 0;
+    }
+
+    /**
+     * @brief position between last two steps
+     * @param alpha from `World::GetInterpolationAlpha()`
+     */
+    Vec2 GetInterpolatedPos(Real alpha) const {
+        return prevPos + (pos - prevPos) * alpha;
+    }
+
+    /**
+     * @brief inverse mass used in collision, only dynamic body can be pushed
+     */
+    Real GetCollideMassInv() const {
+        return type == Type::Dynamic ? massInv : 0;
+    }
 
     static Body CreateStatic(const Vec2& pos) {
-        return {Type::Static, pos, {}, {}, {}, 0};
+        Body body{Type::Static, pos, {}, {}, {}, 0};
+        body.prevPos = pos;
+        return body;
     }
 
     static Body CreateDynamic(const Vec2& pos, Real mass = 1.0) {
         Assert(mass != 0, "dynamic body can't set 0 mass");
-        return {Type::Dynamic, pos, {}, {}, {}, static_cast<Real>(1.0 / mass)};
+        Body body{Type::Dynamic, pos, {}, {}, {}, static_cast<Real>(1.0 / mass)};
+        body.prevPos = pos;
+        return body;
     }
 
     static Body CreateKinematic(const Vec2& pos) {
-        return {Type::Dynamic, pos, {}, {}, {}, 0};
+        Body body{Type::Kinematic, pos, {}, {}, {}, 0};
+        body.prevPos = pos;
+        return body;
     }
 };
 
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "geom/geom2d.hpp"
+#include "physics/config.hpp"
+#include "physics/shape.hpp"
+
+namespace nickel {
+
+namespace physics {
+
+using AABB = geom2d::AABB<Real>;
+
+/**
+ * @brief get shape's bounding box in world space
+ * @param pos position of the body which shape attached to
+ */
+AABB GetShapeAABB(const Shape& shape, const Vec2& pos);
+
+/**
+ * @brief a candidate pair from broad phase, indices into the bounds list
+ * @note always keep `first < second`
+ */
+struct BroadPhasePair final {
+    uint32_t first;
+    uint32_t second;
+
+    bool operator<(const BroadPhasePair& o) const {
+        return first < o.first || (first == o.first && second < o.second);
+    }
+
+    bool operator==(const BroadPhasePair& o) const {
+        return first == o.first && second == o.second;
+    }
+};
+
+/**
+ * @brief find potential overlapping pairs by bounding box
+ */
+class BroadPhase {
+public:
+    enum class Type {
+        BruteForce,     // test every pair, O(n^2)
+        SweepAndPrune,  // sort bounds on x axis and sweep
+    };
+
+    explicit BroadPhase(Type type) : type_{type} {}
+
+    virtual ~BroadPhase() = default;
+
+    /**
+     * @brief find all overlapping pairs
+     * @param active whether bound may move, pair of two inactive bounds(e.g.
+     * static and sleeping bodies) is skipped. Empty means all active
+     * @param pairs output pairs(will be cleared), sorted in ascending order so
+     * all broad phase give same result
+     */
+    virtual void FindPairs(const std::vector<AABB>& bounds,
+                           const std::vector<uint8_t>& active,
+                           std::vector<BroadPhasePair>& pairs) = 0;
+
+    void FindPairs(const std::vector<AABB>& bounds,
+                   std::vector<BroadPhasePair>& pairs) {
+        FindPairs(bounds, {}, pairs);
+    }
+
+    Type GetType() const { return type_; }
+
+    static std::unique_ptr<BroadPhase> Create(Type);
+
+private:
+    Type type_;
+};
+
+class BruteForceBroadPhase final : public BroadPhase {
+public:
+    BruteForceBroadPhase() : BroadPhase{Type::BruteForce} {}
+
+    using BroadPhase::FindPairs;
+    void FindPairs(const std::vector<AABB>& bounds,
+                   const std::vector<uint8_t>& active,
+                   std::vector<BroadPhasePair>& pairs) override;
+};
+
+/**
+ * @brief sort and sweep on x axis
+ * @note keep the sorted order between calls, bodies move little between two
+ * steps so insertion sort is nearly O(n)
+ */
+class SweepAndPruneBroadPhase final : public BroadPhase {
+public:
+    SweepAndPruneBroadPhase() : BroadPhase{Type::SweepAndPrune} {}
+
+    using BroadPhase::FindPairs;
+    void FindPairs(const std::vector<AABB>& bounds,
+                   const std::vector<uint8_t>& active,
+                   std::vector<BroadPhasePair>& pairs) override;
+
+private:
+    struct Interval {
+        Real min;
+        Real max;
+        uint32_t idx;
+    };
+
+    std::vector<uint32_t> order_;
+    std::vector<Interval> intervals_;
+};
+
+}  // namespace physics
+
+}  // namespace nickel
@@ -10,6 +10,20 @@ namespace physics {
 using Vec2 = cgmath::Vec<config::PhysicsFloatingType, 2>;
 using Real = config::PhysicsFloatingType;
 
+// allowed penetration depth, avoid jitter when resting
+constexpr Real LinearSlop = 0.5;
+// factor of penetration resolved in one step
+constexpr Real Baumgarte = 0.2;
+// relative velocity under this won't bounce, must be larger than velocity
+// gravity adds in one step or resting bodies keep bouncing
+constexpr Real RestitutionThreshold = 50.0;
+// bounds are fattened by this in broad phase
+constexpr Real AABBMargin = 1.0;
+// body slower than this is treated as resting
+constexpr Real LinearSleepTolerance = 5.0;
+// island resting longer than this (in seconds) falls asleep
+constexpr Real TimeToSleep = 0.5;
+
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "physics/manifold.hpp"
+
+namespace nickel {
+
+namespace physics {
+
+/**
+ * @brief make a key from two body ids, same for (a, b) and (b, a)
+ */
+inline uint64_t MakeBodyPairKey(uint32_t id1, uint32_t id2) {
+    if (id1 > id2) {
+        std::swap(id1, id2);
+    }
+    return (static_cast<uint64_t>(id1) << 32) | id2;
+}
+
+/**
+ * @brief keep accumulated impulses of contacts between steps, used to warm
+ * start the contact solver
+ * @note entries are sorted by key, so restore is a linear merge and won't
+ * allocate in steady state
+ */
+class ContactCache final {
+public:
+    /**
+     * @brief copy impulses of last step into contacts with the same key,
+     * points are matched by feature id
+     * @param contacts must be sorted by key
+     */
+    void Restore(std::vector<Contact>& contacts) const;
+
+    /**
+     * @brief remember impulses of this step, drop pairs no longer touching
+     * @param contacts must be sorted by key
+     */
+    void Store(const std::vector<Contact>& contacts) {
+        Store(contacts, [](uint64_t) { return false; });
+    }
+
+    /**
+     * @brief like `Store()`, but keep cached pairs missing in `contacts` if
+     * `keep(key)` is true, e.g. pairs of sleeping bodies which are not
+     * collided at all
+     */
+    template <typename KeepFn>
+    void Store(const std::vector<Contact>& contacts, KeepFn keep);
+
+    void Clear() { entries_.clear(); }
+
+    size_t Size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        int pointCount;
+        uint32_t ids[Manifold::MaxPointNum];
+        Real normalImpulse[Manifold::MaxPointNum];
+        Real tangentImpulse[Manifold::MaxPointNum];
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<Entry> merged_;
+
+    static void fillEntry(Entry&, const Contact&);
+};
+
+template <typename KeepFn>
+void ContactCache::Store(const std::vector<Contact>& contacts, KeepFn keep) {
+    merged_.clear();
+    auto it = entries_.begin();
+    for (auto& contact : contacts) {
+        for (; it != entries_.end() && it->key <= contact.key; it++) {
+            if (it->key < contact.key && keep(it->key)) {
+                merged_.push_back(*it);
+            }
+        }
+        fillEntry(merged_.emplace_back(), contact);
+    }
+    for (; it != entries_.end(); it++) {
+        if (keep(it->key)) {
+            merged_.push_back(*it);
+        }
+    }
+    entries_.swap(merged_);
+}
+
+}  // namespace physics
+
+}  // namespace nickel
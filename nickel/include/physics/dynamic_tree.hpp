@@ -0,0 +1,173 @@
+#pragma once
+
+#include "common/assert.hpp"
+#include "physics/config.hpp"
+#include "geom/geom2d.hpp"
+
+namespace nickel {
+
+namespace physics {
+
+/**
+ * @brief bounding volume hierarchy of AABBs, balanced by rotation
+ *
+ * leaves keep fattened AABBs, a proxy is reinserted only when it moves out of
+ * its fat AABB, so bodies moving slowly or resting cost nothing. Proxy id
+ * never changes until `DestroyProxy()`
+ */
+class DynamicAABBTree final {
+public:
+    using AABB = geom2d::AABB<Real>;
+
+    static constexpr uint32_t NullNode = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @param margin fat AABB is extended by this on each side
+     */
+    explicit DynamicAABBTree(Real margin = 0) : margin_{margin} {}
+
+    uint32_t CreateProxy(const AABB&, uint32_t userData);
+    void DestroyProxy(uint32_t proxy);
+
+    /**
+     * @param displacement predicted movement, fat AABB is extended along it
+     * @return true if proxy is reinserted(moved out of its fat AABB)
+     */
+    bool MoveProxy(uint32_t proxy, const AABB&,
+                   const Vec2& displacement = {});
+
+    uint32_t GetUserData(uint32_t proxy) const {
+        return nodes_[proxy].userData;
+    }
+
+    AABB GetFatAABB(uint32_t proxy) const {
+        auto& node = nodes_[proxy];
+        return AABB::FromMinMax(node.min, node.max);
+    }
+
+    /**
+     * @brief call `f(proxy)` for each proxy whose fat AABB overlaps `aabb`,
+     * stop when `f` returns false
+     * @note thread safe between queries, won't allocate
+     */
+    template <typename F>
+    void Query(const AABB& aabb, F&& f) const {
+        Vec2 min = aabb.center - aabb.halfLen;
+        Vec2 max = aabb.center + aabb.halfLen;
+        traverse([&](const Node& node) { return overlap(node, min, max); },
+                 [&](uint32_t proxy) { return f(proxy); });
+    }
+
+    /**
+     * @brief call `f(proxy, maxFraction)` for each proxy whose fat AABB is
+     * crossed by segment `from`-`to`. `f` returns the new max fraction to
+     * clip the segment(`maxFraction` itself if nothing hit), 0 to stop
+     * @note thread safe between queries, won't allocate
+     */
+    template <typename F>
+    void Raycast(const Vec2& from, const Vec2& to, F&& f) const {
+        Real maxFraction = 1;
+        auto dir = to - from;
+        Vec2 absDir{std::abs(dir.y), std::abs(dir.x)};
+        Vec2 perp{-dir.y, dir.x};
+
+        traverse(
+            [&](const Node& node) {
+                auto end = from + dir * maxFraction;
+                Vec2 min{std::min(from.x, end.x), std::min(from.y, end.y)};
+                Vec2 max{std::max(from.x, end.x), std::max(from.y, end.y)};
+                if (!overlap(node, min, max)) {
+                    return false;
+                }
+                // separating axis perpendicular to segment
+                auto center = (node.min + node.max) * 0.5f;
+                auto halfLen = (node.max - node.min) * 0.5f;
+                return std::abs(perp.Dot(from - center)) <=
+                       absDir.Dot(halfLen);
+            },
+            [&](uint32_t proxy) {
+                maxFraction = f(proxy, maxFraction);
+                return maxFraction > 0;
+            });
+    }
+
+    size_t ProxyCount() const { return proxyCount_; }
+
+    /**
+     * @brief one past the max proxy id, use it to size arrays keyed by proxy
+     */
+    size_t ProxyCapacity() const { return nodes_.size(); }
+
+    int GetHeight() const {
+        return root_ == NullNode ? 0 : nodes_[root_].height;
+    }
+
+    void Clear();
+
+private:
+    struct Node final {
+        Vec2 min;
+        Vec2 max;
+        uint32_t parent = NullNode;  // next free node when in free list
+        uint32_t child1 = NullNode;
+        uint32_t child2 = NullNode;
+        int height = -1;  // leaf is 0, free node is -1
+        uint32_t userData = 0;
+
+        bool IsLeaf() const { return child1 == NullNode; }
+    };
+
+    // fat AABB is extended by displacement multiplied by this
+    static constexpr Real DisplacementMultiplier = 4;
+    // max stack depth when traverse, tree is balanced so height is small
+    static constexpr int MaxTraverseDepth = 256;
+
+    std::vector<Node> nodes_;
+    uint32_t root_ = NullNode;
+    uint32_t freeList_ = NullNode;
+    size_t proxyCount_ = 0;
+    Real margin_;
+
+    static bool overlap(const Node& node, const Vec2& min, const Vec2& max) {
+        return node.min.x <= max.x && node.max.x >= min.x &&
+               node.min.y <= max.y && node.max.y >= min.y;
+    }
+
+    template <typename Visit, typename Leaf>
+    void traverse(Visit&& visit, Leaf&& leaf) const {
+        if (root_ == NullNode) {
+            return;
+        }
+
+        uint32_t stack[MaxTraverseDepth];
+        int count = 0;
+        stack[count++] = root_;
+        while (count > 0) {
+            auto& node = nodes_[stack[--count]];
+            if (!visit(node)) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                if (!leaf(static_cast<uint32_t>(&node - nodes_.data()))) {
+                    return;
+                }
+            } else {
+                Assert(count + 2 <= MaxTraverseDepth,
+                       "dynamic AABB tree is too deep");
+                stack[count++] = node.child1;
+                stack[count++] = node.child2;
+            }
+        }
+    }
+
+    uint32_t allocateNode();
+    void freeNode(uint32_t);
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+    uint32_t balance(uint32_t node);
+    void refit(uint32_t node);
+};
+
+}  // namespace physics
+
+}  // namespace nickel
@@ -18,49 +18,83 @@ struct Manifold final {
     } type;
 
     Vec2 points[MaxPointNum];
+    // features producing each point, stable between steps, so cached
+    // impulses follow points even if their order changes
+    uint32_t ids[MaxPointNum] = {0};
     int pointCount = 0;
     Vec2 normal;
     Vec2 tangent;
     Real depth; // intersect depth
 };
 
-class Contact {
-public:
-    virtual ~Contact() = default;
-    
-    virtual void Evaluate(const CollideShape& shape1, const CollideShape& shape2, Body*, Body*) = 0;
-
-    auto& GetManifold() const { return manifold_; }
-
-    Body* GetBody1() { return b1_; }
-    Body* GetBody2() { return b2_; }
-
-protected:
-    Manifold manifold_;
-    const CollideShape* shape1_ = nullptr;
-    const CollideShape* shape2_ = nullptr;
-    Body* b1_ = nullptr;
-    Body* b2_ = nullptr;
-
-    void init(const CollideShape& shape1, const CollideShape& shape2, Body* b1, Body* b2) {
-        shape1_ = &shape1;
-        shape2_ = &shape2;
-        b1_ = b1;
-        b2_ = b2;
-    }
-};
+/**
+ * @brief a colliding pair found in one step
+ */
+struct Contact final {
+    uint32_t body1;  // index into world's body list
+    uint32_t body2;
+    uint64_t key;    // body pair key, stable between steps
+    Manifold manifold;
 
-class CirclesContact: public Contact {
-public:
-    void Evaluate(const CollideShape& shape1, const CollideShape& shape2, Body*, Body*) override;
-};
+    // accumulated impulses, carried between steps by `ContactCache`
+    Real normalImpulse[Manifold::MaxPointNum] = {0};
+    Real tangentImpulse[Manifold::MaxPointNum] = {0};
 
-// replace this with CirclePolygonContact
-class CircleAABBContact: public Contact {
-public:
-    void Evaluate(const CollideShape& shape1, const CollideShape& shape2, Body*, Body*) override;
+    // solver data, computed before iteration
+    Real normalMass = 0;
+    Real tangentMass = 0;
+    Real friction = 0;
+    Real bias[Manifold::MaxPointNum] = {0};
 };
 
+// manifold generators, one for each shape pair. Shapes are given in the order
+// of `Shape::Type`, `pos1`/`pos2` are positions of bodies which shapes attached
+// to. Manifold's normal always point from shape2 to shape1
+
+/**
+ * @brief generate manifold between two circles
+ */
+void EvaluateCircles(const Shape& shape1, const Vec2& pos1,
+                     const Shape& shape2, const Vec2& pos2, Manifold&);
+
+void EvaluateCircleOBB(const Shape& shape1, const Vec2& pos1,
+                       const Shape& shape2, const Vec2& pos2, Manifold&);
+
+/**
+ * @note polygon must be convex, clockwise or counter-clockwise
+ */
+void EvaluateCirclePolygon(const Shape& shape1, const Vec2& pos1,
+                           const Shape& shape2, const Vec2& pos2, Manifold&);
+
+void EvaluateCircleCapsule(const Shape& shape1, const Vec2& pos1,
+                           const Shape& shape2, const Vec2& pos2, Manifold&);
+
+/**
+ * @brief generate manifold between two OBBs, clip incident face against
+ * reference face so resting boxes get two points
+ */
+void EvaluateOBBs(const Shape& shape1, const Vec2& pos1, const Shape& shape2,
+                  const Vec2& pos2, Manifold&);
+
+void EvaluateOBBPolygon(const Shape& shape1, const Vec2& pos1,
+                        const Shape& shape2, const Vec2& pos2, Manifold&);
+
+void EvaluateOBBCapsule(const Shape& shape1, const Vec2& pos1,
+                        const Shape& shape2, const Vec2& pos2, Manifold&);
+
+void EvaluatePolygons(const Shape& shape1, const Vec2& pos1,
+                      const Shape& shape2, const Vec2& pos2, Manifold&);
+
+void EvaluatePolygonCapsule(const Shape& shape1, const Vec2& pos1,
+                            const Shape& shape2, const Vec2& pos2, Manifold&);
+
+/**
+ * @brief generate manifold between two capsules, parallel capsules get two
+ * points
+ */
+void EvaluateCapsules(const Shape& shape1, const Vec2& pos1,
+                      const Shape& shape2, const Vec2& pos2, Manifold&);
+
 }  // namespace physics
 
 }  // namespace nickel
\ No newline at end of file
@@ -8,11 +8,18 @@ namespace physics {
 
 class ManifoldSolver final {
 public:
-    std::unique_ptr<Contact> GetContact(const CollideShape&, const CollideShape&, bool = true);
-
-private:
+    /**
+     * @brief generate manifold between two shapes without any allocation
+     * @param pos1 position of body which shape1 attached to
+     * @param pos2 position of body which shape2 attached to
+     * @return false if there is no contact generator for these shapes
+     * @note manifold's normal always point from shape2 to shape1
+     */
+    bool GetContact(const CollideShape& shape1, const Vec2& pos1,
+                    const CollideShape& shape2, const Vec2& pos2,
+                    Manifold& manifold) const;
 };
 
 }
 
-}
\ No newline at end of file
+}
@@ -8,9 +8,20 @@ namespace physics {
 
 class PhysicSolver final {
 public:
-    PhysicSolver(Real maxSpeed = 100): maxSpeed_{maxSpeed} {}
+    PhysicSolver(Real maxSpeed = 2000): maxSpeed_{maxSpeed} {}
 
     void Step(Real interval, Body& body);
+
+    /**
+     * @brief apply force to velocity, first half of `Step()`
+     */
+    void IntegrateVelocity(Real interval, Body& body);
+
+    /**
+     * @brief apply velocity to position and clear force, second half of
+     * `Step()`
+     */
+    void IntegratePosition(Real interval, Body& body);
     Real MaxSpeed() const { return maxSpeed_; }
     void SetMaxSpeed(Real s) { maxSpeed_ = s; }
 
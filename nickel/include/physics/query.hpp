@@ -0,0 +1,45 @@
+#pragma once
+
+#include "physics/config.hpp"
+#include "physics/shape.hpp"
+
+namespace nickel {
+
+namespace physics {
+
+struct RaycastHit final {
+    uint32_t id = 0;  // body id(entity or index), set by `World` queries
+    Vec2 point;
+    Vec2 normal;      // surface normal of the hit shape
+    Real fraction;    // point = from + (to - from) * fraction
+};
+
+struct RaycastInput final {
+    Vec2 from;
+    Vec2 to;
+};
+
+/**
+ * @brief cast segment `from`-`to` on shape
+ * @param pos position of body which shape attached to
+ * @param maxFraction hit farther than this is ignored
+ * @return std::nullopt if missed or `from` is inside the shape
+ */
+std::optional<RaycastHit> RaycastShape(const Shape&, const Vec2& pos,
+                                       const Vec2& from, const Vec2& to,
+                                       Real maxFraction = 1);
+
+/**
+ * @brief sweep `shape` from `from` to `to`(both are body positions), find
+ * when it first touches `target`
+ * @param targetPos position of body which target attached to
+ * @return hit at fraction 0 without normal if shapes overlap at `from`
+ */
+std::optional<RaycastHit> ShapeCast(const Shape& shape, const Vec2& from,
+                                    const Vec2& to, const Shape& target,
+                                    const Vec2& targetPos,
+                                    Real maxFraction = 1);
+
+}  // namespace physics
+
+}  // namespace nickel
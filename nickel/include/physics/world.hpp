@@ -1,13 +1,18 @@
 #pragma once
 
 #include "common/assert.hpp"
+#include "physics/broad_phase.hpp"
+#include "physics/contact_cache.hpp"
+#include "physics/dynamic_tree.hpp"
 #include "physics/manifold_solver.hpp"
 #include "physics/physic_solver.hpp"
+#include "physics/query.hpp"
 #include "physics/circle_shape.hpp"
 #include "physics/capsule_shape.hpp"
 #include "physics/polygon_shape.hpp"
 #include "physics/obb_shape.hpp"
 #include "common/ecs.hpp"
+#include "common/job_pool.hpp"
 
 
 namespace nickel {
@@ -18,18 +23,217 @@ class World final {
 public:
     using ForceGenerator = std::function<void(Body&)>;
 
+    explicit World(
+        BroadPhase::Type broadPhase = BroadPhase::Type::SweepAndPrune);
+
     void Step(Real interval, gecs::querier<gecs::mut<Body>, CollideShape>);
+
+    /**
+     * @brief advance world by real elapsed time in fixed interval steps
+     * @param elapsed real time since last update, in seconds
+     * @return fixed steps done in this update
+     * @note do at most `GetMaxSubSteps()` steps, the rest of time is dropped
+     * so slow frames won't spiral
+     */
+    int Update(Real elapsed,
+               gecs::querier<gecs::mut<Body>, CollideShape> querier);
+
+    /**
+     * @brief step bodies which are not in ECS(tools, benchmark)
+     * @note bodies and shapes are paired by index
+     */
+    void Step(Real interval, std::vector<Body>& bodies,
+              const std::vector<CollideShape>& shapes);
+
     std::vector<ForceGenerator> forceGenerators;
 
+    void SetFixedInterval(Real interval);
+    Real GetFixedInterval() const { return fixedInterval_; }
+
+    void SetMaxSubSteps(int steps);
+    int GetMaxSubSteps() const { return maxSubSteps_; }
+
+    /**
+     * @brief how far real time is between last two steps, in [0, 1]. Use it
+     * with `Body::GetInterpolatedPos()`
+     */
+    Real GetInterpolationAlpha() const {
+        return accumulator_ / fixedInterval_;
+    }
+
     Real MaxSpeed() const { return physicSolver_.MaxSpeed(); }
     void SetMaxSpeed(Real s) { return physicSolver_.SetMaxSpeed(s); }
 
+    /**
+     * @brief change broad phase algorithm, useful when benchmark
+     */
+    void SetBroadPhase(BroadPhase::Type);
+    BroadPhase::Type GetBroadPhaseType() const { return broadPhase_->GetType(); }
+
+    /**
+     * @brief set iteration count of contact solver, more iterations make
+     * stacking more stable
+     */
+    void SetVelocityIterations(int iterations);
+    int GetVelocityIterations() const { return velocityIterations_; }
+
+    /**
+     * @brief reuse contact impulses of last step as initial guess
+     */
+    void EnableWarmStarting(bool enable);
+    bool IsWarmStarting() const { return warmStarting_; }
+
+    /**
+     * @brief let resting islands fall asleep, sleeping bodies cost nothing
+     * until touched
+     */
+    void EnableSleeping(bool enable);
+    bool IsSleepingEnabled() const { return sleepingEnabled_; }
+
+    /**
+     * @brief solve independent islands on `count` extra threads, 0 means
+     * solve all on caller thread
+     * @note result is same whatever the thread count is
+     */
+    void SetWorkerCount(uint32_t count);
+
+    /**
+     * @brief solve islands on a pool shared with other systems instead of
+     * an own one, nullptr goes back to own pool
+     * @note pool must outlive the world or be reset before destroyed
+     */
+    void SetJobPool(JobPool* pool);
+    uint32_t GetWorkerCount() const { return jobPool_->WorkerCount(); }
+
+    /**
+     * @brief awake island count of last step, each island is a group of
+     * dynamic bodies touching each other
+     */
+    size_t GetIslandCount() const { return awakeIslands_.size(); }
+
+    /**
+     * @brief touching pairs whose impulses are kept for warm starting
+     */
+    size_t GetCachedContactCount() const { return contactCache_.Size(); }
+
+    // queries on bodies of last step, served by a dynamic AABB tree which is
+    // updated at the end of each step. Bodies are reported by id(entity, or
+    // index when stepped with vectors)
+
+    static constexpr uint32_t NoBody = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief closest body hit by segment `from`-`to`
+     * @note bodies containing `from` are not hit
+     */
+    std::optional<RaycastHit> Raycast(const Vec2& from, const Vec2& to) const;
+
+    /**
+     * @brief cast many rays, `hits[i]` is the result of `rays[i]`
+     * @note rays are spread on worker threads(see `SetWorkerCount()`), don't
+     * call it while stepping
+     */
+    void Raycast(const std::vector<RaycastInput>& rays,
+                 std::vector<std::optional<RaycastHit>>& hits) const;
+
+    /**
+     * @brief find bodies whose bounding box overlaps `aabb`
+     * @param ids output(will be cleared)
+     */
+    void QueryAABB(const AABB& aabb, std::vector<uint32_t>& ids) const;
+
+    /**
+     * @brief batched `QueryAABB`, in CSR form: bodies overlapping `aabbs[i]`
+     * are `ids[offsets[i], offsets[i + 1])`
+     */
+    void QueryAABB(const std::vector<AABB>& aabbs, std::vector<uint32_t>& ids,
+                   std::vector<uint32_t>& offsets) const;
+
+    /**
+     * @brief sweep shape from body position `from` to `to`, find the first
+     * body it touches
+     * @param ignore body skipped, e.g. the one owning the shape
+     * @note bodies overlapping shape at `from` are hit at fraction 0
+     */
+    std::optional<RaycastHit> ShapeCast(const Shape& shape, const Vec2& from,
+                                        const Vec2& to,
+                                        uint32_t ignore = NoBody) const;
+
 private:
+    struct BodyRef {
+        uint32_t id;  // entity or index, used to key contacts between steps
+        Body* body;
+        const CollideShape* shape;
+    };
+
     PhysicSolver physicSolver_;
     ManifoldSolver manifoldSolver_;
+    std::unique_ptr<BroadPhase> broadPhase_;
+    ContactCache contactCache_;
+    int velocityIterations_ = 8;
+    bool warmStarting_ = true;
+    bool sleepingEnabled_ = true;
+    Real fixedInterval_ = 1.0 / 60.0;
+    int maxSubSteps_ = 4;
+    Real accumulator_ = 0;
+    std::unique_ptr<JobPool> ownPool_;
+    JobPool* jobPool_;  // ownPool_ or a shared pool
+
+    // reused between steps to avoid allocation
+    std::vector<BodyRef> bodies_;
+    std::vector<uint8_t> active_;  // body may move in this step
+    std::vector<uint32_t> wokenIslands_;  // `Body::sleepIsland` to wake
+    std::vector<AABB> bounds_;
+    std::vector<BroadPhasePair> pairs_;
+    std::vector<Contact> contacts_;
+    std::vector<uint32_t> activeIds_;  // sorted
+
+    static constexpr uint32_t NoIsland = std::numeric_limits<uint32_t>::max();
+
+    // islands in CSR form, island i owns
+    // islandBodies_[islandBodyStart_[i], islandBodyStart_[i + 1])
+    std::vector<uint32_t> islandParent_;
+    std::vector<uint32_t> islandOfBody_;
+    std::vector<uint32_t> islandBodyStart_;
+    std::vector<uint32_t> islandBodies_;
+    std::vector<uint32_t> islandContactStart_;
+    std::vector<uint32_t> islandContacts_;
+    std::vector<uint32_t> awakeIslands_;
+
+    // copy of body's shape in spatial index, so queries between steps never
+    // touch components which may be destroyed
+    struct IndexedBody {
+        uint64_t stamp = 0;  // last step this body is seen
+        uint32_t id = 0;
+        Vec2 pos;
+        AABB aabb;
+        const Shape* source = nullptr;  // shape copied from
+        std::variant<std::monostate, CircleShape, OBBShape, PolygonShape,
+                     CapsuleShape>
+            shape;
+
+        const Shape& GetShape() const;
+    };
+
+    DynamicAABBTree index_{AABBMargin};
+    std::unordered_map<uint32_t, uint32_t> proxyOfBody_;
+    std::vector<IndexedBody> indexedBodies_;  // indexed by proxy
+    // proxy of `bodies_[i]` in last step, body order rarely changes between
+    // steps so most bodies skip the hash lookup
+    std::vector<uint32_t> proxyOrder_;
+    uint64_t stepCount_ = 0;
 
-    void collide(Real interval, gecs::querier<gecs::mut<Body>, CollideShape> bodies);
-    void dealContact(const Manifold&, Body& b1, Body& b2, bool = true);
+    void step(Real interval);
+    void updateActive();
+    bool wakeIslands();
+    void collide();
+    void buildIslands();
+    void solveIsland(size_t island, Real interval);
+    void prepareContact(Contact&, Real interval);
+    void warmStartContact(Contact&);
+    void solveContact(Contact&);
+    void storeContacts();
+    void updateIndex();
 };
 
 template <typename T>
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace nickel {
+
+/**
+ * @brief luau compiler options which change generated bytecode
+ * @note bytecode version of linked luau is also hashed
+ */
+struct ScriptCompileOptions final {
+    int optimizationLevel = 1;
+    int debugLevel = 1;
+
+    uint64_t Hash() const;
+};
+
+/**
+ * @brief compiled luau bytecode saved beside script metadata,
+ * `foo.luau` is cached in `foo.luau.bytecode`
+ *
+ * a cache file is used only when both the source hash and compile options
+ * match, otherwise script is compiled again and cache file is overwritten
+ */
+constexpr std::string_view BytecodeCacheExtension = ".bytecode";
+
+std::filesystem::path GetBytecodeCachePath(
+    const std::filesystem::path& script);
+
+uint64_t HashScriptSource(std::string_view source);
+
+/**
+ * @return bytecode, or `std::nullopt` if cache file is missing or stale
+ */
+std::optional<std::string> ReadBytecodeCache(
+    const std::filesystem::path& cacheFile, uint64_t sourceHash,
+    const ScriptCompileOptions&);
+
+/**
+ * @brief write cache into a temporary file and rename it, so a partly
+ * written cache is never read
+ */
+bool WriteBytecodeCache(const std::filesystem::path& cacheFile,
+                        uint64_t sourceHash, const ScriptCompileOptions&,
+                        std::string_view bytecode);
+
+}  // namespace nickel
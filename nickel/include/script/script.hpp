@@ -2,6 +2,7 @@
 
 #include "common/asset.hpp"
 #include "common/manager.hpp"
+#include "script/bytecode_cache.hpp"
 
 struct lua_State;
 
@@ -12,11 +13,17 @@ class ScriptManager;
 
 class LuaScript : public Asset {
 public:
+    friend class ScriptManager;
     friend void ScriptUpdateSystem(gecs::querier<gecs::mut<Script>> scripts,
                         gecs::resource<gecs::mut<ScriptManager>> mgr);
 
     static LuaScript Null;
 
+    /**
+     * @brief options used to compile scripts loaded afterwards
+     */
+    static ScriptCompileOptions CompileOptions;
+
     LuaScript() = default;
     LuaScript(const LuaScript&) = delete;
     LuaScript& operator=(const LuaScript&) = delete;
@@ -31,9 +38,18 @@ public:
         return *this;
     }
 
+    /**
+     * @brief read script and compile it, or take bytecode from its cache
+     * file when source is unchanged. Bytecode is loaded into a VM when first
+     * used
+     */
     explicit LuaScript(const std::filesystem::path& libname);
     ~LuaScript();
 
+    /**
+     * @brief call script functions in its own state
+     * @note only for `ScriptManager::Mode::Isolated`
+     */
     void OnInit(gecs::entity) const;
     void OnUpdate(gecs::entity) const;
     void OnDestroy(gecs::entity) const;
@@ -43,20 +59,34 @@ public:
     toml::table Save2Toml() const override;
 
     operator bool() const {
-        return state_;
+        return !bytecode_.empty();
     }
 
 private:
-    lua_State* state_{};
+    std::string bytecode_;
+    // changed when reloaded, so shared VM knows to load it again
+    uint64_t revision_ = 0;
+    lua_State* state_{};  // own state in isolated mode
     bool isInited_ = false;
+    bool fromCache_ = false;  // bytecode is read from cache file
 
     void load(const std::filesystem::path& path);
+    void createState();
+    /**
+     * @brief load bytecode as a function on top of stack, cached bytecode
+     * rejected by VM is compiled again once
+     * @return false if failed, error message is on top of stack
+     */
+    bool loadChunk(lua_State*);
 
     friend void swap(LuaScript& o1, LuaScript& o2) {
         using std::swap;
 
+        swap(o1.bytecode_, o2.bytecode_);
+        swap(o1.revision_, o2.revision_);
         swap(o1.state_, o2.state_);
         swap(o1.isInited_, o2.isInited_);
+        swap(o1.fromCache_, o2.fromCache_);
     }
 };
 
@@ -67,20 +97,97 @@ std::unique_ptr<LuaScript> LoadAssetFromMetaTable(const toml::table&);
 
 class ScriptManager: public Manager<LuaScript> {
 public:
+    friend void ScriptUpdateSystem(gecs::querier<gecs::mut<Script>> scripts,
+                        gecs::resource<gecs::mut<ScriptManager>> mgr);
+    friend void ScriptShutdownSystem(
+        gecs::querier<Script> scripts,
+        gecs::resource<gecs::mut<ScriptManager>> mgr);
+
+    enum class Mode {
+        // every script has its own lua state, shared by its entities
+        Isolated,
+        // one sandboxed VM, every entity runs script in its own environment
+        Shared,
+    };
+
+    explicit ScriptManager(Mode mode = Mode::Shared);
+    ScriptManager(const ScriptManager&) = delete;
+    ScriptManager& operator=(const ScriptManager&) = delete;
+    ~ScriptManager();
+
     ScriptHandle Load(const std::filesystem::path& path);
 
     auto GetFileType() const { return FileType::Script; }
+
+    Mode GetMode() const { return mode_; }
+
+    /**
+     * @brief compile all scripts under `dir` ahead of time and refresh their
+     * bytecode caches, so loading them later skips compilation
+     * @return number of scripts compiled, up to date caches are not counted
+     */
+    static size_t Precompile(const std::filesystem::path& dir);
+
+    /**
+     * @brief entities running script in shared VM
+     */
+    size_t InstanceCount() const;
+
+private:
+    static constexpr int NoRef = -1;
+
+    // script running on an entity, functions are resolved once when created
+    struct Instance final {
+        gecs::entity entity;
+        int env = NoRef;
+        int onInit = NoRef;
+        int onUpdate = NoRef;
+        int onQuit = NoRef;
+        uint64_t stamp = 0;
+        bool inited = false;
+    };
+
+    // instances of one script, updated together
+    struct Batch final {
+        int chunk = NoRef;
+        uint64_t revision = 0;
+        std::vector<Instance> instances;
+        std::unordered_map<std::underlying_type_t<gecs::entity>, uint32_t>
+            indexOfEntity;
+    };
+
+    Mode mode_;
+    lua_State* vm_ = nullptr;
+    std::unordered_map<ScriptHandle, Batch, ScriptHandle::Hash,
+                       ScriptHandle::Eq>
+        batches_;
+    uint64_t frame_ = 0;
+
+    /**
+     * @brief find or create instance of entity, and mark it alive this frame
+     */
+    void prepareInstance(ScriptHandle, LuaScript&, gecs::entity, Script&);
+    void releaseInstance(Batch&, uint32_t index);
+    void releaseBatch(Batch&);
+    void updateBatches();
+    void call(int ref, gecs::entity, bool passEntity);
 };
 
 class Script final {
 public:
+    static constexpr uint32_t NoInstance =
+        std::numeric_limits<uint32_t>::max();
+
     ScriptHandle handle;
     gecs::entity entity;
+    // cached index of instance in shared VM, validated before used
+    uint32_t instance = NoInstance;
 };
 
 
 void ScriptUpdateSystem(gecs::querier<gecs::mut<Script>> scripts,
                         gecs::resource<gecs::mut<ScriptManager>> mgr);
-void ScriptShutdownSystem(gecs::querier<LuaScript>);
+void ScriptShutdownSystem(gecs::querier<Script> scripts,
+                          gecs::resource<gecs::mut<ScriptManager>> mgr);
 
-}  // namespace nickel
\ No newline at end of file
+}  // namespace nickel
@@ -10,7 +10,8 @@
 
 namespace nickel {
 
-void UpdateCamera2GPU(gecs::resource<Camera>,
+void UpdateCamera2GPU(gecs::resource<gecs::mut<rhi::Device>>,
+                      gecs::resource<Camera>,
                       gecs::resource<gecs::mut<RenderContext>>);
 
 void UpdateGLTFModelTransform(
@@ -18,7 +19,8 @@ void UpdateGLTFModelTransform(
     gecs::resource<gecs::mut<GLTFManager>>);
 
 void BeginRender(gecs::resource<gecs::mut<rhi::Device>>,
-                 gecs::resource<gecs::mut<RenderContext>>);
+                 gecs::resource<gecs::mut<RenderContext>>,
+                 gecs::resource<Window>);
 
 void EndRender(gecs::resource<gecs::mut<rhi::Device>>,
                gecs::resource<gecs::mut<RenderContext>>,
@@ -28,12 +30,13 @@ void RenderSprite2D(
     gecs::resource<gecs::mut<rhi::Device>>,
     gecs::resource<gecs::mut<RenderContext>>, gecs::resource<gecs::mut<Camera>>,
     gecs::resource<TextureManager>, gecs::resource<Material2DManager>,
-    gecs::querier<Transform, gecs::mut<Sprite>, SpriteMaterial>);
+    gecs::querier<Transform, Sprite, SpriteMaterial>);
 
 void RenderGLTFModel(gecs::resource<gecs::mut<RenderContext>>,
                      gecs::resource<gecs::mut<Camera>>,
                      gecs::resource<gecs::mut<rhi::Device>>,
                      gecs::resource<GLTFManager>,
+                     gecs::resource<TextureManager>,
                      gecs::querier<GLTFHandle, Transform>);
 
 void BeginFrame(gecs::resource<gecs::mut<rhi::Device>>);
@@ -2,12 +2,28 @@
 
 #include "physics/world.hpp"
 #include "common/ecs.hpp"
+#include "common/timer.hpp"
+#include "common/transform.hpp"
 
 namespace nickel::physics {
 
-void PhysicsInit(gecs::commands cmds);
+/**
+ * @brief create physics world solving on the engine job pool
+ */
+void PhysicsInit(gecs::commands cmds,
+                 gecs::resource<gecs::mut<JobPool>> jobPool);
 
+/**
+ * @brief step physics world in fixed interval by real frame time
+ */
 void PhysicsUpdate(gecs::resource<gecs::mut<World>> world,
+                   gecs::resource<Time> time,
                    gecs::querier<gecs::mut<Body>, CollideShape> querier);
 
-}
\ No newline at end of file
+/**
+ * @brief write interpolated body position into `Transform` for rendering
+ */
+void PhysicsSyncTransform(gecs::resource<World> world,
+                          gecs::querier<Body, gecs::mut<Transform>> querier);
+
+}
@@ -3,6 +3,7 @@
 #include "graphics/camera.hpp"
 #include "graphics/context.hpp"
 #include "graphics/font.hpp"
+#include "graphics/glyph_atlas.hpp"
 #include "ui/event.hpp"
 
 
@@ -33,7 +34,6 @@ struct RenderUIContext final {
     rhi::BindGroupLayout bindGroupLayout;
     rhi::ShaderModule vertexShader;
     rhi::ShaderModule fragmentShader;
-    rhi::Buffer vertexBuffer;
     rhi::Buffer indexBuffer;
     std::vector<BatchBreakInfo> batchBreakInfos;
     std::unordered_map<TextureHandle, rhi::BindGroup,
@@ -42,17 +42,7 @@ struct RenderUIContext final {
     rhi::BindGroup defaultBindGroup;
     Camera camera;
 
-    struct FontCharSet {
-        uint32_t code;
-        rhi::Texture texture;
-        rhi::TextureView view;
-    };
-
-    using FontCharMap = std::unordered_map<uint32_t, FontCharSet>;
-
-    std::unordered_map<FontHandle, FontCharMap, typename FontHandle::Hash,
-                       typename FontHandle::Eq>
-        fontChars;  // OPTIMIZE: render chars to one Texture when engine init
+    GlyphAtlas glyphAtlas;
 
     std::vector<UIVertex> vertices;
 
@@ -66,7 +56,6 @@ struct RenderUIContext final {
                     const TextureClip&, rhi::RenderPipeline);
 
     rhi::BindGroup FindBindGroup(TextureHandle handle);
-    rhi::TextureView GetFontChar(FontHandle, uint32_t code);
 
     void RecreatePipeline(rhi::APIPreference api);
 
@@ -79,8 +68,9 @@ private:
                                                bool supportSeparateSampler);
     void initPipelines(rhi::APIPreference);
     rhi::Buffer createIndexBuffer();
-    rhi::Buffer createVertexBuffer();
     void initDefaultBindGroup();
+    void initGlyphAtlasBindGroups();
+    rhi::BindGroup createTextureBindGroup(rhi::TextureView);
 };
 
 struct UIContext final {
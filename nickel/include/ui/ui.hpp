@@ -19,6 +19,7 @@ void InitSystem(gecs::commands, gecs::resource<rhi::Adapter>,
 void ShutdownSystem(gecs::commands);
 
 void RenderUI(gecs::querier<Style, gecs::without<Parent>>,
+              gecs::resource<gecs::mut<rhi::Device>>,
               gecs::resource<gecs::mut<UIContext>>,
               gecs::resource<gecs::mut<RenderContext>>,
               gecs::resource<gecs::mut<Camera>>,
@@ -3,43 +3,181 @@
 
 namespace nickel {
 
-void doUpdateGlobalTransform(gecs::entity entity, Transform& trans,
-                             GlobalTransform& globalTrans,
-                             const Child& children, gecs::registry reg) {
-    for (auto ent : children.entities) {
-        if (!(reg.has<Transform>(ent) && reg.has<GlobalTransform>(ent))) {
-            continue;
+static bool isNode(gecs::registry reg, gecs::entity ent) {
+    return reg.alive(ent) && reg.has<Transform>(ent) &&
+           reg.has<GlobalTransform>(ent);
+}
+
+void TransformHierarchy::Update(
+    gecs::querier<GlobalTransform, Transform, gecs::without<Parent>> roots,
+    gecs::registry reg, JobPool* pool) {
+    uint32_t batchCount = static_cast<uint32_t>(batches_.size()) - 1;
+    bool parallel = pool && nodes_.size() >= ParallelNodeCount;
+
+    bool valid = !batches_.empty() && rootsMatch(roots);
+    if (valid) {
+        std::atomic<bool> match{true};
+        auto fn = [&](size_t i) {
+            if (match.load(std::memory_order_relaxed) &&
+                !nodesMatch(batches_[i], batches_[i + 1], reg)) {
+                match.store(false, std::memory_order_relaxed);
+            }
+        };
+        if (parallel) {
+            pool->ParallelFor(batchCount, fn);
+        } else {
+            for (uint32_t i = 0; i < batchCount; i++) {
+                fn(i);
+            }
         }
-        auto& childTrans = reg.get_mut<Transform>(ent);
-        auto& childGlobalTrans = reg.get_mut<GlobalTransform>(ent);
-        childGlobalTrans.mat = globalTrans.mat * childTrans.ToMat();
+        valid = match.load(std::memory_order_relaxed);
+    }
 
-        if (reg.has<Child>(ent)) {
-            doUpdateGlobalTransform(ent, childTrans, childGlobalTrans,
-                                    reg.get<Child>(ent), reg);
+    // cached local transforms are garbage after rebuild, update all nodes
+    bool force = !valid;
+    if (!valid) {
+        rebuild(roots, reg);
+        batchCount = static_cast<uint32_t>(batches_.size()) - 1;
+        parallel = pool && nodes_.size() >= ParallelNodeCount;
+    }
+
+    auto fn = [&](size_t i) {
+        updateBatch(batches_[i], batches_[i + 1], force);
+    };
+    if (parallel) {
+        pool->ParallelFor(batchCount, fn);
+    } else {
+        for (uint32_t i = 0; i < batchCount; i++) {
+            fn(i);
         }
     }
 }
 
-void UpdateGlobalTransform(
-    gecs::querier<gecs::mut<GlobalTransform>, gecs::mut<Transform>, Child,
-                  gecs::without<Parent>>
-        root,
-    gecs::querier<gecs::mut<GlobalTransform>, gecs::mut<Transform>,
-                  gecs::without<Parent>>
-        querier,
+bool TransformHierarchy::rootsMatch(
+    gecs::querier<GlobalTransform, Transform, gecs::without<Parent>>& roots)
+    const {
+    // roots created or destroyed, or component storage grew and moved, are
+    // found here
+    size_t i = 0;
+    for (auto&& [entity, gTrans, trans] : roots) {
+        if (i >= roots_.size()) {
+            return false;
+        }
+        auto& node = nodes_[roots_[i++]];
+        if (node.entity != entity || node.transform != &trans ||
+            node.global != &gTrans) {
+            return false;
+        }
+    }
+    return i == roots_.size();
+}
+
+bool TransformHierarchy::nodesMatch(uint32_t begin, uint32_t end,
+                                    gecs::registry reg) const {
+    for (uint32_t i = begin; i < end; i++) {
+        auto& node = nodes_[i];
+        // swap-and-pop storage may move another entity's component to the
+        // cached address, so compare addresses after entity lookup
+        if (!isNode(reg, node.entity) ||
+            &reg.get<Transform>(node.entity) != node.transform ||
+            &reg.get<GlobalTransform>(node.entity) != node.global) {
+            return false;
+        }
+
+        uint32_t count = 0;
+        if (reg.has<Child>(node.entity)) {
+            for (auto child : reg.get<Child>(node.entity).entities) {
+                if (!isNode(reg, child)) {
+                    continue;
+                }
+                if (count >= node.childCount ||
+                    nodes_[node.firstChild + count].entity != child) {
+                    return false;
+                }
+                count++;
+            }
+        }
+        if (count != node.childCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TransformHierarchy::rebuild(
+    gecs::querier<GlobalTransform, Transform, gecs::without<Parent>>& roots,
     gecs::registry reg) {
     PROFILE_BEGIN();
 
-    for (auto&& [entity, gTrans, trans] : querier) {
-        gTrans.mat = trans.ToMat();
+    nodes_.clear();
+    roots_.clear();
+    batches_.clear();
+
+    for (auto&& [entity, gTrans, trans] : roots) {
+        auto begin = static_cast<uint32_t>(nodes_.size());
+        if (batches_.empty() || begin - batches_.back() >= BatchNodeCount) {
+            batches_.push_back(begin);
+        }
+        roots_.push_back(begin);
+        nodes_.push_back({entity, InvalidIndex, &trans,
+                          &reg.get_mut<GlobalTransform>(entity)});
+
+        // breadth first, so nodes in subtree are sorted by depth
+        for (uint32_t i = begin; i < nodes_.size(); i++) {
+            auto ent = nodes_[i].entity;
+            auto first = static_cast<uint32_t>(nodes_.size());
+            nodes_[i].firstChild = first;
+            if (reg.has<Child>(ent)) {
+                for (auto child : reg.get<Child>(ent).entities) {
+                    if (isNode(reg, child)) {
+                        nodes_.push_back(
+                            {child, i, &reg.get<Transform>(child),
+                             &reg.get_mut<GlobalTransform>(child)});
+                    }
+                }
+            }
+            nodes_[i].childCount =
+                static_cast<uint32_t>(nodes_.size()) - first;
+        }
     }
+    batches_.push_back(static_cast<uint32_t>(nodes_.size()));
+    dirty_.assign(nodes_.size(), 0);
+}
+
+void TransformHierarchy::updateBatch(uint32_t begin, uint32_t end,
+                                     bool force) {
+    for (uint32_t i = begin; i < end; i++) {
+        auto& node = nodes_[i];
+        auto& trans = *node.transform;
+
+        bool changed = force || node.local != trans;
+        if (changed) {
+            node.local = trans;
+            node.localMat = trans.ToAffine();
+        }
 
-    for (auto&& [entity, gTrans, trans, child] : root) {
-        doUpdateGlobalTransform(entity, trans, gTrans, child, reg);
+        bool parentDirty = node.parent != InvalidIndex && dirty_[node.parent];
+        dirty_[i] = changed || parentDirty;
+        if (!dirty_[i]) {
+            continue;
+        }
+
+        node.world = node.parent == InvalidIndex
+                         ? node.localMat
+                         : nodes_[node.parent].world * node.localMat;
+        node.global->mat = node.world;
     }
 }
 
+void UpdateGlobalTransform(
+    gecs::querier<GlobalTransform, Transform, gecs::without<Parent>> roots,
+    gecs::resource<gecs::mut<TransformHierarchy>> hierarchy,
+    gecs::resource<gecs::mut<JobPool>> jobPool, gecs::registry reg) {
+    PROFILE_BEGIN();
+
+    hierarchy->Update(roots, reg, &jobPool.get());
+}
+
 void HierarchyTool::MoveEntityAsChild(gecs::entity other,
                                       std::optional<size_t> idx) {
     HierarchyTool tool(reg_, other);
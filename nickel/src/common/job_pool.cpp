@@ -0,0 +1,93 @@
+#include "common/job_pool.hpp"
+
+namespace nickel {
+
+JobPool::JobPool(uint32_t workerCount) {
+    workers_.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++) {
+        workers_.emplace_back(&JobPool::workerLoop, this);
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard lock{mutex_};
+        quit_ = true;
+    }
+    wakeCond_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+uint32_t JobPool::DefaultWorkerCount() {
+    auto cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+void JobPool::dispatch(size_t count, JobFn fn, void* ctx) {
+    // a plain mutex can't be used here: a job running on the dispatching
+    // thread may call back into the pool, and locking it again is UB
+    bool expected = false;
+    if (workers_.empty() || count <= 1 ||
+        !dispatching_.compare_exchange_strong(expected, true,
+                                              std::memory_order_acquire)) {
+        for (size_t i = 0; i < count; i++) {
+            fn(ctx, i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock{mutex_};
+        fn_ = fn;
+        ctx_ = ctx;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        busy_ = static_cast<uint32_t>(workers_.size());
+        generation_++;
+    }
+    wakeCond_.notify_all();
+
+    runJobs();
+
+    {
+        std::unique_lock lock{mutex_};
+        doneCond_.wait(lock, [this] { return busy_ == 0; });
+    }
+    dispatching_.store(false, std::memory_order_release);
+}
+
+void JobPool::runJobs() {
+    size_t i;
+    while ((i = next_.fetch_add(1, std::memory_order_relaxed)) < count_) {
+        fn_(ctx_, i);
+    }
+}
+
+void JobPool::workerLoop() {
+    uint64_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock{mutex_};
+            wakeCond_.wait(lock, [&] {
+                return quit_ || generation_ != generation;
+            });
+            if (quit_) {
+                return;
+            }
+            generation = generation_;
+        }
+
+        runJobs();
+
+        {
+            std::lock_guard lock{mutex_};
+            if (--busy_ == 0) {
+                doneCond_.notify_one();
+            }
+        }
+    }
+}
+
+}  // namespace nickel
@@ -0,0 +1,258 @@
+#include "common/log.hpp"
+
+namespace logger {
+
+// how long backend thread sleeps when there is nothing to write
+constexpr auto AsyncWriteInterval = std::chrono::milliseconds(10);
+constexpr int64_t RateLimitWindowMs = 1000;
+
+static size_t roundUpPow2(size_t n) {
+    size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+AsyncLogBackend::AsyncLogBackend(size_t capacity, uint32_t rateLimit,
+                                 std::ostream& reportStream)
+    : rateLimit_{rateLimit}, reportStream_{reportStream} {
+    capacity = roundUpPow2(std::max<size_t>(capacity, 2));
+    mask_ = capacity - 1;
+    slots_.reset(new Slot[capacity]);
+    for (size_t i = 0; i < capacity; i++) {
+        slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    callSites_.reset(new CallSite[CallSiteCount]);
+    thread_ = std::thread(&AsyncLogBackend::threadLoop, this);
+}
+
+AsyncLogBackend::~AsyncLogBackend() {
+    {
+        std::lock_guard lock{mutex_};
+        quit_ = true;
+    }
+    wakeCond_.notify_one();
+    thread_.join();
+}
+
+bool AsyncLogBackend::rateLimit(const AsyncRecord& record,
+                                uint32_t& suppressed) {
+    if (rateLimit_ == 0) {
+        return true;
+    }
+
+    uint64_t key =
+        (reinterpret_cast<uintptr_t>(record.filename.data()) << 16) ^
+        record.line;
+    auto& site = callSites_[(key ^ (key >> 17)) % CallSiteCount];
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count();
+
+    // new window, or the slot is taken over by another call site
+    auto start = site.windowStart.load(std::memory_order_relaxed);
+    bool sameSite = site.key.load(std::memory_order_relaxed) == key;
+    if ((!sameSite || now - start >= RateLimitWindowMs) &&
+        site.windowStart.compare_exchange_strong(start, now,
+                                                 std::memory_order_relaxed)) {
+        site.key.store(key, std::memory_order_relaxed);
+        site.count.store(0, std::memory_order_relaxed);
+        auto count = site.suppressed.exchange(0, std::memory_order_relaxed);
+        if (sameSite) {
+            suppressed = count;
+        } else {
+            dropped_.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    if (site.count.fetch_add(1, std::memory_order_relaxed) >= rateLimit_) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        totalDropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool AsyncLogBackend::Push(const AsyncRecord& record) {
+    bool fatal = record.level == Level::FatalError;
+    uint32_t suppressed = 0;
+
+    // never drop fatal error, the program is going to abort
+    if (!fatal && !rateLimit(record, suppressed)) {
+        return false;
+    }
+
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[pos & mask_];
+        size_t seq = slot->seq.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1,
+                                                  std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // full, keep memory bounded by dropping the newest
+            if (!fatal) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                totalDropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield();
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::memcpy(&slot->record, &record, record.UsedSize());
+    slot->record.suppressed = suppressed;
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    if (fatal) {
+        Flush();
+    }
+    return true;
+}
+
+void AsyncLogBackend::Flush() {
+    size_t target = enqueuePos_.load(std::memory_order_acquire);
+    std::unique_lock lock{mutex_};
+    // a producer may still be filling its slot, ask again until written
+    while (writtenPos_ < target && !quit_) {
+        flushRequested_ = true;
+        wakeCond_.notify_one();
+        flushedCond_.wait(lock);
+    }
+}
+
+bool AsyncLogBackend::pop() {
+    auto& slot = slots_[dequeuePos_ & mask_];
+    if (slot.seq.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+        return false;
+    }
+
+    write(slot.record);
+    slot.seq.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+    dequeuePos_++;
+    return true;
+}
+
+void AsyncLogBackend::write(const AsyncRecord& record) {
+    using ArgType = AsyncRecord::ArgType;
+
+    auto& stream = *record.stream;
+    stream << "[" << Level2Str(record.level) << "][" << record.filename
+           << "][" << record.funcName << "][" << record.line << "]";
+
+    size_t offset = 0;
+    auto read = [&](auto& value) {
+        std::memcpy(&value, record.args + offset, sizeof(value));
+        offset += sizeof(value);
+    };
+    while (offset < record.argsSize) {
+        auto type = static_cast<ArgType>(record.args[offset++]);
+        switch (type) {
+            case ArgType::Int: {
+                int64_t value;
+                read(value);
+                stream << value;
+                break;
+            }
+            case ArgType::UInt: {
+                uint64_t value;
+                read(value);
+                stream << value;
+                break;
+            }
+            case ArgType::Float: {
+                double value;
+                read(value);
+                stream << value;
+                break;
+            }
+            case ArgType::Bool: {
+                bool value;
+                read(value);
+                stream << value;
+                break;
+            }
+            case ArgType::Char: {
+                char value;
+                read(value);
+                stream << value;
+                break;
+            }
+            case ArgType::Pointer: {
+                const void* value;
+                read(value);
+                stream << value;
+                break;
+            }
+            case ArgType::String: {
+                uint16_t len;
+                read(len);
+                stream.write(record.args + offset, len);
+                offset += len;
+                break;
+            }
+        }
+    }
+
+    if (record.truncated) {
+        stream << "...";
+    }
+    if (record.suppressed > 0) {
+        stream << " (" << record.suppressed
+               << " similar messages suppressed)";
+    }
+    stream << '\n';
+
+    if (std::find(dirtyStreams_.begin(), dirtyStreams_.end(), &stream) ==
+        dirtyStreams_.end()) {
+        dirtyStreams_.push_back(&stream);
+    }
+}
+
+void AsyncLogBackend::threadLoop() {
+    while (true) {
+        while (pop()) {
+        }
+
+        if (auto dropped = dropped_.exchange(0, std::memory_order_relaxed);
+            dropped > 0) {
+            reportStream_ << "[" << Level2Str(Level::Warning)
+                          << "][logger] " << dropped
+                          << " messages dropped, log queue is full\n";
+            if (std::find(dirtyStreams_.begin(), dirtyStreams_.end(),
+                          &reportStream_) == dirtyStreams_.end()) {
+                dirtyStreams_.push_back(&reportStream_);
+            }
+        }
+
+        // one flush per batch instead of one per line
+        for (auto stream : dirtyStreams_) {
+            stream->flush();
+        }
+        dirtyStreams_.clear();
+
+        std::unique_lock lock{mutex_};
+        writtenPos_ = dequeuePos_;
+        if (flushRequested_) {
+            flushRequested_ = false;
+            flushedCond_.notify_all();
+        }
+        if (quit_ &&
+            enqueuePos_.load(std::memory_order_acquire) == dequeuePos_) {
+            flushedCond_.notify_all();
+            return;
+        }
+        wakeCond_.wait_for(lock, AsyncWriteInterval,
+                           [this] { return quit_ || flushRequested_; });
+    }
+}
+
+}  // namespace logger
@@ -0,0 +1,93 @@
+#include "common/range_allocator.hpp"
+#include "common/assert.hpp"
+
+namespace nickel {
+
+RangeAllocator::RangeAllocator(uint64_t size) : size_{size} {
+    if (size > 0) {
+        freeRanges_.emplace(0, size);
+    }
+}
+
+uint64_t RangeAllocator::Allocate(uint64_t size, uint64_t alignment) {
+    if (size == 0) {
+        return InvalidOffset;
+    }
+
+    auto best = freeRanges_.end();
+    uint64_t bestOffset = 0;
+    for (auto it = freeRanges_.begin(); it != freeRanges_.end(); ++it) {
+        auto [begin, rangeSize] = *it;
+        uint64_t offset = (begin + alignment - 1) & ~(alignment - 1);
+        uint64_t end = begin + rangeSize;
+        if (offset > end || size > end - offset) {
+            continue;
+        }
+        if (best == freeRanges_.end() || rangeSize < best->second) {
+            best = it;
+            bestOffset = offset;
+            if (rangeSize == size && offset == begin) {
+                break;
+            }
+        }
+    }
+
+    if (best == freeRanges_.end()) {
+        return InvalidOffset;
+    }
+
+    auto [begin, rangeSize] = *best;
+    freeRanges_.erase(best);
+
+    // give alignment padding and tail back to free list
+    if (bestOffset > begin) {
+        freeRanges_.emplace(begin, bestOffset - begin);
+    }
+    uint64_t end = begin + rangeSize;
+    if (bestOffset + size < end) {
+        freeRanges_.emplace(bestOffset + size, end - bestOffset - size);
+    }
+
+    allocated_.emplace(bestOffset, size);
+    used_ += size;
+    return bestOffset;
+}
+
+void RangeAllocator::Free(uint64_t offset) {
+    auto it = allocated_.find(offset);
+    Assert(it != allocated_.end(), "free range not allocated");
+    if (it == allocated_.end()) {
+        return;
+    }
+
+    uint64_t begin = offset;
+    uint64_t size = it->second;
+    used_ -= size;
+    allocated_.erase(it);
+
+    auto next = freeRanges_.lower_bound(begin);
+    if (next != freeRanges_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == begin) {
+            begin = prev->first;
+            size += prev->second;
+            freeRanges_.erase(prev);
+        }
+    }
+    if (next != freeRanges_.end() && begin + size == next->first) {
+        size += next->second;
+        freeRanges_.erase(next);
+    }
+
+    freeRanges_.emplace(begin, size);
+}
+
+uint64_t RangeAllocator::LargestFreeRange() const {
+    uint64_t largest = 0;
+    for (auto& [_, size] : freeRanges_) {
+        largest = size > largest ? size : largest;
+    }
+    return largest;
+}
+
+}  // namespace nickel
@@ -3,11 +3,28 @@
 
 namespace nickel {
 
+// weight of new delta in smoothed delta
+constexpr double DeltaSmoothFactor = 0.1;
+// range of estimated sleep overshoot, in nanoseconds
+constexpr uint64_t MinSleepOvershoot = 100'000;
+constexpr uint64_t MaxSleepOvershoot = 4'000'000;
+
 uint64_t Time::fps_ = 60;
-uint64_t Time::fpsDuration_ = static_cast<uint64_t>(1000 / 60.0);
+uint64_t Time::fpsDuration_ = 1'000'000'000ull / 60;
+
+template <typename Duration>
+static uint64_t toNs(Duration duration) {
+    auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    return ns > 0 ? static_cast<uint64_t>(ns) : 0;
+}
 
-Time::Time() : elapse_(1) {
+Time::Time() {
     curTime_ = clock_t::now();
+    deadline_ = curTime_ + std::chrono::nanoseconds(fpsDuration_);
+    deadlinePeriodNs_ = fpsDuration_;
+    elapseNs_ = fpsDuration_ > 0 ? fpsDuration_ : 1'000'000;
+    smoothedDelta_ = elapseNs_ / 1e9;
 }
 
 Timer Timer::Null;
@@ -26,13 +43,82 @@ Timer::Timer(const std::filesystem::path& filename) : Asset(filename) {
 void Time::Update(gecs::resource<gecs::mut<Time>> t) {
     PROFILE_BEGIN();
 
-    t->elapse_ = clock_t::now() - t->curTime_;
+    t->Tick();
+}
+
+void Time::Tick() {
+    auto workEnd = clock_t::now();
+    // FPS changed, otherwise deadline of old period may stall this frame
+    if (deadlinePeriodNs_ != fpsDuration_) {
+        deadline_ = curTime_ + std::chrono::nanoseconds(fpsDuration_);
+        deadlinePeriodNs_ = fpsDuration_;
+    }
+    if (fpsDuration_ > 0) {
+        pace();
+    }
+    auto now = clock_t::now();
+
+    FrameTiming timing;
+    timing.frame = toNs(now - curTime_);
+    timing.work = toNs(workEnd - curTime_);
+    timing.wait = toNs(now - workEnd);
+    history_[historyHead_] = timing;
+    historyHead_ = (historyHead_ + 1) % HistorySize;
+    historyCount_ = std::min(historyCount_ + 1, HistorySize);
+
+    curTime_ = now;
+    elapseNs_ = timing.frame;
+    smoothedDelta_ += (DeltaSeconds() - smoothedDelta_) * DeltaSmoothFactor;
+
+    // keep frames on a fixed grid so small overshoots don't accumulate,
+    // but don't rush to catch up after missing a whole frame
+    auto period = std::chrono::nanoseconds(fpsDuration_);
+    if (now - deadline_ < period) {
+        deadline_ += period;
+    } else {
+        deadline_ = now + period;
+    }
+}
+
+void Time::pace() {
+    auto sleepUntil =
+        deadline_ - std::chrono::nanoseconds(sleepOvershootNs_);
+    if (clock_t::now() < sleepUntil) {
+        std::this_thread::sleep_until(sleepUntil);
 
-    t->curTime_ = clock_t::now();
-    if (t->Elapse() < fpsDuration_) {
-        auto duration = fpsDuration_ - t->Elapse();
-        std::this_thread::sleep_for(std::chrono::milliseconds(duration));
+        // raise estimation at once when overslept more, lower it slowly
+        auto overshoot = toNs(clock_t::now() - sleepUntil);
+        if (overshoot > sleepOvershootNs_) {
+            sleepOvershootNs_ = overshoot;
+        } else {
+            sleepOvershootNs_ -= (sleepOvershootNs_ - overshoot) / 16;
+        }
+        sleepOvershootNs_ = std::clamp(sleepOvershootNs_, MinSleepOvershoot,
+                                       MaxSleepOvershoot);
+    }
+
+    while (clock_t::now() < deadline_) {
+        std::this_thread::yield();
+    }
+}
+
+uint64_t Time::AverageFrameNs() const {
+    if (historyCount_ == 0) {
+        return 0;
+    }
+    uint64_t sum = 0;
+    for (size_t i = 0; i < historyCount_; i++) {
+        sum += GetFrameTiming(i).frame;
     }
+    return sum / historyCount_;
+}
+
+uint64_t Time::MaxFrameNs() const {
+    uint64_t result = 0;
+    for (size_t i = 0; i < historyCount_; i++) {
+        result = std::max(result, GetFrameTiming(i).frame);
+    }
+    return result;
 }
 
 void Timer::Save(const std::filesystem::path& path) {
@@ -90,4 +176,100 @@ TimerHandle TimerManager::Load(const std::filesystem::path& filename) {
     return TimerHandle::Null();
 }
 
+inline int loop2Count(int loop) {
+    return loop < 0 ? -1 : std::max(loop, 1);
+}
+
+void TimerManager::Start(TimerHandle handle) {
+    if (!Has(handle)) {
+        return;
+    }
+    auto& timer = Get(handle);
+    if (timer.isTicking_) {
+        return;
+    }
+
+    // keep counting loops on the timer, so repeat in wheel until stopped
+    TimeType remain =
+        timer.curTime_ < timer.dstTime_ ? timer.dstTime_ - timer.curTime_ : 0;
+    timer.wheelEntry_ =
+        wheel_.Schedule(remain,
+                        AssetTimerFlag |
+                            static_cast<HandleInnerIDType>(handle),
+                        timer.dstTime_, -1);
+    timer.isTicking_ = true;
+}
+
+void TimerManager::Stop(TimerHandle handle) {
+    if (Has(handle)) {
+        stop(Get(handle), true);
+    }
+}
+
+void TimerManager::Pause(TimerHandle handle) {
+    if (Has(handle)) {
+        stop(Get(handle), false);
+    }
+}
+
+void TimerManager::stop(Timer& timer, bool keepProgress) {
+    if (keepProgress && timer.isTicking_) {
+        auto remain = Remaining(timer.wheelEntry_);
+        timer.curTime_ = remain < timer.dstTime_ ? timer.dstTime_ - remain : 0;
+    } else if (!keepProgress) {
+        timer.curTime_ = 0;
+    }
+    wheel_.Cancel(timer.wheelEntry_);
+    timer.wheelEntry_ = TimerWheel::NullEntry;
+    timer.isTicking_ = false;
+}
+
+TimerWheel::EntryID TimerManager::Schedule(TimerID id, TimeType time,
+                                           int loop) {
+    return wheel_.Schedule(time, static_cast<uint32_t>(id), time,
+                           loop2Count(loop));
+}
+
+void TimerManager::Update(gecs::resource<gecs::mut<TimerManager>> mgr,
+                          gecs::resource<Time> time,
+                          gecs::event_dispatcher<TimerEvent> dispatcher) {
+    PROFILE_BEGIN();
+
+    mgr->pendingNs_ += time->ElapseNs();
+    auto ticks = mgr->pendingNs_ / 1'000'000;
+    mgr->pendingNs_ %= 1'000'000;
+
+    auto& expired = mgr->expired_;
+    expired.clear();
+    mgr->wheel_.Advance(ticks, expired);
+
+    for (auto& e : expired) {
+        if (!(e.userData & AssetTimerFlag)) {
+            dispatcher.enqueue(
+                TimerEvent{static_cast<TimerID>(static_cast<uint32_t>(
+                    e.userData))});
+            continue;
+        }
+
+        auto handle = TimerHandle::ForceCastFromIntegral(
+            static_cast<HandleInnerIDType>(e.userData));
+        // destroyed or reloaded after started
+        if (!mgr->Has(handle) || mgr->Get(handle).wheelEntry_ != e.entry) {
+            mgr->wheel_.Cancel(e.entry);
+            continue;
+        }
+
+        auto& timer = mgr->Get(handle);
+        if (timer.loop_ > 0) {
+            timer.loop_--;
+        }
+        if (timer.loop_ == 0) {
+            mgr->stop(timer, false);
+        }
+        if (timer.shouldSendEvent && timer.id_) {
+            dispatcher.enqueue(TimerEvent{timer.id_.value()});
+        }
+    }
+}
+
 }  // namespace nickel
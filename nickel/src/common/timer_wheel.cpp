@@ -0,0 +1,190 @@
+#include "common/timer_wheel.hpp"
+
+#include <algorithm>
+
+namespace nickel {
+
+inline TimerWheel::EntryID makeEntryID(uint32_t index, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | index;
+}
+
+TimerWheel::EntryID TimerWheel::Schedule(uint64_t delay, uint64_t userData,
+                                         uint64_t period, int count) {
+    uint32_t idx;
+    if (freeList_ != NullIndex) {
+        idx = freeList_;
+        freeList_ = nodes_[idx].next;
+    } else {
+        idx = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    auto& node = nodes_[idx];
+    node.expire = curTick_ + std::max<uint64_t>(delay, 1);
+    node.period = std::max<uint64_t>(period, 1);
+    node.userData = userData;
+    node.count = count == 0 ? 1 : count;
+    link(idx);
+    size_++;
+    return makeEntryID(idx, node.generation);
+}
+
+bool TimerWheel::Cancel(EntryID entry) {
+    if (!find(entry)) {
+        return false;
+    }
+    auto idx = static_cast<uint32_t>(entry);
+    unlink(idx);
+    freeNode(idx);
+    return true;
+}
+
+bool TimerWheel::IsScheduled(EntryID entry) const {
+    return find(entry) != nullptr;
+}
+
+uint64_t TimerWheel::RemainingTicks(EntryID entry) const {
+    auto node = find(entry);
+    return node ? node->expire - curTick_ : 0;
+}
+
+const TimerWheel::Node* TimerWheel::find(EntryID entry) const {
+    auto idx = static_cast<uint32_t>(entry);
+    auto generation = static_cast<uint32_t>(entry >> 32);
+    if (idx >= nodes_.size()) {
+        return nullptr;
+    }
+    auto& node = nodes_[idx];
+    return node.generation == generation && node.slot != NullIndex ? &node
+                                                                    : nullptr;
+}
+
+void TimerWheel::Advance(uint64_t ticks, std::vector<Expired>& expired) {
+    while (ticks > 0) {
+        // nothing to expire, jump over
+        if (size_ == 0) {
+            curTick_ += ticks;
+            return;
+        }
+
+        curTick_++;
+        ticks--;
+
+        auto slot = static_cast<uint32_t>(curTick_ & (NearSize - 1));
+        if (slot == 0) {
+            cascade(0);
+        }
+
+        uint32_t idx = heads_[slot];
+        heads_[slot] = NullIndex;
+        while (idx != NullIndex) {
+            auto& node = nodes_[idx];
+            uint32_t next = node.next;
+            node.slot = NullIndex;
+            expired.push_back({makeEntryID(idx, node.generation),
+                               node.userData});
+
+            if (node.count > 0) {
+                node.count--;
+            }
+            if (node.count == 0) {
+                freeNode(idx);
+            } else {
+                node.expire += node.period;
+                link(idx);
+            }
+            idx = next;
+        }
+    }
+}
+
+void TimerWheel::Clear() {
+    // keep nodes and their generations, so ids issued before never match
+    // timers scheduled later
+    heads_.fill(NullIndex);
+    freeList_ = NullIndex;
+    size_ = nodes_.size();
+    for (auto i = static_cast<uint32_t>(nodes_.size()); i > 0; i--) {
+        if (nodes_[i - 1].slot != NullIndex) {
+            freeNode(i - 1);
+        } else {
+            nodes_[i - 1].next = freeList_;
+            freeList_ = i - 1;
+            size_--;
+        }
+    }
+}
+
+void TimerWheel::link(uint32_t idx) {
+    auto& node = nodes_[idx];
+    uint64_t delta = std::min(node.expire - curTick_, MaxRange);
+    uint64_t expire = curTick_ + delta;
+
+    uint32_t slot;
+    if (delta < NearSize) {
+        slot = static_cast<uint32_t>(expire & (NearSize - 1));
+    } else {
+        int level = 0;
+        while (delta >= (1ull << (NearBits + FarBits * (level + 1)))) {
+            level++;
+        }
+        auto shift = NearBits + FarBits * level;
+        slot = NearSize + FarSize * level +
+               static_cast<uint32_t>((expire >> shift) & (FarSize - 1));
+    }
+
+    node.slot = slot;
+    node.prev = NullIndex;
+    node.next = heads_[slot];
+    if (node.next != NullIndex) {
+        nodes_[node.next].prev = idx;
+    }
+    heads_[slot] = idx;
+}
+
+void TimerWheel::unlink(uint32_t idx) {
+    auto& node = nodes_[idx];
+    if (node.prev != NullIndex) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != NullIndex) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.slot = NullIndex;
+}
+
+void TimerWheel::freeNode(uint32_t idx) {
+    auto& node = nodes_[idx];
+    node.slot = NullIndex;
+    node.generation = node.generation == std::numeric_limits<uint32_t>::max()
+                          ? 1
+                          : node.generation + 1;
+    node.next = freeList_;
+    freeList_ = idx;
+    size_--;
+}
+
+/**
+ * @brief near wheel turned a round, move timers of the next far slot down
+ */
+void TimerWheel::cascade(int level) {
+    auto shift = NearBits + FarBits * level;
+    auto index = static_cast<uint32_t>((curTick_ >> shift) & (FarSize - 1));
+    // upper wheel turned a round too, refill this wheel from it first
+    if (index == 0 && level + 1 < FarLevels) {
+        cascade(level + 1);
+    }
+
+    auto slot = NearSize + FarSize * level + index;
+    uint32_t idx = heads_[slot];
+    heads_[slot] = NullIndex;
+    while (idx != NullIndex) {
+        uint32_t next = nodes_[idx].next;
+        link(idx);
+        idx = next;
+    }
+}
+
+}  // namespace nickel
@@ -12,7 +12,6 @@ Render2DContext::Render2DContext(rhi::Adapter adapter, rhi::Device device,
                                  RenderContext& ctx)
     : device_{device} {
     auto api = adapter.RequestAdapterInfo().api;
-    initUsableVertexSlots();
     initBuffers();
     initPipelineShader(api);
     bindGroupLayout =
@@ -28,16 +27,6 @@ void Render2DContext::RecreatePipeline(rhi::APIPreference api,
     pipeline = createPipeline(api, ctx);
 }
 
-uint32_t Render2DContext::GenVertexSlot() {
-    uint32_t slot = usableVertexSlots_.top();
-    usableVertexSlots_.pop();
-    return slot;
-}
-
-void Render2DContext::ReuseVertexSlot(uint32_t slot) {
-    usableVertexSlots_.push(slot);
-}
-
 rhi::PipelineLayout Render2DContext::createPipelineLayout() {
     rhi::PipelineLayout::Descriptor layoutDesc;
     layoutDesc.layouts.emplace_back(bindGroupLayout);
@@ -57,7 +46,8 @@ rhi::BindGroupLayout Render2DContext::createBindGroupLayout(
     {
         rhi::BufferBinding bufferBinding;
         bufferBinding.buffer = ctx.mvpBuffer;
-        bufferBinding.hasDynamicOffset = false;
+        bufferBinding.hasDynamicOffset = true;
+        bufferBinding.minBindingSize = sizeof(nickel::cgmath::Mat44) * 2;
         bufferBinding.type = rhi::BufferType::Uniform;
 
         rhi::Entry entry;
@@ -129,17 +119,8 @@ rhi::Sampler Render2DContext::GetSampler(rhi::SamplerAddressMode u,
 }
 
 void Render2DContext::initBuffers() {
-    // vertex buffer
-    {
-        rhi::Buffer::Descriptor desc;
-        desc.mappedAtCreation = true;
-        desc.size = VertexBufferSize;
-        desc.usage =
-            rhi::Flags(rhi::BufferUsage::Vertex) | rhi::BufferUsage::MapWrite;
-        vertexBuffer = device_.CreateBuffer(desc);
-    }
-
-    // indices buffer
+    // indices buffer, same indices for every rect so a batch of rects can be
+    // drawn in one call
     {
         std::array<uint32_t, 6> oneIndices = {
             0, 1, 2, 2, 1, 3,
@@ -147,25 +128,23 @@ void Render2DContext::initBuffers() {
 
         rhi::Buffer::Descriptor desc;
         desc.mappedAtCreation = true;
-        desc.size = sizeof(oneIndices);
+        desc.size = sizeof(oneIndices) * MaxRectPerDraw;
         desc.usage =
             rhi::Flags(rhi::BufferUsage::Index) | rhi::BufferUsage::MapWrite;
         indexBuffer = device_.CreateBuffer(desc);
 
-        auto ptr = indexBuffer.GetMappedRange();
+        auto ptr = (uint32_t*)indexBuffer.GetMappedRange();
 
-        memcpy(ptr, oneIndices.data(), sizeof(oneIndices));
+        for (uint32_t i = 0; i < MaxRectPerDraw; i++) {
+            for (auto index : oneIndices) {
+                *ptr++ = index + i * 4;
+            }
+        }
 
         indexBuffer.Unmap();
     }
 }
 
-void Render2DContext::initUsableVertexSlots() {
-    for (int i = 0; i < MaxRectCount; i++) {
-        usableVertexSlots_.push(i);
-    }
-}
-
 rhi::BindGroup Render2DContext::createDefaultBindGroup() {
     rhi::BindGroup::Descriptor desc;
     desc.layout = bindGroupLayout;
@@ -173,7 +152,6 @@ rhi::BindGroup Render2DContext::createDefaultBindGroup() {
 }
 
 Render2DContext::~Render2DContext() {
-    vertexBuffer.Destroy();
     indexBuffer.Destroy();
     vertexShader.Destroy();
     fragmentShader.Destroy();
@@ -342,7 +320,8 @@ rhi::BindGroupLayout Render3DContext::createBindGroupLayout(
     {
         rhi::BufferBinding bufferBinding1;
         bufferBinding1.buffer = ctx.mvpBuffer;
-        bufferBinding1.hasDynamicOffset = false;
+        bufferBinding1.hasDynamicOffset = true;
+        bufferBinding1.minBindingSize = sizeof(nickel::cgmath::Mat44) * 2;
         bufferBinding1.type = rhi::BufferType::Uniform;
 
         rhi::Entry entry;
@@ -592,6 +571,7 @@ rhi::RenderPipeline Render3DContext::createPipeline(rhi::APIPreference api,
 
 RenderContext::RenderContext(rhi::Adapter adapter, rhi::Device device,
                              const cgmath::Vec2& windowSize) {
+    textureUploadQueue = std::make_unique<TextureUploadQueue>(device);
     initMVPBuffer(device);
     initDepthTexture(device, windowSize);
     cameraBuffer = createCameraBuffer(device);
@@ -621,6 +601,7 @@ RenderContext::~RenderContext() {
     mvpBuffer.Destroy();
     ctx2D.reset();
     ctx3D.reset();
+    textureUploadQueue.reset();
 }
 
 void RenderContext::RecreatePipeline(const cgmath::Vec2& size) {
@@ -658,7 +639,7 @@ void RenderContext::initMVPBuffer(rhi::Device device) {
     rhi::Buffer::Descriptor bufferDesc;
     bufferDesc.usage = rhi::BufferUsage::Uniform;
     bufferDesc.mappedAtCreation = true;
-    bufferDesc.size = sizeof(nickel::cgmath::Mat44) * 2;
+    bufferDesc.size = MVPSlotSize * rhi::MaxFramesInFlight;
     mvpBuffer = device.CreateBuffer(bufferDesc);
 }
 
@@ -160,14 +160,16 @@ private:
 
         auto rootDir = filename.parent_path();
 
-        std::vector<TextureHandle> imageHandles(model_.images.size());
         std::vector<std::unique_ptr<Material3D>> materials;
         rhi::Buffer pbrParamsBuffer;
 
-        for (int i = 0; i < model_.images.size(); i++) {
-            auto& image = model_.images[i];
-            imageHandles[i] = mgr.Load(rootDir / ParseURI2Path(image.uri));
+        // decode all images in parallel
+        std::vector<std::filesystem::path> imagePaths;
+        imagePaths.reserve(model_.images.size());
+        for (auto& image : model_.images) {
+            imagePaths.push_back(rootDir / ParseURI2Path(image.uri));
         }
+        auto imageHandles = mgr.LoadBatch(imagePaths);
 
         bool supportSeparateSampler = adapter.Limits().supportSeparateSampler;
 
@@ -0,0 +1,198 @@
+#include "graphics/glyph_atlas.hpp"
+
+#include "ft2build.h"
+#include FT_FREETYPE_H
+
+namespace nickel {
+
+// transparent border around each glyph, avoid bleeding when sampling
+constexpr uint32_t GlyphPadding = 1;
+
+GlyphAtlas::GlyphAtlas(rhi::Device device) {
+    for (auto& page : pages_) {
+        page.pixels.resize(PageSize * PageSize, 0);
+        page.texture = std::make_unique<Texture>(device, page.pixels.data(),
+                                                 PageSize, PageSize);
+        page.handle = TextureHandle::Create();
+    }
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    for (auto& page : pages_) {
+        TextureHandle::Destroy(page.handle);
+    }
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::Find(const Font& font, FontHandle handle,
+                                          int size, uint32_t code) {
+    GlyphKey key{handle, size, code};
+
+    if (auto it = glyphs_.find(key); it != glyphs_.end()) {
+        auto& slot = it->second;
+        if (slot.glyph.page) {
+            pages_[slot.page].lastUsedFrame = frame_;
+        }
+        return &slot.glyph;
+    }
+
+    if (!font) {
+        return nullptr;
+    }
+
+    auto ftGlyph = font.GetGlyph(code, size);
+    if (!ftGlyph) {
+        return nullptr;
+    }
+
+    auto& bitmap = ftGlyph->bitmap;
+    Slot slot;
+    slot.page = 0;
+    slot.glyph.size.Set(bitmap.width, bitmap.rows);
+    slot.glyph.bearing.Set(ftGlyph->bitmap_left, ftGlyph->bitmap_top);
+    slot.glyph.advance = ftGlyph->advance.x / 64.0f;
+
+    if (bitmap.width == 0 || bitmap.rows == 0) {
+        return &glyphs_.emplace(key, slot).first->second.glyph;
+    }
+
+    uint32_t w = bitmap.width + GlyphPadding * 2;
+    uint32_t h = bitmap.rows + GlyphPadding * 2;
+    uint32_t x, y;
+
+    bool packed = false;
+    for (uint32_t i = 0; i < PageCount && !packed; i++) {
+        if (pack(pages_[i], w, h, x, y)) {
+            slot.page = i;
+            packed = true;
+        }
+    }
+
+    if (!packed) {
+        uint32_t lru = 0;
+        for (uint32_t i = 1; i < PageCount; i++) {
+            if (pages_[i].lastUsedFrame < pages_[lru].lastUsedFrame) {
+                lru = i;
+            }
+        }
+
+        if (pages_[lru].lastUsedFrame == frame_) {
+            LOGW(log_tag::Renderer,
+                 "glyph atlas is full in one frame, glyph ", code, " dropped");
+            return nullptr;
+        }
+
+        clearPage(lru);
+        if (!pack(pages_[lru], w, h, x, y)) {
+            LOGW(log_tag::Renderer, "glyph ", code, " in size ", size,
+                 " is larger than glyph atlas page");
+            return nullptr;
+        }
+        slot.page = lru;
+    }
+
+    auto& page = pages_[slot.page];
+    for (uint32_t row = 0; row < h; row++) {
+        auto dst = page.pixels.data() + (y + row) * PageSize + x;
+        std::fill(dst, dst + w, 0);
+        if (row < GlyphPadding || row >= h - GlyphPadding) {
+            continue;
+        }
+
+        auto src = bitmap.buffer + (row - GlyphPadding) * bitmap.pitch;
+        for (uint32_t col = 0; col < bitmap.width; col++) {
+            // white color, coverage as alpha
+            dst[col + GlyphPadding] =
+                0x00FFFFFF | (static_cast<uint32_t>(src[col]) << 24);
+        }
+    }
+
+    page.dirtyBegin = std::min(page.dirtyBegin, y);
+    page.dirtyEnd = std::max(page.dirtyEnd, y + h);
+    page.lastUsedFrame = frame_;
+
+    slot.glyph.page = page.handle;
+    slot.glyph.uv0.Set(static_cast<float>(x + GlyphPadding) / PageSize,
+                       static_cast<float>(y + GlyphPadding) / PageSize);
+    slot.glyph.uv1.Set(
+        static_cast<float>(x + GlyphPadding + bitmap.width) / PageSize,
+        static_cast<float>(y + GlyphPadding + bitmap.rows) / PageSize);
+
+    return &glyphs_.emplace(key, slot).first->second.glyph;
+}
+
+void GlyphAtlas::Upload(rhi::CommandEncoder& encoder,
+                        rhi::TransientAllocator& staging) {
+    for (auto& page : pages_) {
+        if (page.dirtyBegin >= page.dirtyEnd) {
+            continue;
+        }
+
+        // upload whole rows so staging memory is continuous
+        uint32_t rows = page.dirtyEnd - page.dirtyBegin;
+        uint64_t size = sizeof(uint32_t) * PageSize * rows;
+        auto allocation = staging.Allocate(size);
+        memcpy(allocation.ptr, page.pixels.data() + page.dirtyBegin * PageSize,
+               size);
+        staging.Flush(allocation);
+
+        rhi::CommandEncoder::BufTexCopySrc src;
+        src.buffer = allocation.buffer;
+        src.offset = allocation.offset;
+        src.rowLength = PageSize;
+        src.rowsPerImage = rows;
+        rhi::CommandEncoder::BufTexCopyDst dst;
+        dst.texture = page.texture->RawTexture();
+        dst.origin.y = page.dirtyBegin;
+        encoder.CopyBufferToTexture(src, dst,
+                                    rhi::Extent3D{PageSize, rows, 1});
+
+        page.dirtyBegin = PageSize;
+        page.dirtyEnd = 0;
+    }
+}
+
+bool GlyphAtlas::pack(Page& page, uint32_t w, uint32_t h, uint32_t& x,
+                      uint32_t& y) {
+    if (w > PageSize) {
+        return false;
+    }
+
+    // the lowest shelf which can hold it wastes less space
+    Shelf* best = nullptr;
+    for (auto& shelf : page.shelves) {
+        if (h <= shelf.height && shelf.x + w <= PageSize &&
+            (!best || shelf.height < best->height)) {
+            best = &shelf;
+        }
+    }
+
+    if (!best) {
+        if (page.shelfBottom + h > PageSize) {
+            return false;
+        }
+        best = &page.shelves.emplace_back(Shelf{page.shelfBottom, h, 0});
+        page.shelfBottom += h;
+    }
+
+    x = best->x;
+    y = best->y;
+    best->x += w;
+    return true;
+}
+
+void GlyphAtlas::clearPage(uint32_t idx) {
+    for (auto it = glyphs_.begin(); it != glyphs_.end();) {
+        if (it->second.glyph.page && it->second.page == idx) {
+            it = glyphs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // old pixels are never sampled, new glyphs overwrite them with padding
+    auto& page = pages_[idx];
+    page.shelves.clear();
+    page.shelfBottom = 0;
+}
+
+}  // namespace nickel
@@ -39,6 +39,11 @@ Device::Device(AdapterImpl& adapter) {
 
 void Device::Destroy() {
     if (impl_) {
+        // buffers must be destroyed before backend device
+        if (impl_->transientAllocator) {
+            impl_->WaitIdle();
+            impl_->transientAllocator.reset();
+        }
         delete impl_;
         impl_ = nullptr;
     }
@@ -92,7 +97,10 @@ std::pair<Texture, TextureView> Device::GetPresentationTexture() {
 }
 
 void Device::BeginFrame() {
-    return impl_->BeginFrame();
+    impl_->BeginFrame();
+    if (impl_->transientAllocator) {
+        impl_->transientAllocator->BeginFrame();
+    }
 }
 
 void Device::EndFrame() {
@@ -107,4 +115,18 @@ Queue Device::GetQueue() {
     return impl_->GetQueue();
 }
 
+MemoryStatistics Device::GetMemoryStatistics() const {
+    return impl_->GetMemoryStatistics();
+}
+
+TransientAllocator& Device::GetTransientAllocator() {
+    constexpr uint64_t InitRegionSize = 4 * 1024 * 1024;
+
+    if (!impl_->transientAllocator) {
+        impl_->transientAllocator =
+            std::make_unique<TransientAllocator>(*impl_, InitRegionSize);
+    }
+    return *impl_->transientAllocator;
+}
+
 }  // namespace nickel::rhi
\ No newline at end of file
@@ -25,6 +25,8 @@ struct ResourceBindHelper final {
         entry_ = &entry;
     }
 
+    void SetDynamicOffset(uint32_t offset) { dynamicOffset_ = offset; }
+
     bool operator()(const BufferBinding& binding) const {
         auto buffer = static_cast<const BufferImpl*>(binding.buffer.Impl());
         GLenum bufferType;
@@ -151,12 +153,14 @@ void BindGroupImpl::Apply(const RenderPipelineImpl& pipeline,
     auto& layoutDesc =
         static_cast<BindGroupLayoutImpl*>(desc_.layout.Impl())->Descriptor();
 
+    // dynamic offsets are in the order of dynamic buffer bindings
     uint32_t bufferIdx = 0;
-    ResourceBindHelper helper{pipeline, dynamicOffset.size() <= bufferIdx
-                                            ? 0
-                                            : dynamicOffset[bufferIdx]};
+    ResourceBindHelper helper{pipeline, 0};
     for (auto& entry : desc_.entries) {
         helper.SetEntry(entry);
+        helper.SetDynamicOffset(bufferIdx < dynamicOffset.size()
+                                    ? dynamicOffset[bufferIdx]
+                                    : 0);
         if (std::visit(helper, entry.entry)) {
             bufferIdx++;
         }
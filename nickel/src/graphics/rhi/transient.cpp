@@ -0,0 +1,82 @@
+#include "graphics/rhi/transient.hpp"
+#include "common/log.hpp"
+#include "common/log_tag.hpp"
+#include "graphics/rhi/impl/device.hpp"
+
+namespace nickel::rhi {
+
+TransientAllocator::TransientAllocator(DeviceImpl& device, uint64_t regionSize)
+    : device_{device} {
+    createBuffer(regionSize);
+}
+
+TransientAllocator::~TransientAllocator() {
+    buffer_.Destroy();
+    for (auto& garbage : garbage_) {
+        garbage.buffer.Destroy();
+    }
+}
+
+void TransientAllocator::BeginFrame() {
+    frame_++;
+    frameIndex_ = frame_ % MaxFramesInFlight;
+    regions_[frameIndex_].Reset();
+
+    // all frames which may read these buffers are finished
+    auto it = std::remove_if(garbage_.begin(), garbage_.end(),
+                             [frame = frame_](Garbage& garbage) {
+                                 if (garbage.retireFrame <= frame) {
+                                     garbage.buffer.Destroy();
+                                     return true;
+                                 }
+                                 return false;
+                             });
+    garbage_.erase(it, garbage_.end());
+}
+
+TransientAllocator::Allocation TransientAllocator::Allocate(uint64_t size) {
+    auto offset = regions_[frameIndex_].Allocate(size, Alignment);
+    if (offset == LinearAllocator::InvalidOffset) {
+        // other regions of old buffer may be in flight, keep it until they
+        // come around again
+        garbage_.push_back({buffer_, frame_ + MaxFramesInFlight});
+        auto newSize = std::max(regionSize_ * 2, size);
+        LOGW(log_tag::RHI, "transient buffer region grow to ", newSize,
+             " bytes");
+        createBuffer(newSize);
+        offset = regions_[frameIndex_].Allocate(size, Alignment);
+    }
+
+    peak_ = std::max(peak_, regions_[frameIndex_].UsedSize());
+
+    Allocation allocation;
+    allocation.buffer = buffer_;
+    allocation.offset = frameIndex_ * regionSize_ + offset;
+    allocation.size = size;
+    allocation.ptr = buffer_.GetMappedRange(allocation.offset);
+    return allocation;
+}
+
+void TransientAllocator::Flush(const Allocation& allocation) {
+    auto buffer = allocation.buffer;
+    if (!buffer.IsMappingCoherence()) {
+        buffer.Flush(allocation.offset, allocation.size);
+    }
+}
+
+void TransientAllocator::createBuffer(uint64_t regionSize) {
+    regionSize = (regionSize + Alignment - 1) / Alignment * Alignment;
+
+    Buffer::Descriptor desc;
+    desc.mappedAtCreation = true;
+    desc.size = regionSize * MaxFramesInFlight;
+    desc.usage = Flags<BufferUsage>(BufferUsage::Vertex) | BufferUsage::Index |
+                 BufferUsage::Uniform | BufferUsage::CopySrc |
+                 BufferUsage::MapWrite;
+    buffer_ = device_.CreateBuffer(desc);
+
+    regionSize_ = regionSize;
+    regions_.assign(MaxFramesInFlight, LinearAllocator{regionSize});
+}
+
+}  // namespace nickel::rhi
@@ -7,7 +7,7 @@ namespace nickel::rhi::vulkan {
 
 BufferImpl::BufferImpl(DeviceImpl& dev, vk::PhysicalDevice phyDev,
                        const Buffer::Descriptor& desc)
-    : device_{dev.device} {
+    : device_{dev.device}, allocator_{*dev.memoryAllocator} {
     std::vector<uint32_t> indices;
     if (dev.queueIndices.HasSeperateQueue()) {
         indices.emplace_back(dev.queueIndices.graphicsIndex.value());
@@ -19,8 +19,11 @@ BufferImpl::BufferImpl(DeviceImpl& dev, vk::PhysicalDevice phyDev,
     size_ = desc.size;
     createBuffer(desc.size, BufferUsage2Vk(desc.usage), indices,
                  desc.mappedAtCreation);
-    allocateMem(phyDev, getMemoryProperty(phyDev, desc));
-    VK_CALL_NO_VALUE(dev.device.bindBufferMemory(buffer, mem, 0));
+    allocateMem(getMemoryProperty(phyDev, desc));
+    if (mem) {
+        VK_CALL_NO_VALUE(
+            dev.device.bindBufferMemory(buffer, mem.memory, mem.offset));
+    }
 
     if (desc.mappedAtCreation) {
         MapAsync(Flags<Buffer::Mode>(Buffer::Mode::Read) | Buffer::Mode::Write,
@@ -43,18 +46,12 @@ void BufferImpl::createBuffer(uint64_t size, vk::BufferUsageFlags usage,
     VK_CALL(buffer, device_.createBuffer(createInfo));
 }
 
-void BufferImpl::allocateMem(vk::PhysicalDevice phyDevice,
-                             vk::MemoryPropertyFlags flags) {
+void BufferImpl::allocateMem(vk::MemoryPropertyFlags flags) {
     auto requirements = device_.getBufferMemoryRequirements(buffer);
-    auto type = FindMemoryType(phyDevice, requirements, flags);
-
-    if (!type) {
-        LOGE(log_tag::Vulkan, "find corresponding memory type failed");
-    } else {
-        vk::MemoryAllocateInfo allocInfo;
-        allocInfo.setAllocationSize(requirements.size)
-            .setMemoryTypeIndex(type.value());
-        VK_CALL(mem, device_.allocateMemory(allocInfo));
+    mem = allocator_.Allocate(requirements, flags,
+                              MemoryAllocator::ResourceType::Buffer);
+    if (mem.mapped) {
+        isMappingCoherence_ = allocator_.IsCoherent(mem.memoryType);
     }
 }
 
@@ -84,9 +81,9 @@ BufferImpl::~BufferImpl() {
     if (mapState_ != Buffer::MapState::Unmapped) {
         Unmap();
     }
-    device_.freeMemory(mem);
     device_.destroyBuffer(buffer);
-    mem = nullptr;
+    allocator_.Free(mem);
+    mem = {};
     buffer = nullptr;
     device_ = nullptr;
 }
@@ -100,19 +97,22 @@ uint64_t BufferImpl::Size() const {
 }
 
 void BufferImpl::Unmap() {
-    device_.unmapMemory(mem);
+    // memory is mapped persistently by allocator
     mapState_ = Buffer::MapState::Unmapped;
     map_ = nullptr;
 }
 
 void BufferImpl::MapAsync(Flags<Buffer::Mode> mode, uint64_t offset,
                           uint64_t size) {
-    VK_CALL(map_, device_.mapMemory(mem, offset, size));
-    if (map_) {
-        mappedOffset_ = offset;
-        mappedSize_ = size;
-        mapState_ = Buffer::MapState::Mapped;
+    if (!mem.mapped) {
+        LOGE(log_tag::Vulkan, "map buffer failed: buffer is not host visible");
+        return;
     }
+
+    map_ = static_cast<char*>(mem.mapped) + offset;
+    mappedOffset_ = offset;
+    mappedSize_ = size;
+    mapState_ = Buffer::MapState::Mapped;
 }
 
 void* BufferImpl::GetMappedRange() {
@@ -128,14 +128,11 @@ void* BufferImpl::GetMappedRange(uint64_t offset, uint64_t size) {
 }
 
 void BufferImpl::Flush() {
-    vk::MappedMemoryRange range;
-    range.setMemory(mem).setOffset(mappedOffset_).setSize(mappedSize_);
-    VK_CALL_NO_VALUE(device_.flushMappedMemoryRanges(range));
+    Flush(mappedOffset_, mappedSize_);
 }
 
 void BufferImpl::Flush(uint64_t offset, uint64_t size) {
-    vk::MappedMemoryRange range;
-    range.setMemory(mem).setOffset(offset).setSize(size);
+    auto range = allocator_.GetFlushRange(mem, offset, size);
     VK_CALL_NO_VALUE(device_.flushMappedMemoryRanges(range));
 }
 
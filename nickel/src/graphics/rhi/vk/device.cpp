@@ -9,6 +9,8 @@ namespace nickel::rhi::vulkan {
 
 DeviceImpl::DeviceImpl(AdapterImpl& adapter) : adapter{adapter} {
     createDevice(adapter.instance, adapter.phyDevice, adapter.surface);
+    memoryAllocator =
+        std::make_unique<MemoryAllocator>(adapter.phyDevice, device);
     int w, h;
     SDL_GetWindowSize((SDL_Window*)adapter.window, &w, &h);
     swapchain = Swapchain(adapter.phyDevice, *this, adapter.surface,
@@ -107,7 +109,12 @@ void DeviceImpl::createCmdPool() {
 }
 
 void DeviceImpl::createSyncObject() {
-    for (int i = 0; i < swapchain.images.size(); i++) {
+    // never more frames in flight than per-frame resources in renderer
+    auto frameCount = std::min<uint32_t>(swapchain.images.size(),
+                                         rhi::MaxFramesInFlight);
+    fenceSubmitted.resize(frameCount, false);
+    cmdBufInFlight.resize(frameCount);
+    for (uint32_t i = 0; i < frameCount; i++) {
         vk::FenceCreateInfo info;
         vk::Fence fence;
         VK_CALL(fence, device.createFence(info));
@@ -149,6 +156,7 @@ DeviceImpl::~DeviceImpl() {
     swapchain.Destroy(device);
     delete graphicsQueue;
     delete presentQueue;
+    memoryAllocator.reset();
     device.destroy();
 }
 
@@ -193,6 +201,8 @@ BindGroupLayout DeviceImpl::CreateBindGroupLayout(
 }
 
 void DeviceImpl::OnWindowResize(int x, int y) {
+    // previous frames may still render to swapchain images
+    WaitIdle();
     swapchain.Destroy(device);
     swapchain = Swapchain(adapter.phyDevice, *this, adapter.surface,
                           {(float)x, (float)y});
@@ -238,9 +248,29 @@ std::pair<Texture, TextureView> DeviceImpl::GetPresentationTexture() {
 void DeviceImpl::BeginFrame() {
     auto window = (SDL_Window*)adapter.window;
     if (SDL_GetWindowFlags(window) & SDL_WINDOW_MINIMIZED) {
+        // nothing will be submitted, drain GPU so all command buffers(even
+        // those returned in other frames) can be reused
+        WaitIdle();
+        for (uint32_t i = 0; i < fences.size(); i++) {
+            if (fenceSubmitted[i]) {
+                VK_CALL_NO_VALUE(device.resetFences(fences[i]));
+                fenceSubmitted[i] = false;
+            }
+            recycleCmdBufs(i);
+        }
         return;
     }
 
+    // only wait the frame which used these per-frame resources last time,
+    // so CPU records this frame while GPU is executing the previous one
+    if (fenceSubmitted[curFrame]) {
+        VK_CALL_NO_VALUE(
+            device.waitForFences(fences[curFrame], true, UINT64_MAX));
+        VK_CALL_NO_VALUE(device.resetFences(fences[curFrame]));
+        fenceSubmitted[curFrame] = false;
+    }
+    recycleCmdBufs(curFrame);
+
     VK_CALL(curImageIndex,
             device.acquireNextImageKHR(swapchain.swapchain, UINT64_MAX,
                                        imageAvaliableSems[curFrame]));
@@ -254,11 +284,6 @@ void DeviceImpl::EndFrame() {
     }
 
     if (needPresent) {
-        VK_CALL_NO_VALUE(
-            device.waitForFences(fences[curFrame], true, UINT64_MAX));
-        VK_CALL_NO_VALUE(device.resetFences(fences[curFrame]));
-        device.resetCommandPool(cmdPool);
-
         vk::Queue present =
             static_cast<const vulkan::QueueImpl*>(presentQueue->Impl())->queue;
 
@@ -271,7 +296,7 @@ void DeviceImpl::EndFrame() {
         needPresent = false;
     }
 
-    curFrame = (curFrame + 1) % swapchain.imageInfo.imagCount;
+    curFrame = (curFrame + 1) % fences.size();
 }
 
 ShaderModule DeviceImpl::CreateShaderModule(
@@ -291,6 +316,10 @@ Queue DeviceImpl::GetQueue() {
     return *graphicsQueue;
 }
 
+MemoryStatistics DeviceImpl::GetMemoryStatistics() const {
+    return memoryAllocator->GetStatistics();
+}
+
 vk::CommandBuffer DeviceImpl::RequireCmdBuf() {
     constexpr size_t CmdBufIncStep = 5;
 
@@ -310,7 +339,15 @@ vk::CommandBuffer DeviceImpl::RequireCmdBuf() {
 }
 
 void DeviceImpl::ResetCmdBuf(vk::CommandBuffer cmd) {
-    cmdBufInVacant.emplace_back(cmd);
+    // cmd was submitted before or within current frame, so current frame's
+    // fence covers it. Command buffer is reset implicitly when begin again
+    cmdBufInFlight[curFrame].emplace_back(cmd);
+}
+
+void DeviceImpl::recycleCmdBufs(uint32_t frame) {
+    auto& cmds = cmdBufInFlight[frame];
+    cmdBufInVacant.insert(cmdBufInVacant.end(), cmds.begin(), cmds.end());
+    cmds.clear();
 }
 
 }  // namespace nickel::rhi::vulkan
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "graphics/rhi/vk/memory.hpp"
+#include "graphics/rhi/vk/util.hpp"
+
+namespace nickel::rhi::vulkan {
+
+constexpr uint64_t DefaultBlockSize = 64 * 1024 * 1024;
+constexpr uint64_t SmallHeapSize = 1024 * 1024 * 1024;
+
+struct MemoryBlock final {
+    vk::DeviceMemory memory;
+    RangeAllocator ranges;
+    void* mapped = nullptr;
+    uint32_t pool = 0;
+
+    MemoryBlock(vk::DeviceMemory memory, uint64_t size, void* mapped,
+                uint32_t pool)
+        : memory{memory}, ranges{size}, mapped{mapped}, pool{pool} {}
+};
+
+inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+MemoryAllocator::MemoryAllocator(vk::PhysicalDevice phyDevice,
+                                 vk::Device device)
+    : device_{device} {
+    props_ = phyDevice.getMemoryProperties();
+    nonCoherentAtomSize_ = std::max<uint64_t>(
+        phyDevice.getProperties().limits.nonCoherentAtomSize, 1);
+    pools_.resize(props_.memoryTypeCount * 2);
+}
+
+MemoryAllocator::~MemoryAllocator() {
+    uint32_t leaked = dedicatedCount_;
+    for (auto& pool : pools_) {
+        for (auto& block : pool.blocks) {
+            leaked += block->ranges.AllocationCount();
+            destroyBlock(*block);
+        }
+    }
+
+    if (leaked > 0) {
+        LOGW(log_tag::Vulkan, leaked,
+             " device memory allocations not freed before device destroyed");
+    }
+}
+
+MemoryAllocation MemoryAllocator::Allocate(
+    const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags flags,
+    ResourceType resourceType) {
+    std::optional<uint32_t> type;
+    for (uint32_t i = 0; i < props_.memoryTypeCount; i++) {
+        if (((1 << i) & requirements.memoryTypeBits) &&
+            (props_.memoryTypes[i].propertyFlags & flags) == flags) {
+            type = i;
+            break;
+        }
+    }
+    if (!type) {
+        LOGE(log_tag::Vulkan, "find corresponding memory type failed");
+        return {};
+    }
+
+    uint64_t size = requirements.size;
+    uint64_t alignment = requirements.alignment;
+    auto typeFlags = props_.memoryTypes[type.value()].propertyFlags;
+    // flush range must align to nonCoherentAtomSize, don't share atom with
+    // other resources
+    if ((typeFlags & vk::MemoryPropertyFlagBits::eHostVisible) &&
+        !IsCoherent(type.value())) {
+        size = alignUp(size, nonCoherentAtomSize_);
+        alignment = std::max(alignment, nonCoherentAtomSize_);
+    }
+
+    MemoryAllocation allocation;
+    allocation.memoryType = type.value();
+    allocation.size = size;
+
+    uint64_t preferredBlockSize = blockSize(type.value());
+    if (size > preferredBlockSize / 2) {
+        vk::MemoryAllocateInfo info;
+        info.setAllocationSize(size).setMemoryTypeIndex(type.value());
+        VK_CALL(allocation.memory, device_.allocateMemory(info));
+        if (!allocation.memory) {
+            return {};
+        }
+        allocation.mapped =
+            mapIfHostVisible(allocation.memory, type.value());
+        dedicatedCount_++;
+        dedicatedBytes_ += size;
+        updatePeak();
+        return allocation;
+    }
+
+    uint32_t poolIdx = type.value() * 2 + static_cast<uint32_t>(resourceType);
+    auto& pool = pools_[poolIdx];
+    MemoryBlock* block = nullptr;
+    uint64_t offset = RangeAllocator::InvalidOffset;
+    for (auto& b : pool.blocks) {
+        offset = b->ranges.Allocate(size, alignment);
+        if (offset != RangeAllocator::InvalidOffset) {
+            block = b.get();
+            break;
+        }
+    }
+
+    if (!block) {
+        auto newBlock = createBlock(poolIdx, preferredBlockSize);
+        // heap may be nearly full, try smaller blocks
+        for (uint64_t s = preferredBlockSize / 2; !newBlock && s >= size;
+             s /= 2) {
+            newBlock = createBlock(poolIdx, s);
+        }
+        if (!newBlock) {
+            LOGE(log_tag::Vulkan, "out of device memory when allocate ", size,
+                 " bytes");
+            return {};
+        }
+        offset = newBlock->ranges.Allocate(size, alignment);
+        block = pool.blocks.emplace_back(std::move(newBlock)).get();
+    }
+
+    allocation.memory = block->memory;
+    allocation.offset = offset;
+    allocation.block = block;
+    if (block->mapped) {
+        allocation.mapped = static_cast<char*>(block->mapped) + offset;
+    }
+    return allocation;
+}
+
+void MemoryAllocator::Free(const MemoryAllocation& allocation) {
+    if (!allocation) {
+        return;
+    }
+
+    if (!allocation.block) {
+        device_.freeMemory(allocation.memory);
+        dedicatedCount_--;
+        dedicatedBytes_ -= allocation.size;
+        return;
+    }
+
+    auto block = allocation.block;
+    block->ranges.Free(allocation.offset);
+    if (!block->ranges.Empty()) {
+        return;
+    }
+
+    // keep one empty block in pool, avoid re-allocate when resources are
+    // created and destroyed repeatedly
+    auto& blocks = pools_[block->pool].blocks;
+    auto emptyCount =
+        std::count_if(blocks.begin(), blocks.end(),
+                      [](auto& b) { return b->ranges.Empty(); });
+    if (emptyCount > 1) {
+        destroyBlock(*block);
+        blocks.erase(std::find_if(blocks.begin(), blocks.end(),
+                                  [=](auto& b) { return b.get() == block; }));
+    }
+}
+
+bool MemoryAllocator::IsCoherent(uint32_t memoryType) const {
+    return static_cast<bool>(props_.memoryTypes[memoryType].propertyFlags &
+                             vk::MemoryPropertyFlagBits::eHostCoherent);
+}
+
+vk::MappedMemoryRange MemoryAllocator::GetFlushRange(
+    const MemoryAllocation& allocation, uint64_t offset, uint64_t size) const {
+    uint64_t begin = allocation.offset + offset;
+    uint64_t end = begin + size;
+    if (!IsCoherent(allocation.memoryType)) {
+        begin = begin & ~(nonCoherentAtomSize_ - 1);
+        end = std::min(alignUp(end, nonCoherentAtomSize_),
+                       allocation.offset + allocation.size);
+    }
+
+    vk::MappedMemoryRange range;
+    range.setMemory(allocation.memory).setOffset(begin).setSize(end - begin);
+    return range;
+}
+
+MemoryStatistics MemoryAllocator::GetStatistics() const {
+    MemoryStatistics stat;
+    for (auto& pool : pools_) {
+        for (auto& block : pool.blocks) {
+            auto& ranges = block->ranges;
+            stat.blockCount++;
+            stat.allocationCount += ranges.AllocationCount();
+            stat.blockBytes += ranges.Size();
+            stat.usedBytes += ranges.UsedSize();
+            stat.freeRangeCount += ranges.FreeRangeCount();
+            stat.largestFreeRange =
+                std::max(stat.largestFreeRange, ranges.LargestFreeRange());
+        }
+    }
+    stat.dedicatedCount = dedicatedCount_;
+    stat.dedicatedBytes = dedicatedBytes_;
+    stat.peakBytes = peakBytes_;
+    return stat;
+}
+
+uint64_t MemoryAllocator::blockSize(uint32_t memoryType) const {
+    auto heapSize =
+        props_.memoryHeaps[props_.memoryTypes[memoryType].heapIndex].size;
+    // small heaps(e.g. 256MB BAR memory) can't afford many 64MB blocks
+    return heapSize <= SmallHeapSize ? alignUp(heapSize / 8, 1024 * 1024)
+                                     : DefaultBlockSize;
+}
+
+std::unique_ptr<MemoryBlock> MemoryAllocator::createBlock(uint32_t pool,
+                                                          uint64_t size) {
+    uint32_t memoryType = pool / 2;
+    vk::MemoryAllocateInfo info;
+    info.setAllocationSize(size).setMemoryTypeIndex(memoryType);
+
+    // out of memory is expected here, caller will retry with smaller size
+    auto result = device_.allocateMemory(info);
+    if (result.result != vk::Result::eSuccess) {
+        return nullptr;
+    }
+
+    blockBytes_ += size;
+    updatePeak();
+    return std::make_unique<MemoryBlock>(
+        result.value, size, mapIfHostVisible(result.value, memoryType), pool);
+}
+
+void MemoryAllocator::destroyBlock(MemoryBlock& block) {
+    // freed memory is unmapped implicitly
+    device_.freeMemory(block.memory);
+    blockBytes_ -= block.ranges.Size();
+    block.memory = nullptr;
+    block.mapped = nullptr;
+}
+
+void* MemoryAllocator::mapIfHostVisible(vk::DeviceMemory memory,
+                                        uint32_t memoryType) {
+    if (!(props_.memoryTypes[memoryType].propertyFlags &
+          vk::MemoryPropertyFlagBits::eHostVisible)) {
+        return nullptr;
+    }
+
+    void* ptr = nullptr;
+    VK_CALL(ptr, device_.mapMemory(memory, 0, VK_WHOLE_SIZE));
+    return ptr;
+}
+
+void MemoryAllocator::updatePeak() {
+    peakBytes_ = std::max(peakBytes_, blockBytes_ + dedicatedBytes_);
+}
+
+}  // namespace nickel::rhi::vulkan
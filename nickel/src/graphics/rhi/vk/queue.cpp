@@ -31,6 +31,7 @@ void QueueImpl::Submit(const std::vector<CommandBuffer>& cmds) {
             .setSignalSemaphores(dev_.renderFinishSems[dev_.curFrame])
             .setWaitDstStageMask(waitDstStage);
         VK_CALL_NO_VALUE(queue.submit(info, fence));
+        dev_.fenceSubmitted[dev_.curFrame] = true;
         dev_.needPresent = true;
     } else {
         vk::SubmitInfo info;
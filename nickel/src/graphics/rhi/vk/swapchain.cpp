@@ -123,7 +123,7 @@ void Swapchain::getAndCreateImageViews(DeviceImpl& dev) {
 
     for (auto& image : images) {
         auto& texture =
-            this->images.emplace_back(new TextureImpl{dev, image, {}, desc});
+            this->images.emplace_back(new TextureImpl{dev, image, desc});
 
         vk::ComponentMapping mapping;
         vk::ImageSubresourceRange range;
@@ -15,16 +15,17 @@ TextureImpl::TextureImpl(AdapterImpl& adapter, DeviceImpl& dev,
            "device.GetPresentationTexture()");
 
     createImage(desc, queueIndices);
-    allocMem(adapter.phyDevice,
-             desc.viewFormat ? desc.viewFormat.value() : desc.format,
-             desc.size);
+    allocMem();
 
-    VK_CALL_NO_VALUE(dev_.device.bindImageMemory(image, mem, 0));
+    if (mem) {
+        VK_CALL_NO_VALUE(
+            dev_.device.bindImageMemory(image, mem.memory, mem.offset));
+    }
 }
 
-TextureImpl::TextureImpl(DeviceImpl& dev, vk::Image image, vk::DeviceMemory mem,
+TextureImpl::TextureImpl(DeviceImpl& dev, vk::Image image,
                          const Texture::Descriptor& desc)
-    : rhi::TextureImpl{desc}, dev_{dev}, image{image}, mem{mem} {
+    : rhi::TextureImpl{desc}, dev_{dev}, image{image} {
     layouts.emplace_back(vk::ImageLayout::eUndefined);
 }
 
@@ -63,30 +64,23 @@ void TextureImpl::createImage(const Texture::Descriptor& desc,
     VK_CALL(image, dev_.device.createImage(info));
 }
 
-void TextureImpl::allocMem(vk::PhysicalDevice phyDevice, TextureFormat,
-                           const Extent3D&) {
+void TextureImpl::allocMem() {
     auto requirements = dev_.device.getImageMemoryRequirements(image);
-    auto index = FindMemoryType(phyDevice, requirements,
-
-                                vk::MemoryPropertyFlagBits::eDeviceLocal);
-    if (!index) {
-        LOGE(log_tag::Vulkan, "allocate image memory failed: no satisfied "
-                              "memory type (DeviceLocal)");
+    mem = dev_.memoryAllocator->Allocate(
+        requirements, vk::MemoryPropertyFlagBits::eDeviceLocal,
+        MemoryAllocator::ResourceType::Image);
+    if (!mem) {
+        LOGE(log_tag::Vulkan, "allocate image memory failed");
     }
-
-    vk::MemoryAllocateInfo allocInfo;
-    allocInfo.setAllocationSize(requirements.size)
-        .setMemoryTypeIndex(index.value());
-    VK_CALL(mem, dev_.device.allocateMemory(allocInfo));
 }
 
 TextureImpl::~TextureImpl() {
-    if (mem) {
-        dev_.device.freeMemory(mem);
-    }
     if (image) {
         dev_.device.destroy(image);
     }
+    if (mem) {
+        dev_.memoryAllocator->Free(mem);
+    }
 }
 
 TextureView TextureImpl::CreateView(const TextureView::Descriptor& desc) {
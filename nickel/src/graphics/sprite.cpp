@@ -15,13 +15,4 @@ Sprite Sprite::FromCustomSize(const cgmath::Vec2& size) {
     return sprite;
 }
 
-Sprite::~Sprite() {
-    if (slot) {
-        ECS::Instance()
-            .World()
-            .res_mut<RenderContext>()
-            ->ctx2D->ReuseVertexSlot(slot.value());
-    }
-}
-
 }  // namespace nickel
\ No newline at end of file
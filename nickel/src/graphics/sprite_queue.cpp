@@ -0,0 +1,103 @@
+#include "graphics/sprite_queue.hpp"
+
+namespace nickel {
+
+SpriteRenderQueue::Key SpriteRenderQueue::MakeKey(int orderInLayer,
+                                                  Material2DHandle material,
+                                                  TextureHandle texture) {
+    static_assert(sizeof(HandleInnerIDType) <= sizeof(uint32_t),
+                  "handle id can't fit in sort key");
+
+    Key key;
+    // flip sign bit so negative layers are ordered before positive ones
+    key.layer = static_cast<uint32_t>(orderInLayer) ^ 0x80000000u;
+    key.state = (static_cast<uint64_t>(
+                     static_cast<HandleInnerIDType>(material))
+                 << 32) |
+                static_cast<HandleInnerIDType>(texture);
+    return key;
+}
+
+void SpriteRenderQueue::BeginFrame() {
+    frame_++;
+    dirtyCount_ = 0;
+}
+
+void SpriteRenderQueue::Push(gecs::entity entity, Key key,
+                             const Transform& transform, const Sprite& sprite,
+                             const Material2D& material,
+                             const Texture& texture) {
+    Entry* entry = nullptr;
+    if (auto it = indices_.find(entity); it != indices_.end()) {
+        entry = &entries_[it->second];
+        if (entry->key != key) {
+            entry->key = key;
+            dirtyCount_++;
+        }
+    } else {
+        indices_.emplace(entity, static_cast<uint32_t>(entries_.size()));
+        entry = &entries_.emplace_back();
+        entry->key = key;
+        entry->entity = entity;
+        dirtyCount_++;
+    }
+
+    entry->transform = &transform;
+    entry->sprite = &sprite;
+    entry->material = &material;
+    entry->texture = &texture;
+    entry->frame = frame_;
+}
+
+void SpriteRenderQueue::Sort() {
+    // sprites destroyed or hidden, remove them and keep the order
+    auto removed = std::remove_if(
+        entries_.begin(), entries_.end(),
+        [frame = frame_](const Entry& entry) { return entry.frame != frame; });
+    bool anyRemoved = removed != entries_.end();
+    entries_.erase(removed, entries_.end());
+
+    if (dirtyCount_ == 0) {
+        if (anyRemoved) {
+            rebuildIndices();
+        }
+        return;
+    }
+
+    auto less = [](const Entry& a, const Entry& b) {
+        return a.key < b.key || (a.key == b.key && a.entity < b.entity);
+    };
+
+    // few changes leave the queue nearly sorted, insertion sort is nearly O(n)
+    if (dirtyCount_ * 8 <= entries_.size()) {
+        for (size_t i = 1; i < entries_.size(); i++) {
+            auto entry = entries_[i];
+            size_t j = i;
+            while (j > 0 && less(entry, entries_[j - 1])) {
+                entries_[j] = entries_[j - 1];
+                j--;
+            }
+            entries_[j] = entry;
+        }
+    } else {
+        std::sort(entries_.begin(), entries_.end(), less);
+    }
+
+    rebuildIndices();
+}
+
+void SpriteRenderQueue::rebuildIndices() {
+    for (uint32_t i = 0; i < entries_.size(); i++) {
+        indices_[entries_[i].entity] = i;
+    }
+    for (auto it = indices_.begin(); it != indices_.end();) {
+        auto idx = it->second;
+        if (idx >= entries_.size() || entries_[idx].entity != it->first) {
+            it = indices_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace nickel
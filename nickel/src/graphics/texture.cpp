@@ -1,10 +1,13 @@
 #include "graphics/texture.hpp"
 #include "graphics/context.hpp"
+#include "common/job_pool.hpp"
 #include "lunasvg.h"
 #include "stb_image.h"
 
 namespace nickel {
 
+uint8_t GetTextureFormatSize(rhi::TextureFormat fmt);
+
 Texture Texture::Null = Texture{};
 
 Texture::Texture(rhi::Device device, const std::filesystem::path& filename,
@@ -12,18 +15,32 @@ Texture::Texture(rhi::Device device, const std::filesystem::path& filename,
     : Asset(filename) {
     stbi_uc* pixels = stbi_load((filename).string().c_str(), &w_, &h_, nullptr,
                                 STBI_rgb_alpha);
-    if (pixels) {
-        texture_ = createTexture(device, pixels, w_, h_, gpuFmt, usage);
-        if (!texture_) {
-            LOGE(log_tag::RHI, "create texture from", filename, "failed");
-        } else {
-            view_ = texture_.CreateView();
-        }
-    } else {
+    if (!pixels) {
         LOGE(log_tag::Asset, "load texture from ", filename, " failed");
+        return;
     }
 
-    stbi_image_free(pixels);
+    initAsync(device, pixels, gpuFmt, usage);
+}
+
+void Texture::initAsync(rhi::Device device, void* pixels,
+                        rhi::TextureFormat gpuFmt,
+                        rhi::Flags<rhi::TextureUsage> usage) {
+    texture_ = createTexture(device, nullptr, w_, h_, gpuFmt, usage);
+    if (!texture_) {
+        LOGE(log_tag::RHI, "create texture from", RelativePath(), "failed");
+        stbi_image_free(pixels);
+        return;
+    }
+    view_ = texture_.CreateView();
+
+    // upload with other textures in next frame, don't stall GPU here
+    uploadQueue_ = ECS::Instance()
+                       .World()
+                       .res_mut<RenderContext>()
+                       ->textureUploadQueue.get();
+    uploadTicket_ = uploadQueue_->Enqueue(texture_, pixels, stbi_image_free,
+                                          w_, h_, GetTextureFormatSize(gpuFmt));
 }
 
 Texture::Texture(rhi::Device device, const toml::table& tbl) {
@@ -218,7 +235,14 @@ rhi::Texture Texture::createTexture(rhi::Device dev, void* data, uint32_t w,
     return texture;
 }
 
+bool Texture::IsReady() const {
+    return !uploadQueue_ || uploadQueue_->IsFinished(uploadTicket_);
+}
+
 Texture::~Texture() {
+    if (!IsReady()) {
+        uploadQueue_->Cancel(texture_);
+    }
     view_.Destroy();
     texture_.Destroy();
 }
@@ -242,6 +266,120 @@ TextureHandle TextureManager::Load(const std::filesystem::path& filename,
     return handle;
 }
 
+std::vector<TextureHandle> TextureManager::LoadBatch(
+    const std::vector<std::filesystem::path>& filenames,
+    rhi::TextureFormat gpuFmt, rhi::Flags<rhi::TextureUsage> usage) {
+    struct DecodeTask {
+        std::filesystem::path filename;
+        stbi_uc* pixels = nullptr;
+        int w = 0;
+        int h = 0;
+        TextureHandle handle;
+    };
+
+    constexpr size_t NoTask = std::numeric_limits<size_t>::max();
+
+    std::vector<TextureHandle> handles(filenames.size());
+    std::vector<DecodeTask> tasks;
+    std::vector<size_t> taskOfFile(filenames.size(), NoTask);
+    std::unordered_map<std::string, size_t> taskIndices;
+
+    for (size_t i = 0; i < filenames.size(); i++) {
+        if (Has(filenames[i])) {
+            handles[i] = GetHandle(filenames[i]);
+            continue;
+        }
+        auto [it, inserted] =
+            taskIndices.emplace(filenames[i].string(), tasks.size());
+        if (inserted) {
+            tasks.push_back({filenames[i]});
+        }
+        taskOfFile[i] = it->second;
+    }
+
+    auto& world = ECS::Instance().World();
+    world.res_mut<JobPool>()->ParallelFor(tasks.size(), [&tasks](size_t i) {
+        auto& task = tasks[i];
+        task.pixels = stbi_load(task.filename.string().c_str(), &task.w,
+                                &task.h, nullptr, STBI_rgb_alpha);
+    });
+
+    // GPU objects are created on this thread, uploads are batched by
+    // TextureUploadQueue
+    auto device = world.res<rhi::Device>().get();
+    for (auto& task : tasks) {
+        if (!task.pixels) {
+            LOGE(log_tag::Asset, "load texture from ", task.filename,
+                 " failed");
+            continue;
+        }
+
+        auto texture = std::make_unique<Texture>();
+        texture->AssociateFile(task.filename);
+        texture->w_ = task.w;
+        texture->h_ = task.h;
+        texture->initAsync(device, task.pixels, gpuFmt, usage);
+        if (*texture) {
+            task.handle = TextureHandle::Create();
+            storeNewItem(task.handle, std::move(texture));
+        }
+    }
+
+    for (size_t i = 0; i < filenames.size(); i++) {
+        if (taskOfFile[i] != NoTask) {
+            handles[i] = tasks[taskOfFile[i]].handle;
+        }
+    }
+
+    return handles;
+}
+
+void TextureManager::LoadFromToml(const std::filesystem::path& filename) {
+    auto parse = toml::parse_file(filename.string());
+    if (!parse) {
+        LOGW(log_tag::Asset, "load manager from config file ", filename,
+             " failed:", parse.error());
+    } else {
+        LoadFromToml(parse.table());
+    }
+}
+
+void TextureManager::LoadFromToml(const toml::table& tbl) {
+    auto dataPaths = tbl["datas"];
+    if (!dataPaths.is_array()) {
+        return;
+    }
+
+    std::vector<std::filesystem::path> metaFiles;
+    std::vector<std::filesystem::path> imageFiles;
+    for (auto& node : *dataPaths.as_array()) {
+        if (!node.is_string()) {
+            continue;
+        }
+
+        std::filesystem::path metaFile = node.as_string()->get();
+        auto parse = toml::parse_file(metaFile.string());
+        if (!parse) {
+            LOGW(log_tag::Asset, "load asset from meta file ", metaFile,
+                 " failed:", parse.error());
+            continue;
+        }
+        if (auto path = parse.table().get("path");
+            !path || !path->is_string()) {
+            LOGW(log_tag::Asset,
+                 "deserialize texture failed! `path` field not string");
+        } else {
+            metaFiles.push_back(metaFile);
+            imageFiles.push_back(path->as_string()->get());
+        }
+    }
+
+    auto handles = LoadBatch(imageFiles);
+    for (size_t i = 0; i < handles.size(); i++) {
+        AssociateFile(handles[i], StripMetaExtension(metaFiles[i]));
+    }
+}
+
 std::tuple<TextureHandle, Texture&> TextureManager::LoadAndGet(
     const std::filesystem::path& filename, rhi::TextureFormat gpuFmt,
     rhi::Flags<rhi::TextureUsage> usage) {
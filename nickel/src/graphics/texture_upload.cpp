@@ -0,0 +1,60 @@
+#include "graphics/texture_upload.hpp"
+
+namespace nickel {
+
+TextureUploadQueue::TextureUploadQueue(rhi::Device device) : device_{device} {}
+
+TextureUploadQueue::Ticket TextureUploadQueue::Enqueue(
+    rhi::Texture texture, void* pixels, PixelDeleter deleter, uint32_t w,
+    uint32_t h, uint32_t bytesPerPixel) {
+    auto ticket = next_++;
+    requests_.push_back({ticket, texture,
+                         std::unique_ptr<void, PixelDeleter>{pixels, deleter},
+                         w, h, static_cast<uint64_t>(w) * h * bytesPerPixel});
+    return ticket;
+}
+
+void TextureUploadQueue::Cancel(rhi::Texture texture) {
+    requests_.erase(std::remove_if(requests_.begin(), requests_.end(),
+                                   [&](const Request& request) {
+                                       return request.texture.Impl() ==
+                                              texture.Impl();
+                                   }),
+                    requests_.end());
+}
+
+void TextureUploadQueue::Flush(rhi::CommandEncoder& encoder) {
+    auto& staging = device_.GetTransientAllocator();
+
+    uint64_t uploaded = 0;
+    while (!requests_.empty()) {
+        auto& request = requests_.front();
+
+        // a texture larger than budget is still uploaded, but alone
+        if (uploaded > 0 && uploaded + request.size > MaxBytesPerFrame) {
+            break;
+        }
+
+        auto allocation = staging.Allocate(request.size);
+        memcpy(allocation.ptr, request.pixels.get(), request.size);
+        staging.Flush(allocation);
+
+        rhi::CommandEncoder::BufTexCopySrc src;
+        src.buffer = allocation.buffer;
+        src.offset = allocation.offset;
+        src.rowLength = request.w;
+        src.rowsPerImage = request.h;
+        rhi::CommandEncoder::BufTexCopyDst dst;
+        dst.texture = request.texture;
+        dst.aspect = rhi::TextureAspect::ColorOnly;
+        dst.miplevel = 0;
+        encoder.CopyBufferToTexture(src, dst,
+                                    rhi::Extent3D{request.w, request.h, 1});
+
+        uploaded += request.size;
+        finished_ = request.ticket;
+        requests_.pop_front();
+    }
+}
+
+}  // namespace nickel
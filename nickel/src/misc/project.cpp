@@ -1,4 +1,5 @@
 #include "misc/project.hpp"
+#include "common/job_pool.hpp"
 #include "common/log_tag.hpp"
 #include "graphics/gltf.hpp"
 #include "graphics/system.hpp"
@@ -120,6 +121,7 @@ void SaveBasicProjectConfig(const ProjectInitInfo& initInfo) {
     // TODO: serialize camera information
 
     tbl.emplace("scene", initInfo.startupScene.string());
+    tbl.emplace("precompile_scripts", initInfo.precompileScripts);
 
     std::ofstream file(GenProjectConfigFilePath(initInfo.projectPath));
     file << toml::toml_formatter{tbl} << std::endl;
@@ -131,6 +133,10 @@ void SaveProjectByConfig(const ProjectInitInfo& info,
     SaveAssets(info.projectPath, assetMgr);
     SaveRegistry(true, info.projectPath, "MainScene.scene",
                  *ECS::Instance().World().cur_registry());
+    if (info.precompileScripts) {
+        auto count = ScriptManager::Precompile(info.projectPath);
+        LOGI(log_tag::Script, "precompiled ", count, " scripts");
+    }
 }
 
 ProjectInitInfo LoadProjectInfoFromFile(const std::filesystem::path& rootPath) {
@@ -160,6 +166,10 @@ ProjectInitInfo LoadProjectInfoFromFile(const std::filesystem::path& rootPath) {
         initInfo.startupScene = node.as_string()->get();
     }
 
+    if (auto node = tbl["precompile_scripts"]; node.is_boolean()) {
+        initInfo.precompileScripts = node.as_boolean()->get();
+    }
+
     return initInfo;
 }
 
@@ -214,6 +224,9 @@ void InitSystem(gecs::world& world, const ProjectInitInfo& info,
     auto& device = cmds.emplace_resource<rhi::Device>(adapter.RequestDevice());
 
     cmds.emplace_resource<Time>();
+    // shared by physics, transform hierarchy and texture loading
+    cmds.emplace_resource<JobPool>(JobPool::DefaultWorkerCount());
+    cmds.emplace_resource<TransformHierarchy>();
     auto& textureMgr = cmds.emplace_resource<TextureManager>();
     auto& mtl2dMgr = cmds.emplace_resource<Material2DManager>();
     auto& fontMgr = cmds.emplace_resource<FontManager>();
@@ -260,6 +273,10 @@ void EngineShutdown() {
     world.remove_res<AnimationManager>();
     world.remove_res<AudioManager>();
     world.remove_res<GLTFManager>();
+    world.remove_res<TransformHierarchy>();
+    // physics world solves on the job pool, must go first
+    world.remove_res<physics::World>();
+    world.remove_res<JobPool>();
     FontSystemShutdown();
     world.remove_res<RenderContext>();
     world.res_mut<rhi::Device>()->Destroy();
@@ -288,11 +305,11 @@ void RegistEngineSystem(typename gecs::world::registry_type& reg) {
         .regist_update_system<HandleInputEvents>()
         .regist_update_system<UpdateGlobalTransform>()
         .regist_update_system<UpdateGLTFModelTransform>()
-        .regist_update_system<UpdateCamera2GPU>()
         .regist_update_system<ui::UpdateGlobalPosition>()
         .regist_update_system<ui::HandleEventSystem>()
         // render relate
         .regist_update_system<BeginFrame>()
+        .regist_update_system<UpdateCamera2GPU>()
         .regist_update_system<BeginRender>()
         .regist_update_system<RenderGLTFModel>()
         .regist_update_system<RenderSprite2D>()
@@ -301,6 +318,7 @@ void RegistEngineSystem(typename gecs::world::registry_type& reg) {
         .regist_update_system<EndFrame>()
         // time update
         .regist_update_system<Time::Update>()
+        .regist_update_system<TimerManager::Update>()
         .regist_update_system<ScriptUpdateSystem>();
 
     reg.event_dispatcher<ChangeSceneEvent>().sink().add<doChangeScene>();
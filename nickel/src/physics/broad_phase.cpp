@@ -0,0 +1,140 @@
+#include "physics/broad_phase.hpp"
+#include "physics/world.hpp"
+
+namespace nickel {
+
+namespace physics {
+
+AABB GetShapeAABB(const Shape& shape, const Vec2& pos) {
+    switch (shape.GetType()) {
+        case Shape::Type::Circle: {
+            auto& c = shape_cast<const CircleShape&>(shape).shape;
+            return AABB::FromCenter(c.center + pos, Vec2{c.radius, c.radius});
+        }
+        case Shape::Type::OBB: {
+            auto& obb = shape_cast<const OBBShape&>(shape).shape;
+            auto&& [xAxis, yAxis] = obb.GetAxis();
+            Vec2 halfLen{std::abs(xAxis.x) * obb.halfLen.x +
+                             std::abs(yAxis.x) * obb.halfLen.y,
+                         std::abs(xAxis.y) * obb.halfLen.x +
+                             std::abs(yAxis.y) * obb.halfLen.y};
+            return AABB::FromCenter(obb.center + pos, halfLen);
+        }
+        case Shape::Type::Polygon: {
+            auto& pts = shape_cast<const PolygonShape&>(shape).shape;
+            if (pts.empty()) {
+                return AABB::FromCenter(pos, {});
+            }
+            Vec2 min = pts[0], max = pts[0];
+            for (auto& p : pts) {
+                min.Set(std::min(min.x, p.x), std::min(min.y, p.y));
+                max.Set(std::max(max.x, p.x), std::max(max.y, p.y));
+            }
+            return AABB::FromMinMax(min + pos, max + pos);
+        }
+        case Shape::Type::Capsule: {
+            auto& c = shape_cast<const CapsuleShape&>(shape).shape;
+            auto p1 = c.seg.p;
+            auto p2 = c.seg.p + c.seg.dir * c.seg.len;
+            Vec2 radius{c.radius, c.radius};
+            return AABB::FromMinMax(
+                Vec2{std::min(p1.x, p2.x), std::min(p1.y, p2.y)} - radius + pos,
+                Vec2{std::max(p1.x, p2.x), std::max(p1.y, p2.y)} + radius +
+                    pos);
+        }
+    }
+
+    return AABB::FromCenter(pos, {});
+}
+
+std::unique_ptr<BroadPhase> BroadPhase::Create(Type type) {
+    switch (type) {
+        case Type::BruteForce:
+            return std::make_unique<BruteForceBroadPhase>();
+        case Type::SweepAndPrune:
+            return std::make_unique<SweepAndPruneBroadPhase>();
+    }
+    return nullptr;
+}
+
+static bool isPairActive(const std::vector<uint8_t>& active, uint32_t a,
+                         uint32_t b) {
+    return active.empty() || active[a] || active[b];
+}
+
+void BruteForceBroadPhase::FindPairs(const std::vector<AABB>& bounds,
+                                     const std::vector<uint8_t>& active,
+                                     std::vector<BroadPhasePair>& pairs) {
+    pairs.clear();
+
+    uint32_t count = static_cast<uint32_t>(bounds.size());
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = i + 1; j < count; j++) {
+            if (isPairActive(active, i, j) &&
+                geom::IsAABBIntersect(bounds[i], bounds[j])) {
+                pairs.push_back({i, j});
+            }
+        }
+    }
+}
+
+void SweepAndPruneBroadPhase::FindPairs(const std::vector<AABB>& bounds,
+                                        const std::vector<uint8_t>& active,
+                                        std::vector<BroadPhasePair>& pairs) {
+    pairs.clear();
+
+    uint32_t count = static_cast<uint32_t>(bounds.size());
+    bool coherent = order_.size() == count;
+    if (!coherent) {
+        order_.resize(count);
+        std::iota(order_.begin(), order_.end(), 0);
+    }
+
+    intervals_.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        auto& aabb = bounds[order_[i]];
+        intervals_[i] = {aabb.center.x - aabb.halfLen.x,
+                         aabb.center.x + aabb.halfLen.x, order_[i]};
+    }
+
+    // order of last step is nearly sorted, insertion sort is fast on it
+    if (coherent) {
+        for (uint32_t i = 1; i < count; i++) {
+            auto interval = intervals_[i];
+            uint32_t j = i;
+            while (j > 0 && intervals_[j - 1].min > interval.min) {
+                intervals_[j] = intervals_[j - 1];
+                j--;
+            }
+            intervals_[j] = interval;
+        }
+    } else {
+        std::sort(intervals_.begin(), intervals_.end(),
+                  [](const Interval& a, const Interval& b) {
+                      return a.min < b.min;
+                  });
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        order_[i] = intervals_[i].idx;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        auto& interval = intervals_[i];
+        for (uint32_t j = i + 1;
+             j < count && intervals_[j].min <= interval.max; j++) {
+            auto a = interval.idx;
+            auto b = intervals_[j].idx;
+            if (isPairActive(active, a, b) &&
+                geom::IsAABBIntersect(bounds[a], bounds[b])) {
+                pairs.push_back({std::min(a, b), std::max(a, b)});
+            }
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+}
+
+}  // namespace physics
+
+}  // namespace nickel
@@ -0,0 +1,45 @@
+#include "physics/contact_cache.hpp"
+
+namespace nickel {
+
+namespace physics {
+
+void ContactCache::Restore(std::vector<Contact>& contacts) const {
+    auto it = entries_.begin();
+    for (auto& contact : contacts) {
+        while (it != entries_.end() && it->key < contact.key) {
+            it++;
+        }
+        if (it == entries_.end()) {
+            break;
+        }
+        if (it->key != contact.key) {
+            continue;
+        }
+        // points may be reordered, or some of them appear/disappear
+        auto& manifold = contact.manifold;
+        for (int i = 0; i < manifold.pointCount; i++) {
+            for (int j = 0; j < it->pointCount; j++) {
+                if (it->ids[j] == manifold.ids[i]) {
+                    contact.normalImpulse[i] = it->normalImpulse[j];
+                    contact.tangentImpulse[i] = it->tangentImpulse[j];
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void ContactCache::fillEntry(Entry& entry, const Contact& contact) {
+    entry.key = contact.key;
+    entry.pointCount = contact.manifold.pointCount;
+    for (int i = 0; i < Manifold::MaxPointNum; i++) {
+        entry.ids[i] = contact.manifold.ids[i];
+        entry.normalImpulse[i] = contact.normalImpulse[i];
+        entry.tangentImpulse[i] = contact.tangentImpulse[i];
+    }
+}
+
+}  // namespace physics
+
+}  // namespace nickel
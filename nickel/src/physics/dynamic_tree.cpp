@@ -0,0 +1,253 @@
+#include "physics/dynamic_tree.hpp"
+
+namespace nickel {
+
+namespace physics {
+
+inline Real perimeter(const Vec2& min, const Vec2& max) {
+    return 2 * (max.x - min.x + max.y - min.y);
+}
+
+inline Vec2 minOf(const Vec2& a, const Vec2& b) {
+    return {std::min(a.x, b.x), std::min(a.y, b.y)};
+}
+
+inline Vec2 maxOf(const Vec2& a, const Vec2& b) {
+    return {std::max(a.x, b.x), std::max(a.y, b.y)};
+}
+
+uint32_t DynamicAABBTree::CreateProxy(const AABB& aabb, uint32_t userData) {
+    auto proxy = allocateNode();
+    auto& node = nodes_[proxy];
+    Vec2 margin{margin_, margin_};
+    node.min = aabb.center - aabb.halfLen - margin;
+    node.max = aabb.center + aabb.halfLen + margin;
+    node.userData = userData;
+    node.height = 0;
+    insertLeaf(proxy);
+    proxyCount_++;
+    return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(uint32_t proxy) {
+    Assert(proxy < nodes_.size() && nodes_[proxy].IsLeaf(),
+           "destroy invalid proxy");
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount_--;
+}
+
+bool DynamicAABBTree::MoveProxy(uint32_t proxy, const AABB& aabb,
+                                const Vec2& displacement) {
+    Assert(proxy < nodes_.size() && nodes_[proxy].IsLeaf(),
+           "move invalid proxy");
+
+    auto& node = nodes_[proxy];
+    Vec2 min = aabb.center - aabb.halfLen;
+    Vec2 max = aabb.center + aabb.halfLen;
+    if (node.min.x <= min.x && node.min.y <= min.y && max.x <= node.max.x &&
+        max.y <= node.max.y) {
+        return false;
+    }
+
+    removeLeaf(proxy);
+    Vec2 margin{margin_, margin_};
+    auto d = displacement * DisplacementMultiplier;
+    nodes_[proxy].min = min - margin + minOf(d, Vec2{});
+    nodes_[proxy].max = max + margin + maxOf(d, Vec2{});
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicAABBTree::Clear() {
+    nodes_.clear();
+    root_ = NullNode;
+    freeList_ = NullNode;
+    proxyCount_ = 0;
+}
+
+uint32_t DynamicAABBTree::allocateNode() {
+    if (freeList_ == NullNode) {
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    auto idx = freeList_;
+    freeList_ = nodes_[idx].parent;
+    nodes_[idx] = Node{};
+    return idx;
+}
+
+void DynamicAABBTree::freeNode(uint32_t idx) {
+    nodes_[idx].parent = freeList_;
+    nodes_[idx].height = -1;
+    freeList_ = idx;
+}
+
+void DynamicAABBTree::insertLeaf(uint32_t leaf) {
+    if (root_ == NullNode) {
+        root_ = leaf;
+        nodes_[leaf].parent = NullNode;
+        return;
+    }
+
+    // find the best sibling by surface area heuristic
+    auto leafMin = nodes_[leaf].min;
+    auto leafMax = nodes_[leaf].max;
+    uint32_t idx = root_;
+    while (!nodes_[idx].IsLeaf()) {
+        auto& node = nodes_[idx];
+        Real area = perimeter(node.min, node.max);
+        Real combinedArea =
+            perimeter(minOf(node.min, leafMin), maxOf(node.max, leafMax));
+
+        // cost of creating a new parent for this node and the new leaf
+        Real cost = 2 * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        Real inheritanceCost = 2 * (combinedArea - area);
+
+        auto childCost = [&](uint32_t child) {
+            auto& c = nodes_[child];
+            Real newArea =
+                perimeter(minOf(c.min, leafMin), maxOf(c.max, leafMax));
+            if (c.IsLeaf()) {
+                return newArea + inheritanceCost;
+            }
+            return newArea - perimeter(c.min, c.max) + inheritanceCost;
+        };
+        Real cost1 = childCost(node.child1);
+        Real cost2 = childCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        idx = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    auto sibling = idx;
+    auto oldParent = nodes_[sibling].parent;
+    auto newParent = allocateNode();
+    auto& parentNode = nodes_[newParent];
+    parentNode.parent = oldParent;
+    parentNode.min = minOf(nodes_[sibling].min, leafMin);
+    parentNode.max = maxOf(nodes_[sibling].max, leafMax);
+    parentNode.height = nodes_[sibling].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent == NullNode) {
+        root_ = newParent;
+    } else if (nodes_[oldParent].child1 == sibling) {
+        nodes_[oldParent].child1 = newParent;
+    } else {
+        nodes_[oldParent].child2 = newParent;
+    }
+
+    refit(nodes_[leaf].parent);
+}
+
+void DynamicAABBTree::removeLeaf(uint32_t leaf) {
+    if (leaf == root_) {
+        root_ = NullNode;
+        return;
+    }
+
+    auto parent = nodes_[leaf].parent;
+    auto grandParent = nodes_[parent].parent;
+    auto sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2
+                                                 : nodes_[parent].child1;
+
+    if (grandParent == NullNode) {
+        root_ = sibling;
+        nodes_[sibling].parent = NullNode;
+        freeNode(parent);
+        return;
+    }
+
+    if (nodes_[grandParent].child1 == parent) {
+        nodes_[grandParent].child1 = sibling;
+    } else {
+        nodes_[grandParent].child2 = sibling;
+    }
+    nodes_[sibling].parent = grandParent;
+    freeNode(parent);
+
+    refit(grandParent);
+}
+
+void DynamicAABBTree::refit(uint32_t idx) {
+    while (idx != NullNode) {
+        idx = balance(idx);
+
+        auto& node = nodes_[idx];
+        auto& child1 = nodes_[node.child1];
+        auto& child2 = nodes_[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.min = minOf(child1.min, child2.min);
+        node.max = maxOf(child1.max, child2.max);
+
+        idx = node.parent;
+    }
+}
+
+uint32_t DynamicAABBTree::balance(uint32_t a) {
+    auto& nodeA = nodes_[a];
+    if (nodeA.IsLeaf() || nodeA.height < 2) {
+        return a;
+    }
+
+    auto b = nodeA.child1;
+    auto c = nodeA.child2;
+    int diff = nodes_[c].height - nodes_[b].height;
+    if (diff >= -1 && diff <= 1) {
+        return a;
+    }
+
+    // rotate the higher child up, `a` becomes its child
+    auto up = diff > 1 ? c : b;
+    auto other = diff > 1 ? b : c;
+    auto& nodeUp = nodes_[up];
+    auto f = nodeUp.child1;
+    auto g = nodeUp.child2;
+
+    nodeUp.child1 = a;
+    nodeUp.parent = nodeA.parent;
+    nodeA.parent = up;
+
+    if (nodeUp.parent == NullNode) {
+        root_ = up;
+    } else if (nodes_[nodeUp.parent].child1 == a) {
+        nodes_[nodeUp.parent].child1 = up;
+    } else {
+        nodes_[nodeUp.parent].child2 = up;
+    }
+
+    // the higher grandchild stays under `up`, the lower one moves to `a`
+    auto keep = nodes_[f].height > nodes_[g].height ? f : g;
+    auto move = keep == f ? g : f;
+    nodeUp.child2 = keep;
+    if (diff > 1) {
+        nodeA.child2 = move;
+    } else {
+        nodeA.child1 = move;
+    }
+    nodes_[move].parent = a;
+
+    auto& nodeOther = nodes_[other];
+    auto& nodeMove = nodes_[move];
+    auto& nodeKeep = nodes_[keep];
+    nodeA.min = minOf(nodeOther.min, nodeMove.min);
+    nodeA.max = maxOf(nodeOther.max, nodeMove.max);
+    nodeA.height = 1 + std::max(nodeOther.height, nodeMove.height);
+    nodeUp.min = minOf(nodeA.min, nodeKeep.min);
+    nodeUp.max = maxOf(nodeA.max, nodeKeep.max);
+    nodeUp.height = 1 + std::max(nodeA.height, nodeKeep.height);
+
+    return up;
+}
+
+}  // namespace physics
+
+}  // namespace nickel
@@ -9,85 +9,570 @@ namespace nickel {
 
 namespace physics {
 
-void CirclesContact::Evaluate(const CollideShape& shape1,
-                              const CollideShape& shape2,
-                              Body* b1, Body* b2) {
-    Assert(shape1.shape->GetType() == Shape::Type::Circle &&
-               shape2.shape->GetType() == Shape::Type::Circle,
-           "evaluate circles contact need shapes are both circles");
+// rounded shapes closer than this are treated as touching by their cores
+constexpr Real CoreTouchTol = 0.1 * LinearSlop;
+
+/**
+ * @brief convex polygon rounded by radius, vertices are in body space
+ */
+struct ConvexView final {
+    const Vec2* pts;
+    int count;
+    Vec2 offset;                    // body position
+    Real radius = 0;
+    const Vec2* normals = nullptr;  // outward normals, computed if null
+    Real sign = 1;                  // -1 if vertices are clockwise
+
+    Vec2 Vertex(int i) const { return pts[i] + offset; }
+
+    int Next(int i) const { return i + 1 == count ? 0 : i + 1; }
+
+    /**
+     * @return zero vector if edge is degenerated
+     */
+    Vec2 Normal(int i) const {
+        if (normals) {
+            return normals[i];
+        }
+        auto edge = pts[Next(i)] - pts[i];
+        auto len = edge.Length();
+        if (len == 0) {
+            return {};
+        }
+        return Vec2{edge.y, -edge.x} * (sign / len);
+    }
+};
+
+/**
+ * @brief vertices and normals of OBB/capsule, avoid computing normals
+ */
+struct ConvexVertices final {
+    Vec2 pts[4];
+    Vec2 normals[4];
+    int count = 0;
+    Real radius = 0;
+
+    static ConvexVertices FromOBB(const geom2d::OBB<Real>& obb) {
+        auto [xAxis, yAxis] = obb.GetAxis();
+        auto x = xAxis * obb.halfLen.x;
+        auto y = yAxis * obb.halfLen.y;
+
+        ConvexVertices vertices;
+        vertices.count = 4;
+        vertices.pts[0] = obb.center - x - y;
+        vertices.pts[1] = obb.center + x - y;
+        vertices.pts[2] = obb.center + x + y;
+        vertices.pts[3] = obb.center - x + y;
+        vertices.normals[0] = -yAxis;
+        vertices.normals[1] = xAxis;
+        vertices.normals[2] = yAxis;
+        vertices.normals[3] = -xAxis;
+        return vertices;
+    }
+
+    static ConvexVertices FromCapsule(const geom2d::Capsule<Real>& capsule) {
+        auto& seg = capsule.seg;
+
+        ConvexVertices vertices;
+        vertices.count = 2;
+        vertices.radius = capsule.radius;
+        vertices.pts[0] = seg.p;
+        vertices.pts[1] = seg.p + seg.dir * seg.len;
+        vertices.normals[0] = Vec2{seg.dir.y, -seg.dir.x};
+        vertices.normals[1] = -vertices.normals[0];
+        return vertices;
+    }
+
+    ConvexView View(const Vec2& pos) const {
+        return {pts, count, pos, radius, normals, 1};
+    }
+};
+
+static ConvexView makePolygonView(const std::vector<Vec2>& pts,
+                                  const Vec2& pos) {
+    Real area = 0;
+    for (size_t i = 0; i < pts.size(); i++) {
+        area += pts[i].Cross(pts[(i + 1) % pts.size()]);
+    }
+    return {pts.data(), static_cast<int>(pts.size()), pos, 0, nullptr,
+            static_cast<Real>(area >= 0 ? 1 : -1)};
+}
+
+struct SegmentDistance final {
+    Vec2 closest1;
+    Vec2 closest2;
+    Real fraction1;  // in [0, 1], 0 and 1 mean closest1 is an end point
+    Real fraction2;
+    Real distSqrd;
+};
+
+/**
+ * @brief closest points between segment (p1, q1) and (p2, q2)
+ */
+static SegmentDistance segmentDistance(const Vec2& p1, const Vec2& q1,
+                                       const Vec2& p2, const Vec2& q2) {
+    auto d1 = q1 - p1;
+    auto d2 = q2 - p2;
+    auto r = p1 - p2;
+    Real a = d1.Dot(d1);
+    Real e = d2.Dot(d2);
+    Real f = d2.Dot(r);
+    Real s = 0, t = 0;
+
+    if (a == 0 && e != 0) {
+        t = std::clamp<Real>(f / e, 0, 1);
+    } else if (a != 0) {
+        Real c = d1.Dot(r);
+        if (e == 0) {
+            s = std::clamp<Real>(-c / a, 0, 1);
+        } else {
+            Real b = d1.Dot(d2);
+            Real denom = a * e - b * b;
+            // parallel segments pick any s, t is clamped later
+            if (denom != 0) {
+                s = std::clamp<Real>((b * f - c * e) / denom, 0, 1);
+            }
+            t = (b * s + f) / e;
+            if (t < 0) {
+                t = 0;
+                s = std::clamp<Real>(-c / a, 0, 1);
+            } else if (t > 1) {
+                t = 1;
+                s = std::clamp<Real>((b - c) / a, 0, 1);
+            }
+        }
+    }
+
+    SegmentDistance result;
+    result.closest1 = p1 + d1 * s;
+    result.closest2 = p2 + d2 * t;
+    result.fraction1 = s;
+    result.fraction2 = t;
+    result.distSqrd = (result.closest1 - result.closest2).LengthSqrd();
+    return result;
+}
+
+/**
+ * @brief max separation of poly2's vertices along poly1's face normals
+ * @param edge face of poly1 reaching the max, -1 if poly1 has no valid face
+ */
+static Real findMaxSeparation(const ConvexView& poly1,
+                              const ConvexView& poly2, int& edge) {
+    Real maxSeparation = std::numeric_limits<Real>::lowest();
+    edge = -1;
+    for (int i = 0; i < poly1.count; i++) {
+        auto normal = poly1.Normal(i);
+        if (normal == Vec2{}) {
+            continue;
+        }
+
+        auto v = poly1.Vertex(i);
+        Real separation = std::numeric_limits<Real>::max();
+        for (int j = 0; j < poly2.count; j++) {
+            separation =
+                std::min(separation, normal.Dot(poly2.Vertex(j) - v));
+        }
+
+        if (separation > maxSeparation) {
+            maxSeparation = separation;
+            edge = i;
+        }
+    }
+    return maxSeparation;
+}
+
+/**
+ * @brief id of a clipped point
+ * @param refEdge reference face
+ * @param vertex incident vertex the point comes from, or reference vertex
+ * whose side plane cut the incident face
+ * @param cut whether point is made by side plane
+ */
+static uint32_t makeFeatureID(int refEdge, int vertex, bool cut, bool flip) {
+    return static_cast<uint32_t>(refEdge) |
+           (static_cast<uint32_t>(vertex) << 8) |
+           (static_cast<uint32_t>(cut) << 16) |
+           (static_cast<uint32_t>(flip) << 17);
+}
+
+struct ClipVertex final {
+    Vec2 p;
+    uint32_t id;
+};
+
+/**
+ * @brief keep the part of segment where `normal.Dot(p) <= offset`
+ * @param id id of point made by cutting
+ * @return point count in `out`
+ */
+static int clipSegment(const ClipVertex (&in)[2], ClipVertex (&out)[2],
+                       const Vec2& normal, Real offset, uint32_t id) {
+    int count = 0;
+    Real dist0 = normal.Dot(in[0].p) - offset;
+    Real dist1 = normal.Dot(in[1].p) - offset;
+
+    if (dist0 <= 0) {
+        out[count++] = in[0];
+    }
+    if (dist1 <= 0) {
+        out[count++] = in[1];
+    }
+    if (dist0 * dist1 < 0) {
+        out[count++] = {
+            in[0].p + (in[1].p - in[0].p) * (dist0 / (dist0 - dist1)), id};
+    }
+    return count;
+}
+
+/**
+ * @brief SAT on face normals, then clip incident face against reference face
+ */
+static void collidePolygons(const ConvexView& poly1, const ConvexView& poly2,
+                            Manifold& manifold) {
+    manifold.pointCount = 0;
+    Real radius = poly1.radius + poly2.radius;
+
+    int edge1, edge2;
+    Real separation1 = findMaxSeparation(poly1, poly2, edge1);
+    if (edge1 < 0 || separation1 > radius) {
+        return;
+    }
+    Real separation2 = findMaxSeparation(poly2, poly1, edge2);
+    if (edge2 < 0 || separation2 > radius) {
+        return;
+    }
+
+    // prefer poly1 as reference, avoid reference face flipping between steps
+    bool flip = separation2 > separation1 + CoreTouchTol;
+    auto& ref = flip ? poly2 : poly1;
+    auto& inc = flip ? poly1 : poly2;
+    int refEdge = flip ? edge2 : edge1;
+    Real separation = flip ? separation2 : separation1;
+    auto normal = ref.Normal(refEdge);
+
+    // incident face is the most anti-parallel one
+    int incEdge = 0;
+    Real minDot = std::numeric_limits<Real>::max();
+    for (int i = 0; i < inc.count; i++) {
+        Real dot = inc.Normal(i).Dot(normal);
+        if (dot < minDot) {
+            minDot = dot;
+            incEdge = i;
+        }
+    }
+
+    auto v1 = ref.Vertex(refEdge);
+    auto v2 = ref.Vertex(ref.Next(refEdge));
+    int incNext = inc.Next(incEdge);
+    ClipVertex incident[2] = {
+        {inc.Vertex(incEdge), makeFeatureID(refEdge, incEdge, false, flip)},
+        {inc.Vertex(incNext), makeFeatureID(refEdge, incNext, false, flip)},
+    };
+
+    // rounded cores are apart, closest features may be two vertices and face
+    // normal is not the contact normal then
+    if (radius > 0 && separation > CoreTouchTol) {
+        auto dist =
+            segmentDistance(v1, v2, incident[0].p, incident[1].p);
+        bool isVertex1 = dist.fraction1 == 0 || dist.fraction1 == 1;
+        bool isVertex2 = dist.fraction2 == 0 || dist.fraction2 == 1;
+        if (isVertex1 && isVertex2) {
+            if (dist.distSqrd > radius * radius) {
+                return;
+            }
+            auto len = std::sqrt(dist.distSqrd);
+            auto dir = (dist.closest2 - dist.closest1) / len;
+            manifold.type = Manifold::Type::Circles;
+            manifold.pointCount = 1;
+            manifold.points[0] =
+                dist.closest1 + dir * ((ref.radius - inc.radius + len) * 0.5f);
+            manifold.ids[0] = 0;
+            manifold.normal = flip ? dir : -dir;
+            manifold.tangent = cgmath::PerpendicVec(manifold.normal);
+            manifold.depth = radius - len;
+            return;
+        }
+    }
 
-    init(shape1, shape2, b1, b2);
+    auto tangent = cgmath::Normalize(v2 - v1);
+    ClipVertex clipped1[2], clipped2[2];
+    if (clipSegment(incident, clipped1, -tangent, -tangent.Dot(v1) + radius,
+                    makeFeatureID(refEdge, refEdge, true, flip)) < 2) {
+        return;
+    }
+    if (clipSegment(clipped1, clipped2, tangent, tangent.Dot(v2) + radius,
+                    makeFeatureID(refEdge, ref.Next(refEdge), true, flip)) <
+        2) {
+        return;
+    }
 
-    auto& c1 = shape_cast<const CircleShape&>(*shape1.shape).shape;
-    auto& c2 = shape_cast<const CircleShape&>(*shape2.shape).shape;
+    manifold.depth = 0;
+    for (auto& [p, id] : clipped2) {
+        Real pointSeparation = normal.Dot(p - v1);
+        if (pointSeparation <= radius) {
+            // midway between two surfaces
+            manifold.ids[manifold.pointCount] = id;
+            manifold.points[manifold.pointCount++] =
+                p + normal * ((ref.radius - inc.radius - pointSeparation) *
+                              0.5f);
+            manifold.depth =
+                std::max(manifold.depth, radius - pointSeparation);
+        }
+    }
 
-    auto center1 = b1 ? c1.center + b1->pos : c1.center;
-    auto center2 = b2 ? c2.center + b2->pos : c2.center;
+    if (manifold.pointCount > 0) {
+        manifold.type = flip ? Manifold::Type::FaceB : Manifold::Type::FaceA;
+        manifold.normal = flip ? normal : -normal;
+        manifold.tangent = cgmath::PerpendicVec(manifold.normal);
+    }
+}
+
+static void collideCircles(const Vec2& center1, Real radius1,
+                           const Vec2& center2, Real radius2,
+                           Manifold& manifold) {
     auto v = center1 - center2;
     auto lenSqrd = v.LengthSqrd();
+    auto radius = radius1 + radius2;
 
-    if (lenSqrd >= (c1.radius + c2.radius) * (c1.radius + c2.radius)) {
-        manifold_.pointCount = 0;
+    if (lenSqrd >= radius * radius) {
+        manifold.pointCount = 0;
     } else {
-        manifold_.type = Manifold::Type::Circles;
-        manifold_.pointCount = 1;
-        manifold_.points[0] = center1;
+        manifold.type = Manifold::Type::Circles;
+        manifold.pointCount = 1;
+        manifold.points[0] = center1;
+        manifold.ids[0] = 0;
 
         if (lenSqrd == 0) {
-            manifold_.normal = Vec2{1, 0};
-            manifold_.depth = c1.radius;
+            manifold.normal = Vec2{1, 0};
+            manifold.depth = radius;
         } else {
             auto len = std::sqrt(lenSqrd);
-            manifold_.normal = v / len;
-            manifold_.depth = (c1.radius + c2.radius - len) * 0.5;
+            manifold.normal = v / len;
+            manifold.depth = radius - len;
         }
-        manifold_.tangent = cgmath::PerpendicVec(manifold_.normal);
+        manifold.tangent = cgmath::PerpendicVec(manifold.normal);
     }
 }
 
-void CircleAABBContact::Evaluate(const CollideShape& shape1,
-                                 const CollideShape& shape2,
-                                 Body* b1, Body* b2) {
-    Assert((shape1.shape->GetType() == Shape::Type::Circle &&
-            shape2.shape->GetType() == Shape::Type::OBB) ||
-           (shape1.shape->GetType() == Shape::Type::OBB &&
-            shape2.shape->GetType() == Shape::Type::Circle),
-           "evaluate circles contact need shapes are both circles");
+static void collideCirclePolygon(const Vec2& center, Real circleRadius,
+                                 const ConvexView& poly,
+                                 Manifold& manifold) {
+    manifold.pointCount = 0;
+    Real radius = circleRadius + poly.radius;
 
-    if (shape1.shape->GetType() == Shape::Type::OBB && shape2.shape->GetType() == Shape::Type::Circle) {
-        Evaluate(shape2, shape1, b2, b1);
+    int edge = -1;
+    Real separation = std::numeric_limits<Real>::lowest();
+    for (int i = 0; i < poly.count; i++) {
+        auto normal = poly.Normal(i);
+        if (normal == Vec2{}) {
+            continue;
+        }
+        Real s = normal.Dot(center - poly.Vertex(i));
+        if (s > radius) {
+            return;
+        }
+        if (s > separation) {
+            separation = s;
+            edge = i;
+        }
+    }
+    if (edge < 0) {
         return;
     }
 
-    init(shape1, shape2, b1, b2);
+    auto v1 = poly.Vertex(edge);
+    auto v2 = poly.Vertex(poly.Next(edge));
+    auto normal = poly.Normal(edge);
 
-    auto& c = shape_cast<const CircleShape&>(*shape1.shape).shape;
-    auto& obb = shape_cast<const OBBShape&>(*shape2.shape).shape;
-    auto cirCenter = b1 ? c.center + b1->pos: c.center;
+    // center is outside, it may be in vertex region
+    if (separation > 0) {
+        std::optional<Vec2> vertex;
+        if ((center - v1).Dot(v2 - v1) <= 0) {
+            vertex = v1;
+        } else if ((center - v2).Dot(v1 - v2) <= 0) {
+            vertex = v2;
+        }
 
-    Assert(obb.GetRotation() == 0, "currently we only support AABB");
+        if (vertex) {
+            auto v = center - vertex.value();
+            auto lenSqrd = v.LengthSqrd();
+            if (lenSqrd > radius * radius) {
+                return;
+            }
+            separation = std::sqrt(lenSqrd);
+            normal = v / separation;
+        }
+    }
 
-    auto aabb = geom2d::AABB<Real>::FromCenter(
-        b2 ? obb.center + b2->pos : obb.center, obb.halfLen);
-    auto p = geom2d::AABBEdgeNearestPt(aabb, cirCenter);
+    manifold.type = Manifold::Type::FaceB;
+    manifold.pointCount = 1;
+    manifold.points[0] = center - normal * (separation - poly.radius);
+    manifold.ids[0] = 0;
+    manifold.normal = normal;
+    manifold.tangent = cgmath::PerpendicVec(normal);
+    manifold.depth = radius - separation;
+}
 
-    auto v = cirCenter - p;
-    auto len = v.Length();
+void EvaluateCircles(const Shape& shape1, const Vec2& pos1,
+                     const Shape& shape2, const Vec2& pos2,
+                     Manifold& manifold) {
+    Assert(shape1.GetType() == Shape::Type::Circle &&
+               shape2.GetType() == Shape::Type::Circle,
+           "evaluate circles contact need shapes are both circles");
 
-    bool inner = geom::IsAABBContain(aabb, cirCenter);
+    auto& c1 = shape_cast<const CircleShape&>(shape1).shape;
+    auto& c2 = shape_cast<const CircleShape&>(shape2).shape;
 
-    if (len < c.radius) {
-        manifold_.type = Manifold::Type::FaceA;
-        manifold_.pointCount = 1;
-        manifold_.points[0] = p;
-        manifold_.depth = inner ? (p - cirCenter).Length() + c.radius : c.radius - len;
-        manifold_.normal = (inner ? -v : v) / len;
-        manifold_.tangent = cgmath::PerpendicVec(manifold_.normal);
-    } else {
-        manifold_.pointCount = 0;
+    collideCircles(c1.center + pos1, c1.radius, c2.center + pos2, c2.radius,
+                   manifold);
+}
+
+void EvaluateCircleOBB(const Shape& shape1, const Vec2& pos1,
+                       const Shape& shape2, const Vec2& pos2,
+                       Manifold& manifold) {
+    auto& c = shape_cast<const CircleShape&>(shape1).shape;
+    auto& obb = shape_cast<const OBBShape&>(shape2).shape;
+
+    auto vertices = ConvexVertices::FromOBB(obb);
+    collideCirclePolygon(c.center + pos1, c.radius, vertices.View(pos2),
+                         manifold);
+}
+
+void EvaluateCirclePolygon(const Shape& shape1, const Vec2& pos1,
+                           const Shape& shape2, const Vec2& pos2,
+                           Manifold& manifold) {
+    auto& c = shape_cast<const CircleShape&>(shape1).shape;
+    auto& pts = shape_cast<const PolygonShape&>(shape2).shape;
+
+    collideCirclePolygon(c.center + pos1, c.radius, makePolygonView(pts, pos2),
+                         manifold);
+}
+
+void EvaluateCircleCapsule(const Shape& shape1, const Vec2& pos1,
+                           const Shape& shape2, const Vec2& pos2,
+                           Manifold& manifold) {
+    auto& c = shape_cast<const CircleShape&>(shape1).shape;
+    auto& capsule = shape_cast<const CapsuleShape&>(shape2).shape;
+
+    auto center = c.center + pos1;
+    auto& seg = capsule.seg;
+    auto t = std::clamp<Real>((center - seg.p - pos2).Dot(seg.dir), 0,
+                              seg.len);
+    collideCircles(center, c.radius, seg.p + pos2 + seg.dir * t,
+                   capsule.radius, manifold);
+}
+
+void EvaluateOBBs(const Shape& shape1, const Vec2& pos1, const Shape& shape2,
+                  const Vec2& pos2, Manifold& manifold) {
+    auto& obb1 = shape_cast<const OBBShape&>(shape1).shape;
+    auto& obb2 = shape_cast<const OBBShape&>(shape2).shape;
+
+    auto vertices1 = ConvexVertices::FromOBB(obb1);
+    auto vertices2 = ConvexVertices::FromOBB(obb2);
+    collidePolygons(vertices1.View(pos1), vertices2.View(pos2), manifold);
+}
+
+void EvaluateOBBPolygon(const Shape& shape1, const Vec2& pos1,
+                        const Shape& shape2, const Vec2& pos2,
+                        Manifold& manifold) {
+    auto& obb = shape_cast<const OBBShape&>(shape1).shape;
+    auto& pts = shape_cast<const PolygonShape&>(shape2).shape;
+
+    auto vertices = ConvexVertices::FromOBB(obb);
+    collidePolygons(vertices.View(pos1), makePolygonView(pts, pos2),
+                    manifold);
+}
+
+void EvaluateOBBCapsule(const Shape& shape1, const Vec2& pos1,
+                        const Shape& shape2, const Vec2& pos2,
+                        Manifold& manifold) {
+    auto& obb = shape_cast<const OBBShape&>(shape1).shape;
+    auto& capsule = shape_cast<const CapsuleShape&>(shape2).shape;
+
+    auto vertices1 = ConvexVertices::FromOBB(obb);
+    auto vertices2 = ConvexVertices::FromCapsule(capsule);
+    collidePolygons(vertices1.View(pos1), vertices2.View(pos2), manifold);
+}
+
+void EvaluatePolygons(const Shape& shape1, const Vec2& pos1,
+                      const Shape& shape2, const Vec2& pos2,
+                      Manifold& manifold) {
+    auto& pts1 = shape_cast<const PolygonShape&>(shape1).shape;
+    auto& pts2 = shape_cast<const PolygonShape&>(shape2).shape;
+
+    collidePolygons(makePolygonView(pts1, pos1), makePolygonView(pts2, pos2),
+                    manifold);
+}
+
+void EvaluatePolygonCapsule(const Shape& shape1, const Vec2& pos1,
+                            const Shape& shape2, const Vec2& pos2,
+                            Manifold& manifold) {
+    auto& pts = shape_cast<const PolygonShape&>(shape1).shape;
+    auto& capsule = shape_cast<const CapsuleShape&>(shape2).shape;
+
+    auto vertices = ConvexVertices::FromCapsule(capsule);
+    collidePolygons(makePolygonView(pts, pos1), vertices.View(pos2),
+                    manifold);
+}
+
+void EvaluateCapsules(const Shape& shape1, const Vec2& pos1,
+                      const Shape& shape2, const Vec2& pos2,
+                      Manifold& manifold) {
+    auto& capsule1 = shape_cast<const CapsuleShape&>(shape1).shape;
+    auto& capsule2 = shape_cast<const CapsuleShape&>(shape2).shape;
+
+    auto vertices1 = ConvexVertices::FromCapsule(capsule1);
+    auto vertices2 = ConvexVertices::FromCapsule(capsule2);
+    auto p1 = vertices1.pts[0] + pos1, q1 = vertices1.pts[1] + pos1;
+    auto p2 = vertices2.pts[0] + pos2, q2 = vertices2.pts[1] + pos2;
+    Real radius = capsule1.radius + capsule2.radius;
+
+    manifold.pointCount = 0;
+    auto dist = segmentDistance(p1, q1, p2, q2);
+    if (dist.distSqrd >= radius * radius) {
+        return;
+    }
+
+    // cores cross each other, no closest points to follow
+    auto len = std::sqrt(dist.distSqrd);
+    if (len <= CoreTouchTol) {
+        collidePolygons(vertices1.View(pos1), vertices2.View(pos2), manifold);
+        return;
     }
+
+    manifold.normal = (dist.closest1 - dist.closest2) / len;
+    manifold.tangent = cgmath::PerpendicVec(manifold.normal);
+    manifold.depth = radius - len;
+
+    // parallel capsules lie on each other, use two ends of overlap
+    auto& dir1 = capsule1.seg.dir;
+    if (std::abs(dir1.Cross(capsule2.seg.dir)) < 0.005f &&
+        capsule1.seg.len > 0) {
+        auto len1 = capsule1.seg.len;
+        auto s1 = std::clamp<Real>((p2 - p1).Dot(dir1), 0, len1);
+        auto s2 = std::clamp<Real>((q2 - p1).Dot(dir1), 0, len1);
+        if (std::abs(s1 - s2) > CoreTouchTol) {
+            auto offset =
+                manifold.normal * (capsule1.radius - manifold.depth * 0.5f);
+            manifold.type = Manifold::Type::FaceA;
+            manifold.pointCount = 2;
+            manifold.points[0] = p1 + dir1 * s1 - offset;
+            manifold.points[1] = p1 + dir1 * s2 - offset;
+            // points follow two ends of capsule2
+            manifold.ids[0] = 1;
+            manifold.ids[1] = 2;
+            return;
+        }
+    }
+
+    manifold.type = Manifold::Type::Circles;
+    manifold.pointCount = 1;
+    manifold.points[0] =
+        dist.closest2 +
+        manifold.normal * (capsule2.radius - manifold.depth * 0.5f);
+    manifold.ids[0] = 0;
 }
 
 }  // namespace physics
 
-}  // namespace nickel
\ No newline at end of file
+}  // namespace nickel
@@ -6,29 +6,78 @@ namespace nickel {
 
 namespace physics {
 
+using EvaluateFn = void (*)(const Shape&, const Vec2&, const Shape&,
+                            const Vec2&, Manifold&);
 
-std::unique_ptr<Contact> ManifoldSolver::GetContact(const CollideShape& shape1, const CollideShape& shape2, bool shouldRecurse) {
-    auto& s1 = *shape1.shape;
-    auto& s2 = *shape2.shape;
-    auto type1 = s1.GetType();
-    auto type2 = s2.GetType();
-
-    if (type1 == Shape::Type::Circle) {
-        if (type2 == Shape::Type::Circle) {
-            return std::make_unique<CirclesContact>();
-        } else if (type2 == Shape::Type::OBB) {
-            return std::make_unique<CircleAABBContact>();
+/**
+ * @brief evaluate in swapped order, then flip the result back
+ */
+template <EvaluateFn Fn>
+void evaluateSwapped(const Shape& shape1, const Vec2& pos1,
+                     const Shape& shape2, const Vec2& pos2,
+                     Manifold& manifold) {
+    Fn(shape2, pos2, shape1, pos1, manifold);
+    if (manifold.pointCount > 0) {
+        manifold.normal = -manifold.normal;
+        manifold.tangent = -manifold.tangent;
+        if (manifold.type == Manifold::Type::FaceA) {
+            manifold.type = Manifold::Type::FaceB;
+        } else if (manifold.type == Manifold::Type::FaceB) {
+            manifold.type = Manifold::Type::FaceA;
         }
-        // TODO: not finish
     }
+}
+
+constexpr size_t ShapeTypeCount = 4;
+
+static_assert(static_cast<size_t>(Shape::Type::Capsule) + 1 == ShapeTypeCount,
+              "shape type changed, update evaluate table");
+
+// indexed by [shape1 type][shape2 type], generators only accept shapes in
+// the order of `Shape::Type`, lower half evaluates in swapped order
+// clang-format off
+constexpr EvaluateFn EvaluateTable[ShapeTypeCount][ShapeTypeCount] = {
+    // Circle
+    {EvaluateCircles,
+     EvaluateCircleOBB,
+     EvaluateCirclePolygon,
+     EvaluateCircleCapsule},
+    // OBB
+    {evaluateSwapped<EvaluateCircleOBB>,
+     EvaluateOBBs,
+     EvaluateOBBPolygon,
+     EvaluateOBBCapsule},
+    // Polygon
+    {evaluateSwapped<EvaluateCirclePolygon>,
+     evaluateSwapped<EvaluateOBBPolygon>,
+     EvaluatePolygons,
+     EvaluatePolygonCapsule},
+    // Capsule
+    {evaluateSwapped<EvaluateCircleCapsule>,
+     evaluateSwapped<EvaluateOBBCapsule>,
+     evaluateSwapped<EvaluatePolygonCapsule>,
+     EvaluateCapsules},
+};
+// clang-format on
 
-    if (shouldRecurse) {
-        return GetContact(shape2, shape1, false);
+bool ManifoldSolver::GetContact(const CollideShape& shape1, const Vec2& pos1,
+                                const CollideShape& shape2, const Vec2& pos2,
+                                Manifold& manifold) const {
+    auto& s1 = *shape1.shape;
+    auto& s2 = *shape2.shape;
+
+    manifold.pointCount = 0;
+
+    auto type1 = static_cast<size_t>(s1.GetType());
+    auto type2 = static_cast<size_t>(s2.GetType());
+    if (type1 >= ShapeTypeCount || type2 >= ShapeTypeCount) {
+        return false;
     }
 
-    return nullptr;
+    EvaluateTable[type1][type2](s1, pos1, s2, pos2, manifold);
+    return true;
 }
 
 }
 
-}
\ No newline at end of file
+}
@@ -5,14 +5,22 @@ namespace nickel {
 namespace physics {
 
 void PhysicSolver::Step(Real interval, Body& body) {
-    body.acc = body.force * interval;
+    IntegrateVelocity(interval, body);
+    IntegratePosition(interval, body);
+}
+
+void PhysicSolver::IntegrateVelocity(Real interval, Body& body) {
+    body.acc = body.force * body.massInv;
     body.vel += body.acc * interval;
 
     if (body.vel.LengthSqrd() > maxSpeed_ * maxSpeed_) {
         body.vel = cgmath::Normalize(body.vel) * maxSpeed_;
     }
+}
 
-    body.pos += body.vel * interval + 0.5 * body.acc * interval * interval;
+void PhysicSolver::IntegratePosition(Real interval, Body& body) {
+    body.prevPos = body.pos;
+    body.pos += body.vel * interval;
 
     body.force = Vec2{0, 0};
 }
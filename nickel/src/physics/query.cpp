@@ -0,0 +1,295 @@
+#include "physics/query.hpp"
+#include "physics/world.hpp"
+
+namespace nickel {
+
+namespace physics {
+
+// shape cast stops at this distance, so the cast shape doesn't touch target
+constexpr Real ShapeCastTol = 0.1 * LinearSlop;
+constexpr int MaxShapeCastIteration = 20;
+
+static std::optional<RaycastHit> raycastCircle(const Vec2& center,
+                                               Real radius, const Vec2& from,
+                                               const Vec2& to,
+                                               Real maxFraction) {
+    auto d = to - from;
+    auto m = from - center;
+    Real c = m.LengthSqrd() - radius * radius;
+    Real a = d.LengthSqrd();
+    // start inside circle
+    if (c <= 0 || a == 0) {
+        return std::nullopt;
+    }
+
+    Real b = m.Dot(d);
+    Real discriminant = b * b - a * c;
+    if (discriminant < 0) {
+        return std::nullopt;
+    }
+
+    Real t = (-b - std::sqrt(discriminant)) / a;
+    if (t < 0 || t > maxFraction) {
+        return std::nullopt;
+    }
+
+    RaycastHit hit;
+    hit.fraction = t;
+    hit.point = from + d * t;
+    hit.normal = (hit.point - center) / radius;
+    return hit;
+}
+
+/**
+ * @brief slab test in box's frame
+ */
+static std::optional<RaycastHit> raycastBox(const Vec2& center,
+                                            const Vec2& xAxis,
+                                            const Vec2& yAxis,
+                                            const Vec2& halfLen,
+                                            const Vec2& from, const Vec2& to,
+                                            Real maxFraction) {
+    auto d = to - from;
+    auto m = from - center;
+    Vec2 axes[2] = {xAxis, yAxis};
+    Real lower = 0, upper = maxFraction;
+    int enterAxis = -1;
+    Real enterSign = 0;
+
+    for (int i = 0; i < 2; i++) {
+        Real p = m.Dot(axes[i]);
+        Real v = d.Dot(axes[i]);
+        Real h = i == 0 ? halfLen.x : halfLen.y;
+        if (v == 0) {
+            if (std::abs(p) > h) {
+                return std::nullopt;
+            }
+            continue;
+        }
+
+        // enter from negative face first if ray goes along axis
+        Real t1 = (-h - p) / v;
+        Real t2 = (h - p) / v;
+        Real sign = -1;
+        if (t1 > t2) {
+            std::swap(t1, t2);
+            sign = 1;
+        }
+        if (t1 > lower) {
+            lower = t1;
+            enterAxis = i;
+            enterSign = sign;
+        }
+        upper = std::min(upper, t2);
+        if (lower > upper) {
+            return std::nullopt;
+        }
+    }
+
+    // start inside box
+    if (enterAxis < 0) {
+        return std::nullopt;
+    }
+
+    RaycastHit hit;
+    hit.fraction = lower;
+    hit.point = from + d * lower;
+    hit.normal = axes[enterAxis] * enterSign;
+    return hit;
+}
+
+static std::optional<RaycastHit> raycastPolygon(const std::vector<Vec2>& pts,
+                                                const Vec2& pos,
+                                                const Vec2& from,
+                                                const Vec2& to,
+                                                Real maxFraction) {
+    if (pts.size() < 3) {
+        return std::nullopt;
+    }
+
+    Real area = 0;
+    for (size_t i = 0; i < pts.size(); i++) {
+        area += pts[i].Cross(pts[(i + 1) % pts.size()]);
+    }
+    Real sign = area >= 0 ? 1 : -1;
+
+    // clip ray by half planes of edges
+    auto d = to - from;
+    Real lower = 0, upper = maxFraction;
+    Vec2 normal;
+    bool entered = false;
+    for (size_t i = 0; i < pts.size(); i++) {
+        auto v = pts[i] + pos;
+        auto edge = pts[(i + 1) % pts.size()] - pts[i];
+        Vec2 n = Vec2{edge.y, -edge.x} * sign;
+        Real numerator = n.Dot(v - from);
+        Real denominator = n.Dot(d);
+
+        if (denominator == 0) {
+            if (numerator < 0) {
+                return std::nullopt;
+            }
+        } else if (denominator < 0 && numerator < lower * denominator) {
+            lower = numerator / denominator;
+            normal = n;
+            entered = true;
+        } else if (denominator > 0 && numerator < upper * denominator) {
+            upper = numerator / denominator;
+        }
+
+        if (upper < lower) {
+            return std::nullopt;
+        }
+    }
+
+    // start inside polygon
+    if (!entered) {
+        return std::nullopt;
+    }
+
+    RaycastHit hit;
+    hit.fraction = lower;
+    hit.point = from + d * lower;
+    hit.normal = cgmath::Normalize(normal);
+    return hit;
+}
+
+/**
+ * @brief capsule is a box between two circles
+ */
+static std::optional<RaycastHit> raycastCapsule(
+    const geom2d::Capsule<Real>& capsule, const Vec2& pos, const Vec2& from,
+    const Vec2& to, Real maxFraction) {
+    auto& seg = capsule.seg;
+    auto p = seg.p + pos;
+    auto q = p + seg.dir * seg.len;
+    auto radius = capsule.radius;
+
+    auto t = std::clamp<Real>((from - p).Dot(seg.dir), 0, seg.len);
+    if ((from - p - seg.dir * t).LengthSqrd() <= radius * radius) {
+        return std::nullopt;
+    }
+
+    std::optional<RaycastHit> result;
+    auto take = [&](std::optional<RaycastHit> hit) {
+        if (hit) {
+            maxFraction = hit->fraction;
+            result = hit;
+        }
+    };
+    take(raycastCircle(p, radius, from, to, maxFraction));
+    take(raycastCircle(q, radius, from, to, maxFraction));
+    take(raycastBox((p + q) * 0.5f, seg.dir, cgmath::PerpendicVec(seg.dir),
+                    Vec2{seg.len * 0.5f, radius}, from, to, maxFraction));
+    return result;
+}
+
+std::optional<RaycastHit> RaycastShape(const Shape& shape, const Vec2& pos,
+                                       const Vec2& from, const Vec2& to,
+                                       Real maxFraction) {
+    switch (shape.GetType()) {
+        case Shape::Type::Circle: {
+            auto& c = shape_cast<const CircleShape&>(shape).shape;
+            return raycastCircle(c.center + pos, c.radius, from, to,
+                                 maxFraction);
+        }
+        case Shape::Type::OBB: {
+            auto& obb = shape_cast<const OBBShape&>(shape).shape;
+            auto [xAxis, yAxis] = obb.GetAxis();
+            return raycastBox(obb.center + pos, xAxis, yAxis, obb.halfLen,
+                              from, to, maxFraction);
+        }
+        case Shape::Type::Polygon:
+            return raycastPolygon(shape_cast<const PolygonShape&>(shape).shape,
+                                  pos, from, to, maxFraction);
+        case Shape::Type::Capsule:
+            return raycastCapsule(shape_cast<const CapsuleShape&>(shape).shape,
+                                  pos, from, to, maxFraction);
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief call `f` with shape converted to GJK support shape in world space
+ */
+template <typename F>
+auto visitSupportShape(const Shape& shape, const Vec2& pos, F&& f) {
+    switch (shape.GetType()) {
+        case Shape::Type::Circle: {
+            auto& c = shape_cast<const CircleShape&>(shape).shape;
+            return f(geom2d::Circle<Real>::Create(c.center + pos, c.radius));
+        }
+        case Shape::Type::OBB: {
+            auto obb = shape_cast<const OBBShape&>(shape).shape;
+            obb.center += pos;
+            return f(obb);
+        }
+        case Shape::Type::Capsule: {
+            auto capsule = shape_cast<const CapsuleShape&>(shape).shape;
+            capsule.seg.p += pos;
+            return f(capsule);
+        }
+        case Shape::Type::Polygon:
+        default:
+            return f(geom2d::Translated<geom2d::PolygonView<Real>>{
+                shape_cast<const PolygonShape&>(shape).shape, pos});
+    }
+}
+
+static bool isEmptyPolygon(const Shape& shape) {
+    return shape.GetType() == Shape::Type::Polygon &&
+           shape_cast<const PolygonShape&>(shape).shape.empty();
+}
+
+std::optional<RaycastHit> ShapeCast(const Shape& shape, const Vec2& from,
+                                    const Vec2& to, const Shape& target,
+                                    const Vec2& targetPos, Real maxFraction) {
+    if (isEmptyPolygon(shape) || isEmptyPolygon(target)) {
+        return std::nullopt;
+    }
+
+    auto d = to - from;
+
+    // conservative advancement: move by the distance which is sure to not
+    // pass through target, until close enough
+    return visitSupportShape(
+        target, targetPos,
+        [&](const auto& targetShape) -> std::optional<RaycastHit> {
+            RaycastHit hit;
+            hit.fraction = 0;
+            hit.point = from;
+            for (int i = 0; i < MaxShapeCastIteration; i++) {
+                auto closest = visitSupportShape(
+                    shape, from + d * hit.fraction, [&](const auto& s) {
+                        return geom2d::GjkClosestPt(s, targetShape);
+                    });
+                // overlapped at start
+                if (!closest) {
+                    return hit;
+                }
+
+                hit.point = closest->pt2;
+                hit.normal = (closest->pt1 - closest->pt2) / closest->distance;
+                if (closest->distance <= ShapeCastTol) {
+                    return hit;
+                }
+
+                Real approach = -d.Dot(hit.normal);
+                if (approach <= 0) {
+                    return std::nullopt;
+                }
+                hit.fraction +=
+                    (closest->distance - ShapeCastTol * 0.5f) / approach;
+                if (hit.fraction > maxFraction) {
+                    return std::nullopt;
+                }
+            }
+
+            // slowly converged(e.g. sliding along curve), already close
+            return hit;
+        });
+}
+
+}  // namespace physics
+
+}  // namespace nickel
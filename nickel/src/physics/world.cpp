@@ -1,93 +1,808 @@
 #include "physics/world.hpp"
 #include "gecs/entity/querier.hpp"
+#include <cmath>
+#include <numeric>
 
 namespace nickel {
 
 namespace physics {
 
-void World::collide(Real interval,
-                    gecs::querier<gecs::mut<Body>, CollideShape> bodies) {
-    std::vector<std::vector<std::unique_ptr<Contact>>> contacts;
+World::World(BroadPhase::Type broadPhase)
+    : broadPhase_{BroadPhase::Create(broadPhase)},
+      ownPool_{std::make_unique<JobPool>(0)},
+      jobPool_{ownPool_.get()} {}
 
-    for (auto it1 = bodies.begin(); it1 != bodies.end(); it1++) {
-        auto& b1 = std::get<1>(*it1);
-        auto& s1 = std::get<2>(*it1);
-        contacts.emplace_back();
-        for (auto it2 = it1 + 1; it2 != bodies.end(); it2++) {
-            auto& b2 = std::get<1>(*it2);
-            auto& s2 = std::get<2>(*it2);
+void World::SetWorkerCount(uint32_t count) {
+    if (count != ownPool_->WorkerCount()) {
+        ownPool_ = std::make_unique<JobPool>(count);
+    }
+    jobPool_ = ownPool_.get();
+}
 
-            auto contact = manifoldSolver_.GetContact(s1, s2);
-            contact->Evaluate(s1, s2, &b1, &b2);
-            contacts.back().push_back(std::move(contact));
-        }
+void World::SetJobPool(JobPool* pool) {
+    jobPool_ = pool ? pool : ownPool_.get();
+}
+
+void World::SetBroadPhase(BroadPhase::Type type) {
+    if (type != broadPhase_->GetType()) {
+        broadPhase_ = BroadPhase::Create(type);
     }
+}
 
-    // handle contacts
-    for (auto& contactList : contacts) {
-        for (auto& contact : contactList) {
-            auto& manifold = contact->GetManifold();
-            if (manifold.pointCount == 0) {
-                continue;
-            }
+void World::SetVelocityIterations(int iterations) {
+    Assert(iterations > 0, "velocity iterations must > 0");
+    velocityIterations_ = iterations;
+}
+
+void World::EnableWarmStarting(bool enable) {
+    warmStarting_ = enable;
+    if (!enable) {
+        contactCache_.Clear();
+    }
+}
+
+void World::EnableSleeping(bool enable) {
+    sleepingEnabled_ = enable;
+}
 
-            // handle contacts
-            auto b1 = contact->GetBody1();
-            auto b2 = contact->GetBody2();
-            Vec2 mtv;
-            dealContact(manifold, *b1, *b2);
-        }
-    }
-}
-
-void World::dealContact(const Manifold& manifold, Body& b1, Body& b2,
-                        bool shouldRecurse) {
-    auto mtv = manifold.normal * manifold.depth;
-    if (b1.type == Body::Type::Dynamic) {
-        switch (b2.type) {
-            case Body::Type::Static: {
-                auto j = -(1 + std::min(b1.restitution, b2.restitution)) *
-                         b1.vel.Dot(manifold.normal) / (b1.massInv * 2.0);
-                b1.pos += mtv;
-                b1.vel = b1.vel.Dot(manifold.tangent) * manifold.tangent;
-                b1.vel += j * b1.massInv * manifold.normal;
-            } break;
-            case Body::Type::Dynamic: {
-                auto j = -(1 + std::min(b1.restitution, b2.restitution)) *
-                         (b1.vel - b2.vel).Dot(manifold.normal) /
-                         (b1.massInv + b2.massInv);
-
-                b1.pos += mtv * 0.5;
-                b2.pos -= mtv * 0.5;
-
-                b1.vel = b1.vel.Dot(manifold.tangent) * manifold.tangent;
-                b2.vel = b2.vel.Dot(manifold.tangent) * manifold.tangent;
-
-                b1.vel += j * b1.massInv * manifold.normal;
-                b2.vel -= j * b2.massInv * manifold.normal;
-            } break;
+void World::SetFixedInterval(Real interval) {
+    Assert(interval > 0, "fixed interval must > 0");
+    fixedInterval_ = interval;
+}
+
+void World::SetMaxSubSteps(int steps) {
+    Assert(steps > 0, "max sub steps must > 0");
+    maxSubSteps_ = steps;
+}
+
+void World::updateActive() {
+    active_.resize(bodies_.size());
+    for (size_t i = 0; i < bodies_.size(); i++) {
+        auto& body = *bodies_[i].body;
+        switch (body.type) {
+            case Body::Type::Static:
+                // moved by user, don't interpolate from old place
+                body.prevPos = body.pos;
+                active_[i] = false;
+                break;
             case Body::Type::Kinematic:
-                // b1.pos += mtv;
+                active_[i] = body.vel != Vec2{};
+                break;
+            case Body::Type::Dynamic:
+                // changed by user since fall asleep
+                if (body.sleeping &&
+                    (!sleepingEnabled_ || body.force != Vec2{} ||
+                     body.vel != Vec2{} || body.pos != body.prevPos)) {
+                    body.WakeUp();
+                }
+                // woken here or by user
+                if (!body.sleeping && body.sleepIsland != 0) {
+                    wokenIslands_.push_back(body.sleepIsland);
+                    body.sleepIsland = 0;
+                }
+                active_[i] = !body.sleeping;
                 break;
         }
-    } else if (shouldRecurse) {
-        Manifold newManifold = manifold;
-        newManifold.normal = -newManifold.normal;
-        dealContact(newManifold, b2, b1, false);
+    }
+    wakeIslands();
+}
+
+bool World::wakeIslands() {
+    if (wokenIslands_.empty()) {
+        return false;
+    }
+
+    // bodies of a sleeping island don't find pairs between themselves, wake
+    // them all at once instead of one layer per step
+    std::sort(wokenIslands_.begin(), wokenIslands_.end());
+    for (size_t i = 0; i < bodies_.size(); i++) {
+        auto& body = *bodies_[i].body;
+        if (body.sleeping &&
+            std::binary_search(wokenIslands_.begin(), wokenIslands_.end(),
+                               body.sleepIsland)) {
+            body.WakeUp();
+            body.sleepIsland = 0;
+            active_[i] = true;
+        }
+    }
+    wokenIslands_.clear();
+    return true;
+}
+
+void World::collide() {
+    contacts_.clear();
+
+    // nothing moves, no new contact
+    if (std::find(active_.begin(), active_.end(), true) == active_.end()) {
+        pairs_.clear();
+        return;
+    }
+
+    bounds_.clear();
+    for (auto& ref : bodies_) {
+        auto aabb = GetShapeAABB(*ref.shape->shape, ref.body->pos);
+        aabb.halfLen += Vec2{AABBMargin, AABBMargin};
+        bounds_.push_back(aabb);
+    }
+
+    broadPhase_->FindPairs(bounds_, active_, pairs_);
+
+    // touched sleeping bodies wake with their islands in this step
+    for (auto& pair : pairs_) {
+        auto& body1 = *bodies_[pair.first].body;
+        auto& body2 = *bodies_[pair.second].body;
+        if (body1.sleeping && body1.sleepIsland != 0 &&
+            active_[pair.second]) {
+            wokenIslands_.push_back(body1.sleepIsland);
+        } else if (body2.sleeping && body2.sleepIsland != 0 &&
+                   active_[pair.first]) {
+            wokenIslands_.push_back(body2.sleepIsland);
+        }
+    }
+    if (wakeIslands()) {
+        broadPhase_->FindPairs(bounds_, active_, pairs_);
+    }
+
+    for (auto& pair : pairs_) {
+        auto& ref1 = bodies_[pair.first];
+        auto& ref2 = bodies_[pair.second];
+
+        // no one can be pushed, e.g. kinematic body passing static body
+        if (ref1.body->GetCollideMassInv() == 0 &&
+            ref2.body->GetCollideMassInv() == 0) {
+            continue;
+        }
+
+        Contact contact;
+        if (manifoldSolver_.GetContact(*ref1.shape, ref1.body->pos,
+                                       *ref2.shape, ref2.body->pos,
+                                       contact.manifold) &&
+            contact.manifold.pointCount > 0) {
+            contact.body1 = pair.first;
+            contact.body2 = pair.second;
+            contact.key = MakeBodyPairKey(ref1.id, ref2.id);
+            contacts_.push_back(contact);
+        }
+    }
+
+    // solve in key order, so result won't depend on iteration order of ECS
+    std::sort(contacts_.begin(), contacts_.end(),
+              [](const Contact& c1, const Contact& c2) {
+                  return c1.key < c2.key;
+              });
+
+    if (warmStarting_) {
+        contactCache_.Restore(contacts_);
+    }
+}
+
+void World::buildIslands() {
+    auto count = static_cast<uint32_t>(bodies_.size());
+
+    islandParent_.resize(count);
+    std::iota(islandParent_.begin(), islandParent_.end(), 0);
+
+    auto find = [&](uint32_t i) {
+        while (islandParent_[i] != i) {
+            islandParent_[i] = islandParent_[islandParent_[i]];
+            i = islandParent_[i];
+        }
+        return i;
+    };
+
+    // link by fattened bounds instead of contacts, resting bodies with a
+    // tiny gap stay in one island and won't fall asleep one by one.
+    // Static and kinematic bodies are never pushed, they don't link islands
+    for (auto& pair : pairs_) {
+        if (bodies_[pair.first].body->GetCollideMassInv() > 0 &&
+            bodies_[pair.second].body->GetCollideMassInv() > 0) {
+            auto root1 = find(pair.first);
+            auto root2 = find(pair.second);
+            // keep smaller index as root so island order is stable
+            if (root1 < root2) {
+                islandParent_[root2] = root1;
+            } else if (root2 < root1) {
+                islandParent_[root1] = root2;
+            }
+        }
+    }
+
+    // number islands by their first body
+    islandOfBody_.assign(count, NoIsland);
+    islandBodyStart_.reserve(count + 1);
+    islandBodyStart_.assign(1, 0);
+    for (uint32_t i = 0; i < count; i++) {
+        if (bodies_[i].body->GetCollideMassInv() == 0) {
+            continue;
+        }
+        auto root = find(i);
+        if (root == i) {
+            islandOfBody_[i] = static_cast<uint32_t>(islandBodyStart_.size() - 1);
+            islandBodyStart_.push_back(0);
+        } else {
+            islandOfBody_[i] = islandOfBody_[root];
+        }
+        islandBodyStart_[islandOfBody_[i] + 1]++;
+    }
+
+    auto islandCount = islandBodyStart_.size() - 1;
+    islandContactStart_.reserve(count + 1);
+    islandContactStart_.assign(islandCount + 1, 0);
+    for (auto& contact : contacts_) {
+        auto island = islandOfBody_[contact.body1] != NoIsland
+                          ? islandOfBody_[contact.body1]
+                          : islandOfBody_[contact.body2];
+        if (island != NoIsland) {
+            islandContactStart_[island + 1]++;
+        }
+    }
+
+    for (size_t i = 0; i < islandCount; i++) {
+        islandBodyStart_[i + 1] += islandBodyStart_[i];
+        islandContactStart_[i + 1] += islandContactStart_[i];
+    }
+
+    // counting sort keeps bodies in index order and contacts in key order
+    islandBodies_.resize(islandBodyStart_.back());
+    islandContacts_.resize(islandContactStart_.back());
+    // borrow parent array as write cursor, it is useless now
+    std::copy(islandBodyStart_.begin(), islandBodyStart_.end() - 1,
+              islandParent_.begin());
+    for (uint32_t i = 0; i < count; i++) {
+        if (islandOfBody_[i] != NoIsland) {
+            islandBodies_[islandParent_[islandOfBody_[i]]++] = i;
+        }
+    }
+    std::copy(islandContactStart_.begin(), islandContactStart_.end() - 1,
+              islandParent_.begin());
+    for (uint32_t i = 0; i < contacts_.size(); i++) {
+        auto& contact = contacts_[i];
+        auto island = islandOfBody_[contact.body1] != NoIsland
+                          ? islandOfBody_[contact.body1]
+                          : islandOfBody_[contact.body2];
+        if (island != NoIsland) {
+            islandContacts_[islandParent_[island]++] = i;
+        }
+    }
+
+    // island with any active body is awake, touched sleeping bodies wake up
+    awakeIslands_.reserve(count);
+    awakeIslands_.clear();
+    for (uint32_t island = 0; island < islandCount; island++) {
+        bool awake = false;
+        for (auto i = islandBodyStart_[island];
+             i < islandBodyStart_[island + 1] && !awake; i++) {
+            awake = active_[islandBodies_[i]];
+        }
+        for (auto i = islandContactStart_[island];
+             i < islandContactStart_[island + 1] && !awake; i++) {
+            auto& contact = contacts_[islandContacts_[i]];
+            awake = active_[contact.body1] || active_[contact.body2];
+        }
+        if (!awake) {
+            continue;
+        }
+
+        awakeIslands_.push_back(island);
+        for (auto i = islandBodyStart_[island];
+             i < islandBodyStart_[island + 1]; i++) {
+            auto& body = *bodies_[islandBodies_[i]].body;
+            if (body.sleeping) {
+                body.WakeUp();
+            }
+        }
+    }
+}
+
+void World::solveIsland(size_t island, Real interval) {
+    auto bodyBegin = islandBodyStart_[island];
+    auto bodyEnd = islandBodyStart_[island + 1];
+    auto contactBegin = islandContactStart_[island];
+    auto contactEnd = islandContactStart_[island + 1];
+
+    for (auto i = bodyBegin; i < bodyEnd; i++) {
+        physicSolver_.IntegrateVelocity(interval,
+                                        *bodies_[islandBodies_[i]].body);
+    }
+
+    // restitution needs velocity before any impulse, so prepare all
+    // contacts before warm starting
+    for (auto i = contactBegin; i < contactEnd; i++) {
+        prepareContact(contacts_[islandContacts_[i]], interval);
+    }
+    if (warmStarting_) {
+        for (auto i = contactBegin; i < contactEnd; i++) {
+            warmStartContact(contacts_[islandContacts_[i]]);
+        }
+    }
+    for (int iter = 0; iter < velocityIterations_; iter++) {
+        for (auto i = contactBegin; i < contactEnd; i++) {
+            solveContact(contacts_[islandContacts_[i]]);
+        }
+    }
+
+    for (auto i = bodyBegin; i < bodyEnd; i++) {
+        physicSolver_.IntegratePosition(interval,
+                                        *bodies_[islandBodies_[i]].body);
+    }
+
+    if (!sleepingEnabled_) {
+        return;
+    }
+
+    // island sleeps as a whole, or a sleeping body would be pushed by
+    // its awake neighbors
+    Real minSleepTime = std::numeric_limits<Real>::max();
+    for (auto i = bodyBegin; i < bodyEnd; i++) {
+        auto& body = *bodies_[islandBodies_[i]].body;
+        if (body.vel.LengthSqrd() >
+            LinearSleepTolerance * LinearSleepTolerance) {
+            body.sleepTime = 0;
+        } else {
+            body.sleepTime += interval;
+        }
+        minSleepTime = std::min(minSleepTime, body.sleepTime);
+    }
+
+    // can't sleep on a moving kinematic body
+    for (auto i = contactBegin; i < contactEnd && minSleepTime > 0; i++) {
+        auto& contact = contacts_[islandContacts_[i]];
+        auto& b1 = *bodies_[contact.body1].body;
+        auto& b2 = *bodies_[contact.body2].body;
+        if ((b1.type == Body::Type::Kinematic && b1.vel != Vec2{}) ||
+            (b2.type == Body::Type::Kinematic && b2.vel != Vec2{})) {
+            minSleepTime = 0;
+        }
+    }
+
+    if (minSleepTime < TimeToSleep) {
+        return;
+    }
+
+    auto sleepIsland = bodies_[islandBodies_[bodyBegin]].id + 1;
+    for (auto i = bodyBegin; i < bodyEnd; i++) {
+        auto& body = *bodies_[islandBodies_[i]].body;
+        body.sleeping = true;
+        body.sleepIsland = sleepIsland;
+        body.vel = Vec2{};
+        body.acc = Vec2{};
+        body.prevPos = body.pos;
+    }
+}
+
+// static and kinematic bodies may be shared by islands on other threads, so
+// never write them even with zero mass
+static void applyImpulse(Body& body, Real massInv, const Vec2& p) {
+    if (massInv > 0) {
+        body.vel += massInv * p;
+    }
+}
+
+void World::prepareContact(Contact& contact, Real interval) {
+    auto& b1 = *bodies_[contact.body1].body;
+    auto& b2 = *bodies_[contact.body2].body;
+    auto& manifold = contact.manifold;
+    auto massInv1 = b1.GetCollideMassInv();
+    auto massInv2 = b2.GetCollideMassInv();
+
+    auto kNormal = massInv1 + massInv2;
+    contact.normalMass = kNormal > 0 ? 1.0 / kNormal : 0;
+    contact.tangentMass = contact.normalMass;
+    contact.friction = std::sqrt(b1.friction * b2.friction);
+
+    auto restitution = std::min(b1.restitution, b2.restitution);
+    auto vn = (b1.vel - b2.vel).Dot(manifold.normal);
+
+    for (int i = 0; i < manifold.pointCount; i++) {
+        // push bodies apart by velocity instead of moving position
+        auto bias = Baumgarte / interval *
+                    std::max<Real>(manifold.depth - LinearSlop, 0);
+        if (vn < -RestitutionThreshold) {
+            bias = std::max<Real>(bias, -restitution * vn);
+        }
+        contact.bias[i] = bias;
+    }
+
+    if (!warmStarting_) {
+        for (int i = 0; i < manifold.pointCount; i++) {
+            contact.normalImpulse[i] = 0;
+            contact.tangentImpulse[i] = 0;
+        }
+    }
+}
+
+void World::warmStartContact(Contact& contact) {
+    auto& b1 = *bodies_[contact.body1].body;
+    auto& b2 = *bodies_[contact.body2].body;
+    auto& manifold = contact.manifold;
+    auto massInv1 = b1.GetCollideMassInv();
+    auto massInv2 = b2.GetCollideMassInv();
+
+    for (int i = 0; i < manifold.pointCount; i++) {
+        auto p = contact.normalImpulse[i] * manifold.normal +
+                 contact.tangentImpulse[i] * manifold.tangent;
+        applyImpulse(b1, massInv1, p);
+        applyImpulse(b2, massInv2, -p);
+    }
+}
+
+void World::solveContact(Contact& contact) {
+    if (contact.normalMass == 0) {
+        return;
+    }
+
+    auto& b1 = *bodies_[contact.body1].body;
+    auto& b2 = *bodies_[contact.body2].body;
+    auto& manifold = contact.manifold;
+    auto massInv1 = b1.GetCollideMassInv();
+    auto massInv2 = b2.GetCollideMassInv();
+
+    for (int i = 0; i < manifold.pointCount; i++) {
+        // friction, clamped by current normal impulse
+        auto vt = (b1.vel - b2.vel).Dot(manifold.tangent);
+        auto maxFriction = contact.friction * contact.normalImpulse[i];
+        auto oldTangent = contact.tangentImpulse[i];
+        contact.tangentImpulse[i] =
+            std::clamp<Real>(oldTangent - contact.tangentMass * vt,
+                             -maxFriction, maxFriction);
+        auto pt = (contact.tangentImpulse[i] - oldTangent) * manifold.tangent;
+        applyImpulse(b1, massInv1, pt);
+        applyImpulse(b2, massInv2, -pt);
+
+        // normal, accumulated impulse must keep pushing
+        auto vn = (b1.vel - b2.vel).Dot(manifold.normal);
+        auto oldNormal = contact.normalImpulse[i];
+        contact.normalImpulse[i] = std::max<Real>(
+            oldNormal + contact.normalMass * (contact.bias[i] - vn), 0);
+        auto pn = (contact.normalImpulse[i] - oldNormal) * manifold.normal;
+        applyImpulse(b1, massInv1, pn);
+        applyImpulse(b2, massInv2, -pn);
     }
 }
 
 void World::Step(Real interval,
                  gecs::querier<gecs::mut<Body>, CollideShape> querier) {
-    for (auto&& [_, body, shape] : querier) {
-        physicSolver_.Step(interval, body);
+    bodies_.clear();
+    for (auto&& [entity, body, shape] : querier) {
+        bodies_.push_back({static_cast<uint32_t>(entity), &body, &shape});
+    }
+    step(interval);
+}
+
+int World::Update(Real elapsed,
+                  gecs::querier<gecs::mut<Body>, CollideShape> querier) {
+    accumulator_ += elapsed;
+
+    int steps = 0;
+    while (accumulator_ >= fixedInterval_ && steps < maxSubSteps_) {
+        Step(fixedInterval_, querier);
+        accumulator_ -= fixedInterval_;
+        steps++;
+    }
+
+    // too slow to catch up, drop the rest instead of spiraling
+    if (accumulator_ >= fixedInterval_) {
+        accumulator_ = std::fmod(accumulator_, fixedInterval_);
+    }
+
+    return steps;
+}
+
+void World::Step(Real interval, std::vector<Body>& bodies,
+                 const std::vector<CollideShape>& shapes) {
+    Assert(bodies.size() == shapes.size(), "bodies and shapes not paired");
+
+    bodies_.clear();
+    for (size_t i = 0; i < bodies.size(); i++) {
+        bodies_.push_back(
+            {static_cast<uint32_t>(i), &bodies[i], &shapes[i]});
+    }
+    step(interval);
+}
+
+void World::step(Real interval) {
+    updateActive();
+    // may wake touched bodies, so forces are applied after it
+    collide();
+
+    for (size_t i = 0; i < bodies_.size(); i++) {
+        if (active_[i] && bodies_[i].body->type == Body::Type::Dynamic) {
+            for (auto& forceGen : forceGenerators) {
+                forceGen(*bodies_[i].body);
+            }
+        }
     }
-    collide(interval, querier);
-    for (auto&& [_, body, shape] : querier) {
-        physicSolver_.Step(interval, body);
+
+    buildIslands();
+
+    // kinematic bodies are never pushed, move them on this thread so
+    // islands can read them without race
+    for (uint32_t i = 0; i < bodies_.size(); i++) {
+        if (bodies_[i].body->type == Body::Type::Kinematic) {
+            physicSolver_.IntegrateVelocity(interval, *bodies_[i].body);
+        }
     }
+
+    jobPool_->ParallelFor(awakeIslands_.size(), [&](size_t i) {
+        solveIsland(awakeIslands_[i], interval);
+    });
+
+    if (warmStarting_) {
+        storeContacts();
+    }
+
+    for (uint32_t i = 0; i < bodies_.size(); i++) {
+        if (bodies_[i].body->type == Body::Type::Kinematic) {
+            physicSolver_.IntegratePosition(interval, *bodies_[i].body);
+        }
+    }
+
+    updateIndex();
+}
+
+void World::storeContacts() {
+    // nothing moved, cache is still valid
+    if (std::find(active_.begin(), active_.end(), true) == active_.end()) {
+        return;
+    }
+
+    activeIds_.clear();
+    for (size_t i = 0; i < bodies_.size(); i++) {
+        if (active_[i]) {
+            activeIds_.push_back(bodies_[i].id);
+        }
+    }
+    std::sort(activeIds_.begin(), activeIds_.end());
+
+    // resting pairs are not collided, keep them for the time they wake up.
+    // Bodies left the world are not indexed any more
+    auto isResting = [&](uint32_t id) {
+        return !std::binary_search(activeIds_.begin(), activeIds_.end(), id) &&
+               proxyOfBody_.count(id) > 0;
+    };
+    contactCache_.Store(contacts_, [&](uint64_t key) {
+        return isResting(static_cast<uint32_t>(key >> 32)) &&
+               isResting(static_cast<uint32_t>(key));
+    });
+}
+
+const Shape& World::IndexedBody::GetShape() const {
+    auto ptr = std::visit(
+        [](auto& s) -> const Shape* {
+            if constexpr (std::is_same_v<std::decay_t<decltype(s)>,
+                                         std::monostate>) {
+                return nullptr;
+            } else {
+                return &s;
+            }
+        },
+        shape);
+    Assert(ptr, "body is not in spatial index");
+    return *ptr;
+}
+
+template <typename T, typename Variant>
+static void copyShape(const Shape& src, Variant& dst) {
+    auto& s = shape_cast<const T&>(src);
+    if (auto ptr = std::get_if<T>(&dst); ptr) {
+        // assign in place, polygon reuses its memory
+        *ptr = s;
+    } else {
+        dst = s;
+    }
+}
+
+// shapes are plain data edited in place, so a resting body compares its
+// snapshot with the live shape instead of trusting the shape pointer
+template <typename Variant>
+static bool isSameShape(const Shape& src, const Variant& dst) {
+    switch (src.GetType()) {
+        case Shape::Type::Circle: {
+            auto& s = shape_cast<const CircleShape&>(src).shape;
+            auto ptr = std::get_if<CircleShape>(&dst);
+            return ptr && ptr->shape.center == s.center &&
+                   ptr->shape.radius == s.radius;
+        }
+        case Shape::Type::OBB: {
+            auto& s = shape_cast<const OBBShape&>(src).shape;
+            auto ptr = std::get_if<OBBShape>(&dst);
+            return ptr && ptr->shape.center == s.center &&
+                   ptr->shape.halfLen == s.halfLen &&
+                   ptr->shape.GetRotation() == s.GetRotation();
+        }
+        case Shape::Type::Polygon: {
+            auto ptr = std::get_if<PolygonShape>(&dst);
+            return ptr &&
+                   ptr->shape == shape_cast<const PolygonShape&>(src).shape;
+        }
+        case Shape::Type::Capsule: {
+            auto& s = shape_cast<const CapsuleShape&>(src).shape;
+            auto ptr = std::get_if<CapsuleShape>(&dst);
+            return ptr && ptr->shape.seg.p == s.seg.p &&
+                   ptr->shape.seg.dir == s.seg.dir &&
+                   ptr->shape.seg.len == s.seg.len &&
+                   ptr->shape.radius == s.radius;
+        }
+    }
+    return false;
+}
+
+void World::updateIndex() {
+    stepCount_++;
+
+    for (size_t i = 0; i < bodies_.size(); i++) {
+        auto& ref = bodies_[i];
+        auto& shape = *ref.shape->shape;
+
+        bool inOrder = i < proxyOrder_.size() &&
+                       indexedBodies_[proxyOrder_[i]].id == ref.id &&
+                       indexedBodies_[proxyOrder_[i]].stamp + 1 == stepCount_;
+
+        // resting body not moved nor reshaped(e.g. resized static platform),
+        // snapshot and fat AABB are still current
+        if (inOrder && !active_[i]) {
+            auto& indexed = indexedBodies_[proxyOrder_[i]];
+            if (indexed.pos == ref.body->pos && indexed.source == &shape &&
+                isSameShape(shape, indexed.shape)) {
+                indexed.stamp = stepCount_;
+                continue;
+            }
+        }
+
+        auto aabb = GetShapeAABB(shape, ref.body->pos);
+        uint32_t proxy;
+        if (inOrder) {
+            proxy = proxyOrder_[i];
+            index_.MoveProxy(proxy, aabb, ref.body->pos - ref.body->prevPos);
+        } else if (auto it = proxyOfBody_.find(ref.id);
+                   it != proxyOfBody_.end()) {
+            proxy = it->second;
+            index_.MoveProxy(proxy, aabb, ref.body->pos - ref.body->prevPos);
+        } else {
+            proxy = index_.CreateProxy(aabb, ref.id);
+            proxyOfBody_.emplace(ref.id, proxy);
+            if (indexedBodies_.size() < index_.ProxyCapacity()) {
+                indexedBodies_.resize(index_.ProxyCapacity());
+            }
+        }
+
+        if (i < proxyOrder_.size()) {
+            proxyOrder_[i] = proxy;
+        } else {
+            proxyOrder_.push_back(proxy);
+        }
+
+        auto& indexed = indexedBodies_[proxy];
+        indexed.stamp = stepCount_;
+        indexed.id = ref.id;
+        indexed.pos = ref.body->pos;
+        indexed.aabb = aabb;
+        indexed.source = &shape;
+        switch (shape.GetType()) {
+            case Shape::Type::Circle:
+                copyShape<CircleShape>(shape, indexed.shape);
+                break;
+            case Shape::Type::OBB:
+                copyShape<OBBShape>(shape, indexed.shape);
+                break;
+            case Shape::Type::Polygon:
+                copyShape<PolygonShape>(shape, indexed.shape);
+                break;
+            case Shape::Type::Capsule:
+                copyShape<CapsuleShape>(shape, indexed.shape);
+                break;
+        }
+    }
+    proxyOrder_.resize(bodies_.size());
+
+    // every indexed body is stepped, nothing to drop
+    if (proxyOfBody_.size() == bodies_.size()) {
+        return;
+    }
+
+    // drop bodies not stepped this time(destroyed or removed by user)
+    for (auto it = proxyOfBody_.begin(); it != proxyOfBody_.end();) {
+        auto& indexed = indexedBodies_[it->second];
+        if (indexed.stamp != stepCount_) {
+            indexed.shape = std::monostate{};
+            index_.DestroyProxy(it->second);
+            it = proxyOfBody_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::optional<RaycastHit> World::Raycast(const Vec2& from,
+                                         const Vec2& to) const {
+    std::optional<RaycastHit> result;
+    index_.Raycast(from, to, [&](uint32_t proxy, Real maxFraction) {
+        auto& indexed = indexedBodies_[proxy];
+        auto hit = RaycastShape(indexed.GetShape(), indexed.pos, from, to,
+                                maxFraction);
+        if (!hit) {
+            return maxFraction;
+        }
+        hit->id = indexed.id;
+        result = hit;
+        return hit->fraction;
+    });
+    return result;
+}
+
+void World::Raycast(const std::vector<RaycastInput>& rays,
+                    std::vector<std::optional<RaycastHit>>& hits) const {
+    hits.resize(rays.size());
+    jobPool_->ParallelFor(rays.size(), [&](size_t i) {
+        hits[i] = Raycast(rays[i].from, rays[i].to);
+    });
+}
+
+void World::QueryAABB(const AABB& aabb, std::vector<uint32_t>& ids) const {
+    ids.clear();
+    index_.Query(aabb, [&](uint32_t proxy) {
+        auto& indexed = indexedBodies_[proxy];
+        if (geom::IsAABBIntersect(indexed.aabb, aabb)) {
+            ids.push_back(indexed.id);
+        }
+        return true;
+    });
+}
+
+void World::QueryAABB(const std::vector<AABB>& aabbs,
+                      std::vector<uint32_t>& ids,
+                      std::vector<uint32_t>& offsets) const {
+    ids.clear();
+    offsets.resize(aabbs.size() + 1);
+    for (size_t i = 0; i < aabbs.size(); i++) {
+        offsets[i] = static_cast<uint32_t>(ids.size());
+        index_.Query(aabbs[i], [&](uint32_t proxy) {
+            auto& indexed = indexedBodies_[proxy];
+            if (geom::IsAABBIntersect(indexed.aabb, aabbs[i])) {
+                ids.push_back(indexed.id);
+            }
+            return true;
+        });
+    }
+    offsets.back() = static_cast<uint32_t>(ids.size());
+}
+
+std::optional<RaycastHit> World::ShapeCast(const Shape& shape,
+                                           const Vec2& from, const Vec2& to,
+                                           uint32_t ignore) const {
+    auto begin = GetShapeAABB(shape, from);
+    auto end = GetShapeAABB(shape, to);
+    auto swept = AABB::FromMinMax(
+        Vec2{std::min(begin.center.x - begin.halfLen.x,
+                      end.center.x - end.halfLen.x),
+             std::min(begin.center.y - begin.halfLen.y,
+                      end.center.y - end.halfLen.y)},
+        Vec2{std::max(begin.center.x + begin.halfLen.x,
+                      end.center.x + end.halfLen.x),
+             std::max(begin.center.y + begin.halfLen.y,
+                      end.center.y + end.halfLen.y)});
+
+    std::optional<RaycastHit> result;
+    index_.Query(swept, [&](uint32_t proxy) {
+        auto& indexed = indexedBodies_[proxy];
+        if (indexed.id == ignore ||
+            !geom::IsAABBIntersect(indexed.aabb, swept)) {
+            return true;
+        }
+
+        auto hit =
+            physics::ShapeCast(shape, from, to, indexed.GetShape(),
+                               indexed.pos,
+                               result ? result->fraction : Real{1});
+        if (hit && (!result || hit->fraction < result->fraction)) {
+            hit->id = indexed.id;
+            result = hit;
+        }
+        return true;
+    });
+    return result;
 }
 
 }  // namespace physics
 
-}  // namespace nickel
\ No newline at end of file
+}  // namespace nickel
@@ -286,7 +286,7 @@ void deserializeGlobalTransform(const toml::node& node,
     Assert(node.is_table(), "serialize GlobalTransform require table");
 
     mirrow::drefl::try_cast<GlobalTransform>(elem)->mat =
-        cgmath::Mat44::Identity();
+        cgmath::Affine2D::Identity();
 }
 
 void registGlobalTransformSerd() {
@@ -15,6 +15,11 @@ int initRuntime(int argc, char** argv) {
     // _CrtSetReportMode(_CRT_WARN, _CRTDBG_MODE_FILE);
     // _CrtSetReportFile(_CRT_WARN, _CRTDBG_FILE_STDERR);
     InitProfile("nickelengine.profile");
+#ifndef __EMSCRIPTEN__
+    // logs are written by a background thread, logging in hot loops won't
+    // block on IO
+    logger::LoggerMgr::Instance().EnableAsync();
+#endif
 
     LOGI(log_tag::Nickel, "Running dir: ", std::filesystem::current_path(),
          ". Full path: ", argv[0]);
@@ -0,0 +1,122 @@
+#include "script/bytecode_cache.hpp"
+
+#include "Luau/Bytecode.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace nickel {
+
+constexpr std::array<char, 4> BytecodeCacheMagic = {'N', 'K', 'B', 'C'};
+// bump when cache file layout changes. Luau bytecode version is part of
+// options hash, so upgrading luau invalidates caches by itself
+constexpr uint32_t BytecodeCacheVersion = 1;
+
+struct BytecodeCacheHeader final {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t optionsHash;
+    uint64_t size;
+};
+
+// FNV-1a
+constexpr uint64_t HashOffset = 14695981039346656037ull;
+constexpr uint64_t HashPrime = 1099511628211ull;
+
+static uint64_t hashBytes(const void* data, size_t size,
+                          uint64_t hash = HashOffset) {
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * HashPrime;
+    }
+    return hash;
+}
+
+uint64_t ScriptCompileOptions::Hash() const {
+    int luauVersion = LBC_VERSION_TARGET;
+    auto hash = hashBytes(&BytecodeCacheVersion, sizeof(BytecodeCacheVersion));
+    hash = hashBytes(&luauVersion, sizeof(luauVersion), hash);
+    hash = hashBytes(&optimizationLevel, sizeof(optimizationLevel), hash);
+    return hashBytes(&debugLevel, sizeof(debugLevel), hash);
+}
+
+std::filesystem::path GetBytecodeCachePath(
+    const std::filesystem::path& script) {
+    auto path = script;
+    path += BytecodeCacheExtension;
+    return path;
+}
+
+uint64_t HashScriptSource(std::string_view source) {
+    return hashBytes(source.data(), source.size());
+}
+
+std::optional<std::string> ReadBytecodeCache(
+    const std::filesystem::path& cacheFile, uint64_t sourceHash,
+    const ScriptCompileOptions& options) {
+    std::ifstream file(cacheFile, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    BytecodeCacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != BytecodeCacheMagic ||
+        header.version != BytecodeCacheVersion ||
+        header.sourceHash != sourceHash ||
+        header.optionsHash != options.Hash() || header.size == 0) {
+        return std::nullopt;
+    }
+
+    std::error_code err;
+    auto fileSize = std::filesystem::file_size(cacheFile, err);
+    if (err || fileSize != sizeof(header) + header.size) {
+        return std::nullopt;
+    }
+
+    std::string bytecode(header.size, '\0');
+    if (!file.read(bytecode.data(), bytecode.size())) {
+        return std::nullopt;
+    }
+    return bytecode;
+}
+
+bool WriteBytecodeCache(const std::filesystem::path& cacheFile,
+                        uint64_t sourceHash,
+                        const ScriptCompileOptions& options,
+                        std::string_view bytecode) {
+    BytecodeCacheHeader header;
+    header.magic = BytecodeCacheMagic;
+    header.version = BytecodeCacheVersion;
+    header.sourceHash = sourceHash;
+    header.optionsHash = options.Hash();
+    header.size = bytecode.size();
+
+    auto tmpFile = cacheFile;
+    tmpFile += ".tmp";
+    {
+        std::ofstream file(tmpFile, std::ios::binary | std::ios::trunc);
+        if (!file ||
+            !file.write(reinterpret_cast<const char*>(&header),
+                        sizeof(header)) ||
+            !file.write(bytecode.data(), bytecode.size())) {
+            file.close();
+            std::error_code err;
+            std::filesystem::remove(tmpFile, err);
+            return false;
+        }
+    }
+
+    std::error_code err;
+    std::filesystem::rename(tmpFile, cacheFile, err);
+    if (err) {
+        std::filesystem::remove(tmpFile, err);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace nickel
@@ -21,6 +21,7 @@ namespace nickel {
     } while (0)
 
 LuaScript LuaScript::Null;
+ScriptCompileOptions LuaScript::CompileOptions;
 
 template <>
 std::unique_ptr<LuaScript> LoadAssetFromMetaTable(const toml::table& path) {
@@ -30,11 +31,65 @@ std::unique_ptr<LuaScript> LoadAssetFromMetaTable(const toml::table& path) {
     return nullptr;
 }
 
+static const char* errorMessage(lua_State* L) {
+    auto msg = lua_tostring(L, -1);
+    return msg ? msg : "unknown error";
+}
+
+static uint64_t newRevision() {
+    static uint64_t revision = 0;
+    return ++revision;
+}
+
+/**
+ * @brief take bytecode from cache file if source is unchanged, otherwise
+ * compile script and update cache
+ * @param compiled set to true if script was compiled
+ * @param useCache false to always compile, e.g. cached bytecode is rejected
+ */
+static std::optional<std::string> loadBytecode(
+    const std::filesystem::path& path, bool* compiled = nullptr,
+    bool useCache = true) {
+    auto codes = ReadWholeFile<std::string>(path);
+    if (!codes) {
+        LOGE(log_tag::Script, "read script ", path, " failed");
+        return std::nullopt;
+    }
+
+    auto& options = LuaScript::CompileOptions;
+    auto sourceHash = HashScriptSource(*codes);
+    auto cacheFile = GetBytecodeCachePath(path);
+    if (useCache) {
+        if (auto bytecode = ReadBytecodeCache(cacheFile, sourceHash, options);
+            bytecode) {
+            return bytecode;
+        }
+    }
+
+    lua_CompileOptions compileOptions{};
+    compileOptions.optimizationLevel = options.optimizationLevel;
+    compileOptions.debugLevel = options.debugLevel;
+
+    size_t bytecodeSize = 0;
+    char* data = luau_compile(codes->c_str(), codes->size(), &compileOptions,
+                              &bytecodeSize);
+    std::string bytecode(data, bytecodeSize);
+    free(data);
+    if (compiled) {
+        *compiled = true;
+    }
+
+    // compile error is encoded as a zero byte followed by message, it is
+    // reported when loaded and not cached
+    if (!bytecode.empty() && bytecode[0] != 0 &&
+        !WriteBytecodeCache(cacheFile, sourceHash, options, bytecode)) {
+        LOGW(log_tag::Script, "write bytecode cache ", cacheFile, " failed");
+    }
+    return bytecode;
+}
+
 LuaScript::LuaScript(const std::filesystem::path& libname) : Asset(libname) {
-    state_ = luaL_newstate();
-    luaL_openlibs(state_);
     load(libname);
-    BindLua(state_);
 }
 
 LuaScript::~LuaScript() {
@@ -43,6 +98,21 @@ LuaScript::~LuaScript() {
     }
 }
 
+void LuaScript::createState() {
+    state_ = luaL_newstate();
+    luaL_openlibs(state_);
+    BindLua(state_);
+
+    if (!loadChunk(state_)) {
+        LOGE(log_tag::Script, "load script ", RelativePath(), " failed: ",
+             errorMessage(state_));
+        lua_pop(state_, 1);
+    } else if (lua_pcall(state_, 0, 0, 0) != LUA_OK) {
+        LOGE(log_tag::Script, errorMessage(state_));
+        lua_pop(state_, 1);
+    }
+}
+
 void LuaScript::OnInit(gecs::entity ent) const {
     if (!state_) {
         return;
@@ -74,22 +144,39 @@ void LuaScript::OnDestroy(gecs::entity) const {
 }
 
 void LuaScript::load(const std::filesystem::path& path) {
-    size_t bytecodeSize = 0;
-    auto filename = path.string();
-    auto codes = ReadWholeFile<std::string>(path);
-    if (codes) {
-        char* bytecode =
-            luau_compile(codes->c_str(), codes->size(), NULL, &bytecodeSize);
-        int result =
-            luau_load(state_, filename.c_str(), bytecode, bytecodeSize, 0);
-        free(bytecode);
-
-        if (result != LUA_OK) {
-            LOGE(log_tag::Script, "load script ", path, "failed");
-        } else {
-            lua_pcall(state_, 0, 0, 0);
-        }
+    bool compiled = false;
+    if (auto bytecode = loadBytecode(path, &compiled); bytecode) {
+        bytecode_ = std::move(*bytecode);
+        revision_ = newRevision();
+        fromCache_ = !compiled;
+    }
+}
+
+bool LuaScript::loadChunk(lua_State* L) {
+    auto chunkname = RelativePath().string();
+    if (luau_load(L, chunkname.c_str(), bytecode_.data(), bytecode_.size(),
+                  0) == LUA_OK) {
+        return true;
+    }
+    if (!fromCache_) {
+        return false;
     }
+
+    // cache written by another luau build may still match, compile again
+    // and overwrite it
+    LOGW(log_tag::Script, "cached bytecode of ", RelativePath(),
+         " is rejected: ", errorMessage(L), ", recompiling");
+    lua_pop(L, 1);
+    fromCache_ = false;
+    auto bytecode = loadBytecode(RelativePath(), nullptr, false);
+    if (!bytecode) {
+        lua_pushstring(L, "recompile failed");
+        return false;
+    }
+    bytecode_ = std::move(*bytecode);
+    revision_ = newRevision();
+    return luau_load(L, chunkname.c_str(), bytecode_.data(), bytecode_.size(),
+                     0) == LUA_OK;
 }
 
 toml::table LuaScript::Save2Toml() const {
@@ -98,6 +185,23 @@ toml::table LuaScript::Save2Toml() const {
     return tbl;
 }
 
+ScriptManager::ScriptManager(Mode mode) : mode_{mode} {
+    if (mode_ == Mode::Shared) {
+        vm_ = luaL_newstate();
+        luaL_openlibs(vm_);
+        BindLua(vm_);
+        // globals and libraries become read-only, scripts write into their
+        // own environments
+        luaL_sandbox(vm_);
+    }
+}
+
+ScriptManager::~ScriptManager() {
+    if (vm_) {
+        lua_close(vm_);
+    }
+}
+
 ScriptHandle ScriptManager::Load(const std::filesystem::path& path) {
     auto data = std::make_unique<LuaScript>(path);
     if (data) {
@@ -108,26 +212,243 @@ ScriptHandle ScriptManager::Load(const std::filesystem::path& path) {
     return ScriptHandle::Null();
 }
 
+size_t ScriptManager::Precompile(const std::filesystem::path& dir) {
+    size_t count = 0;
+    std::error_code err;
+    std::filesystem::recursive_directory_iterator it(dir, err), end;
+    for (; !err && it != end; it.increment(err)) {
+        std::error_code fileErr;
+        if (!it->is_regular_file(fileErr) ||
+            DetectFileType(it->path()) != FileType::Script) {
+            continue;
+        }
+        bool compiled = false;
+        if (loadBytecode(it->path(), &compiled) && compiled) {
+            count++;
+        }
+    }
+    if (err) {
+        LOGW(log_tag::Script, "precompile scripts in ", dir,
+             " failed: ", err.message());
+    }
+    return count;
+}
+
+size_t ScriptManager::InstanceCount() const {
+    size_t count = 0;
+    for (auto& [_, batch] : batches_) {
+        count += batch.instances.size();
+    }
+    return count;
+}
+
+void ScriptManager::call(int ref, gecs::entity entity, bool passEntity) {
+    if (ref == NoRef) {
+        return;
+    }
+
+    lua_getref(vm_, ref);
+    if (passEntity) {
+        lua_pushunsigned(
+            vm_, static_cast<unsigned>(
+                     std::underlying_type_t<gecs::entity>(entity)));
+    }
+    if (lua_pcall(vm_, passEntity ? 1 : 0, 0, 0) != LUA_OK) {
+        LOGE(log_tag::Script, errorMessage(vm_));
+        lua_pop(vm_, 1);
+    }
+}
+
+void ScriptManager::prepareInstance(ScriptHandle handle, LuaScript& script,
+                                    gecs::entity entity, Script& component) {
+    auto& batch = batches_[handle];
+    auto entityID = std::underlying_type_t<gecs::entity>(entity);
+
+    // reloaded, run the new code in fresh environments
+    if (batch.revision != script.revision_) {
+        releaseBatch(batch);
+        if (!script.loadChunk(vm_)) {
+            LOGE(log_tag::Script, "load script ", script.RelativePath(),
+                 " failed: ", errorMessage(vm_));
+            lua_pop(vm_, 1);
+        } else {
+            batch.chunk = lua_ref(vm_, -1);
+            lua_pop(vm_, 1);
+        }
+        // after loading, recompiling bumps revision
+        batch.revision = script.revision_;
+    }
+
+    if (component.instance < batch.instances.size() &&
+        batch.instances[component.instance].entity == entity) {
+        batch.instances[component.instance].stamp = frame_;
+        return;
+    }
+    if (auto it = batch.indexOfEntity.find(entityID);
+        it != batch.indexOfEntity.end()) {
+        component.instance = it->second;
+        batch.instances[it->second].stamp = frame_;
+        return;
+    }
+
+    auto index = static_cast<uint32_t>(batch.instances.size());
+    auto& instance = batch.instances.emplace_back();
+    instance.entity = entity;
+    instance.stamp = frame_;
+    batch.indexOfEntity.emplace(entityID, index);
+    component.instance = index;
+    if (batch.chunk == NoRef) {
+        return;
+    }
+
+    // env of entity, reads fall back to the read-only globals
+    lua_newtable(vm_);
+    lua_newtable(vm_);
+    lua_pushvalue(vm_, LUA_GLOBALSINDEX);
+    lua_setfield(vm_, -2, "__index");
+    lua_setreadonly(vm_, -1, true);
+    lua_setmetatable(vm_, -2);
+    lua_setsafeenv(vm_, -1, true);
+
+    // run chunk in env, so functions it defines are bound to env
+    lua_getref(vm_, batch.chunk);
+    lua_pushvalue(vm_, -2);
+    lua_setfenv(vm_, -2);
+    if (lua_pcall(vm_, 0, 0, 0) != LUA_OK) {
+        LOGE(log_tag::Script, errorMessage(vm_));
+        lua_pop(vm_, 1);
+    }
+
+    auto resolve = [this](const char* name) {
+        int ref = NoRef;
+        lua_pushstring(vm_, name);
+        lua_rawget(vm_, -2);
+        if (lua_isfunction(vm_, -1)) {
+            ref = lua_ref(vm_, -1);
+        }
+        lua_pop(vm_, 1);
+        return ref;
+    };
+    instance.onInit = resolve("on_init");
+    instance.onUpdate = resolve("on_update");
+    instance.onQuit = resolve("on_quit");
+    instance.env = lua_ref(vm_, -1);
+    lua_pop(vm_, 1);
+}
+
+void ScriptManager::releaseInstance(Batch& batch, uint32_t index) {
+    auto& instance = batch.instances[index];
+    call(instance.onQuit, instance.entity, false);
+    for (int ref : {instance.env, instance.onInit, instance.onUpdate,
+                    instance.onQuit}) {
+        if (ref != NoRef) {
+            lua_unref(vm_, ref);
+        }
+    }
+
+    batch.indexOfEntity.erase(
+        std::underlying_type_t<gecs::entity>(instance.entity));
+    if (index + 1 != batch.instances.size()) {
+        instance = batch.instances.back();
+        batch.indexOfEntity[std::underlying_type_t<gecs::entity>(
+            instance.entity)] = index;
+    }
+    batch.instances.pop_back();
+}
+
+void ScriptManager::releaseBatch(Batch& batch) {
+    while (!batch.instances.empty()) {
+        releaseInstance(batch,
+                        static_cast<uint32_t>(batch.instances.size() - 1));
+    }
+    if (batch.chunk != NoRef) {
+        lua_unref(vm_, batch.chunk);
+        batch.chunk = NoRef;
+    }
+}
+
+void ScriptManager::updateBatches() {
+    for (auto it = batches_.begin(); it != batches_.end();) {
+        auto& batch = it->second;
+        // call one script for all its entities in a row
+        for (size_t i = 0; i < batch.instances.size(); i++) {
+            auto& instance = batch.instances[i];
+            if (instance.stamp != frame_) {
+                continue;
+            }
+            if (!instance.inited) {
+                instance.inited = true;
+                call(instance.onInit, instance.entity, true);
+            }
+            call(instance.onUpdate, instance.entity, true);
+        }
+
+        // entity destroyed or uses another script now
+        for (size_t i = batch.instances.size(); i > 0; i--) {
+            if (batch.instances[i - 1].stamp != frame_) {
+                releaseInstance(batch, static_cast<uint32_t>(i - 1));
+            }
+        }
+
+        if (batch.instances.empty() && !Has(it->first)) {
+            releaseBatch(batch);
+            it = batches_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void ScriptUpdateSystem(gecs::querier<gecs::mut<Script>> scripts,
                         gecs::resource<gecs::mut<ScriptManager>> mgr) {
+    if (mgr->mode_ == ScriptManager::Mode::Isolated) {
+        for (auto&& [entity, script] : scripts) {
+            if (!mgr->Has(script.handle)) {
+                continue;
+            }
+
+            auto& luaScript = mgr->Get(script.handle);
+            if (!luaScript.state_ && luaScript) {
+                luaScript.createState();
+            }
+            if (!luaScript.isInited_) {
+                luaScript.OnInit(entity);
+                luaScript.isInited_ = true;
+            }
+            luaScript.OnUpdate(entity);
+        }
+        return;
+    }
+
+    mgr->frame_++;
     for (auto&& [entity, script] : scripts) {
         if (!mgr->Has(script.handle)) {
             continue;
         }
-
         auto& luaScript = mgr->Get(script.handle);
-        if (!luaScript.isInited_) {
-            luaScript.OnInit(entity);
-            luaScript.isInited_ = true;
+        if (!luaScript) {
+            continue;
         }
-        luaScript.OnUpdate(entity);
+        mgr->prepareInstance(script.handle, luaScript, entity, script);
     }
+    mgr->updateBatches();
 }
 
-void ScriptShutdownSystem(gecs::querier<LuaScript> scripts) {
-    for (auto&& [entity, script] : scripts) {
-        script.OnDestroy(entity);
+void ScriptShutdownSystem(gecs::querier<Script> scripts,
+                          gecs::resource<gecs::mut<ScriptManager>> mgr) {
+    if (mgr->mode_ == ScriptManager::Mode::Isolated) {
+        for (auto&& [entity, script] : scripts) {
+            if (mgr->Has(script.handle)) {
+                mgr->Get(script.handle).OnDestroy(entity);
+            }
+        }
+        return;
+    }
+
+    for (auto& [_, batch] : mgr->batches_) {
+        mgr->releaseBatch(batch);
     }
+    mgr->batches_.clear();
 }
 
 }  // namespace nickel
\ No newline at end of file
@@ -3,30 +3,38 @@
 
 namespace nickel {
 
-cgmath::Mat44 calcMatFromRenderInfo(Flip flip, const cgmath::Vec2& customSize,
-                                    const cgmath::Vec2& anchor) {
-    return cgmath::CreateScale(
-               {customSize.x * (flip & Flip::Horizontal ? -1 : 1),
-                customSize.y * (flip & Flip::Vertical ? -1 : 1), 1}) *
-           cgmath::CreateTranslation({-anchor.x, -anchor.y, 0});
+cgmath::Affine2D calcMatFromRenderInfo(Flip flip,
+                                       const cgmath::Vec2& customSize,
+                                       const cgmath::Vec2& anchor) {
+    // scale * translation(-anchor)
+    float sx = customSize.x * (flip & Flip::Horizontal ? -1 : 1);
+    float sy = customSize.y * (flip & Flip::Vertical ? -1 : 1);
+    return {
+        {sx, 0, 0, sy, -anchor.x * sx, -anchor.y * sy}
+    };
 }
 
-void UpdateCamera2GPU(gecs::resource<Camera> camera,
+void UpdateCamera2GPU(gecs::resource<gecs::mut<rhi::Device>> device,
+                      gecs::resource<Camera> camera,
                       gecs::resource<gecs::mut<RenderContext>> ctx) {
     PROFILE_BEGIN();
 
-    auto map = (cgmath::Mat44*)ctx->mvpBuffer.GetMappedRange();
+    // previous frames may still read their own slots
+    ctx->mvpOffset = device->GetTransientAllocator().FrameIndex() *
+                     RenderContext::MVPSlotSize;
+    auto map = (cgmath::Mat44*)ctx->mvpBuffer.GetMappedRange(ctx->mvpOffset);
     memcpy(map, camera->View().data, sizeof(cgmath::Mat44));
     memcpy(map + 1, camera->Project().data, sizeof(cgmath::Mat44));
     if (!ctx->mvpBuffer.IsMappingCoherence()) {
-        ctx->mvpBuffer.Flush(0, sizeof(cgmath::Mat44) * 2);
+        ctx->mvpBuffer.Flush(ctx->mvpOffset, sizeof(cgmath::Mat44) * 2);
     }
 
     PROFILE_END();
 }
 
 void BeginRender(gecs::resource<gecs::mut<rhi::Device>> device,
-                 gecs::resource<gecs::mut<RenderContext>> ctx) {
+                 gecs::resource<gecs::mut<RenderContext>> ctx,
+                 gecs::resource<Window> window) {
     PROFILE_BEGIN();
 
     rhi::Texture::Descriptor textureDesc;
@@ -36,6 +44,11 @@ void BeginRender(gecs::resource<gecs::mut<rhi::Device>> device,
     ctx->presentTextureView = view;
     ctx->encoder = device->CreateCommandEncoder();
 
+    // encoder is dropped without submit when minimized, keep uploads pending
+    if (!window->IsMinimized()) {
+        ctx->textureUploadQueue->Flush(ctx->encoder);
+    }
+
     PROFILE_END();
 }
 
@@ -48,9 +61,9 @@ void draw(RenderContext& ctx, rhi::RenderPassEncoder renderPass,
                                sizeof(model));
     renderPass.SetVertexBuffer(0, vertexBuffer, 0, vertexBuffer.Size());
     if (material) {
-        renderPass.SetBindGroup(material.GetBindGroup());
+        renderPass.SetBindGroup(material.GetBindGroup(), {ctx.mvpOffset});
     } else {
-        renderPass.SetBindGroup(ctx.ctx2D->defaultBindGroup);
+        renderPass.SetBindGroup(ctx.ctx2D->defaultBindGroup, {ctx.mvpOffset});
     }
     if (indexBuffer) {
         renderPass.SetIndexBuffer(indexBuffer, rhi::IndexType::Uint32, 0,
@@ -68,63 +81,34 @@ void drawMesh2D(RenderContext& ctx, rhi::RenderPassEncoder renderPass,
          mesh.indicesBuffer, 0, material, model);
 }
 
-void drawTexture(RenderContext& ctx, uint32_t slot,
-                 rhi::RenderPassEncoder renderPass, const TextureManager& mgr,
-                 const Material2D& material,
-                 const std::optional<cgmath::Rect>& region,
-                 const cgmath::Color& color, const cgmath::Mat44& model,
-                 float z) {
-    Vertex2D topLeft{
-        {-0.5, 0.5, z},
-        {},
-        color
-    };
-    Vertex2D topRight{
-        {0.5, 0.5, z},
-        {},
-        color
-    };
-    Vertex2D bottomLeft{
-        {-0.5, -0.5, z},
-        {},
-        color
-    };
-    Vertex2D bottomRight{
-        {0.5, -0.5, z},
-        {},
-        color
+/**
+ * @brief write 4 vertices of sprite in world space, so sprites with
+ * different transform can be drawn in one call
+ */
+void fillSpriteVertices(Vertex2D* dst, const cgmath::Vec2& textureSize,
+                        const std::optional<cgmath::Rect>& region,
+                        const cgmath::Color& color,
+                        const cgmath::Affine2D& model, float z) {
+    cgmath::Rect rect = region.value_or(cgmath::Rect{
+        {0, 0},
+        textureSize
+    });
+    float left = rect.position.x / textureSize.w;
+    float right = (rect.position.x + rect.size.w) / textureSize.w;
+    float top = rect.position.y / textureSize.h;
+    float bottom = (rect.position.y + rect.size.h) / textureSize.h;
+
+    // same order as indices in `Render2DContext::indexBuffer`
+    static const cgmath::Vec2 corners[4] = {
+        {0.5, 0.5}, {-0.5, 0.5}, {0.5, -0.5}, {-0.5, -0.5}
     };
+    cgmath::Vec2 pos[4];
+    cgmath::TransformPoints(model, corners, pos, 4);
 
-    if (material) {
-        auto size = mgr.Get(material.GetTexture()).Size();
-        cgmath::Rect rect = region.value_or(cgmath::Rect{
-            {0, 0},
-            size
-        });
-        topLeft.texcoord.Set(rect.position.x / size.w,
-                             rect.position.y / size.h);
-        topRight.texcoord.Set((rect.position.x + rect.size.w) / size.w,
-                              rect.position.y / size.h);
-        bottomLeft.texcoord.Set(rect.position.x / size.w,
-                                (rect.position.y + rect.size.h) / size.h);
-        bottomRight.texcoord.Set((rect.position.x + rect.size.w) / size.w,
-                                 (rect.position.y + rect.size.h) / size.h);
-
-        std::array vertices{
-            topRight, topLeft, bottomRight, bottomLeft,
-        };
-
-        auto buf = ctx.ctx2D->vertexBuffer;
-        auto map = (Vertex2D*)buf.GetMappedRange();
-        memcpy(map + slot * 4, vertices.data(), sizeof(vertices));
-
-        if (!buf.IsMappingCoherence()) {
-            buf.Flush();
-        }
-
-        draw(ctx, renderPass, 6, ctx.ctx2D->vertexBuffer, slot * 4,
-             ctx.ctx2D->indexBuffer, 0, material, model);
-    }
+    dst[0] = {{pos[0].x, pos[0].y, z}, {right, top}, color};
+    dst[1] = {{pos[1].x, pos[1].y, z}, {left, top}, color};
+    dst[2] = {{pos[2].x, pos[2].y, z}, {right, bottom}, color};
+    dst[3] = {{pos[3].x, pos[3].y, z}, {left, bottom}, color};
 }
 
 void RenderSprite2D(
@@ -133,7 +117,7 @@ void RenderSprite2D(
     gecs::resource<gecs::mut<Camera>> camera,
     gecs::resource<TextureManager> mgr,
     gecs::resource<Material2DManager> mtl2dMgr,
-    gecs::querier<Transform, gecs::mut<Sprite>, SpriteMaterial> querier) {
+    gecs::querier<Transform, Sprite, SpriteMaterial> querier) {
     PROFILE_BEGIN();
 
     rhi::RenderPass::Descriptor desc;
@@ -150,38 +134,92 @@ void RenderSprite2D(
     }
     desc.colorAttachments.emplace_back(colorAtt);
 
-    auto renderPass = ctx->encoder.BeginRenderPass(desc);
-    renderPass.SetPipeline(ctx->ctx2D->pipeline);
-
-    querier.sort_by<Sprite>([](const Sprite& sprite1, const Sprite& sprite2) {
-        return sprite1.orderInLayer < sprite2.orderInLayer;
-    });
-
-    for (auto&& [_, transform, sprite, material] : querier) {
-        if (!mtl2dMgr->Has(material.material)) {
+    auto& ctx2D = *ctx->ctx2D;
+    auto& queue = ctx2D.spriteQueue;
+    auto& batches = ctx2D.spriteBatches;
+    auto& vertices = ctx2D.spriteVertices;
+    batches.clear();
+    vertices.clear();
+
+    // sort keys are compared with last frame, only re-sort when changed
+    queue.BeginFrame();
+    for (auto&& [entity, transform, sprite, material] : querier) {
+        if (!sprite.visiable || !mtl2dMgr->Has(material.material)) {
             continue;
         }
 
         auto& mtl = mtl2dMgr->Get(material.material);
 
-        if (!mgr->Has(mtl.GetTexture())) {
+        if (!mgr->Has(mtl.GetTexture()) ||
+            !mgr->Get(mtl.GetTexture()).IsReady()) {
             continue;
         }
 
-        if (!sprite.slot) {
-            sprite.slot = ctx->ctx2D->GenVertexSlot();
-        }
+        queue.Push(entity,
+                   SpriteRenderQueue::MakeKey(sprite.orderInLayer,
+                                              material.material,
+                                              mtl.GetTexture()),
+                   transform, sprite, mtl, mgr->Get(mtl.GetTexture()));
+    }
+    queue.Sort();
+
+    // gather all sprites into one vertex stream, continuous sprites with
+    // same material become one batch
+    uint32_t rectCount = 0;
+    for (auto& entry : queue.Entries()) {
+        auto& transform = *entry.transform;
+        auto& sprite = *entry.sprite;
+        auto& mtl = *entry.material;
+        auto& texture = *entry.texture;
+
+        vertices.resize(vertices.size() + 4);
+        fillSpriteVertices(
+            vertices.data() + rectCount * 4, texture.Size(), sprite.region,
+            sprite.color,
+            transform.ToAffine() *
+                calcMatFromRenderInfo(
+                    sprite.flip, sprite.customSize.value_or(texture.Size()),
+                    sprite.anchor),
+            sprite.orderInLayer);
 
-        auto& texture = mgr->Get(mtl.GetTexture());
+        if (batches.empty() || batches.back().material != &mtl) {
+            batches.push_back({&mtl, rectCount, 0});
+        }
+        batches.back().rectCount++;
+        rectCount++;
+    }
 
-        drawTexture(
-            ctx.get(), sprite.slot.value(), renderPass, mgr.get(), mtl,
-            sprite.region, sprite.color,
-            transform.ToMat() * calcMatFromRenderInfo(
-                                    sprite.flip,
-                                    sprite.customSize.value_or(texture.Size()),
-                                    sprite.anchor),
-            sprite.orderInLayer);
+    auto renderPass = ctx->encoder.BeginRenderPass(desc);
+    renderPass.SetPipeline(ctx2D.pipeline);
+
+    if (!batches.empty()) {
+        auto size = sizeof(Vertex2D) * vertices.size();
+        auto& transient = device->GetTransientAllocator();
+        auto allocation = transient.Allocate(size);
+        memcpy(allocation.ptr, vertices.data(), size);
+        transient.Flush(allocation);
+
+        // vertices are already in world space
+        auto model = cgmath::Mat44::Identity();
+        renderPass.SetPushConstant(rhi::ShaderStage::Vertex, model.data, 0,
+                                   sizeof(model));
+        renderPass.SetVertexBuffer(0, allocation.buffer, allocation.offset,
+                                   size);
+        renderPass.SetIndexBuffer(ctx2D.indexBuffer, rhi::IndexType::Uint32, 0,
+                                  ctx2D.indexBuffer.Size());
+        for (auto& batch : batches) {
+            renderPass.SetBindGroup(batch.material->GetBindGroup(),
+                                    {ctx->mvpOffset});
+
+            // index buffer only covers `MaxRectPerDraw` rects
+            for (uint32_t first = 0; first < batch.rectCount;
+                 first += Render2DContext::MaxRectPerDraw) {
+                auto count = std::min(batch.rectCount - first,
+                                      Render2DContext::MaxRectPerDraw);
+                renderPass.DrawIndexed(count * 6, 1, 0,
+                                       (batch.firstRect + first) * 4, 0);
+            }
+        }
     }
 
     renderPass.End();
@@ -215,8 +253,9 @@ void renderNodeRecursive(const GLTFModel& gltfModel, Node& node,
             renderPass.SetVertexBuffer(3, mesh.tanBuf, prim.tanBufView.offset,
                                        prim.tanBufView.size);
 
-            renderPass.SetBindGroup(material->bindGroup,
-                                    {material->pbrParameters.offset});
+            renderPass.SetBindGroup(
+                material->bindGroup,
+                {ctx.mvpOffset, material->pbrParameters.offset});
 
             if (prim.indicesBufView.size > 0) {
                 renderPass.DrawIndexed(prim.indicesBufView.count, 1, 0, 0, 0);
@@ -231,6 +270,25 @@ void renderNodeRecursive(const GLTFModel& gltfModel, Node& node,
     }
 }
 
+bool isTextureReady(const std::optional<Material3D::TextureInfo>& info,
+                    const TextureManager& mgr) {
+    return !info || !mgr.Has(info->texture) ||
+           mgr.Get(info->texture).IsReady();
+}
+
+// textures are uploaded asynchronously, don't sample them before ready
+bool isModelReady(const GLTFModel& model, const TextureManager& mgr) {
+    for (auto& material : model.materials) {
+        if (!isTextureReady(material->basicTexture, mgr) ||
+            !isTextureReady(material->normalTexture, mgr) ||
+            !isTextureReady(material->metalicRoughnessTexture, mgr) ||
+            !isTextureReady(material->occlusionTexture, mgr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void renderScenes(const GLTFModel& model, RenderContext& ctx,
                   rhi::RenderPassEncoder& renderPass) {
     for (auto& scene : model.scenes) {
@@ -242,6 +300,7 @@ void RenderGLTFModel(gecs::resource<gecs::mut<RenderContext>> ctx,
                      gecs::resource<gecs::mut<Camera>> camera,
                      gecs::resource<gecs::mut<rhi::Device>> device,
                      gecs::resource<GLTFManager> mgr,
+                     gecs::resource<TextureManager> textureMgr,
                      gecs::querier<GLTFHandle, Transform> querier) {
     PROFILE_BEGIN();
 
@@ -277,7 +336,8 @@ void RenderGLTFModel(gecs::resource<gecs::mut<RenderContext>> ctx,
     renderPass.SetPipeline(ctx->ctx3D->pipeline);
 
     for (auto&& [_, model, transform] : querier) {
-        if (mgr->Has(model)) {
+        if (mgr->Has(model) &&
+            isModelReady(mgr->Get(model), textureMgr.get())) {
             renderScenes(mgr->Get(model), ctx.get(), renderPass);
         }
     }
@@ -314,10 +374,11 @@ void EndFrame(gecs::resource<gecs::mut<rhi::Device>> device,
               gecs::resource<gecs::mut<RenderContext>> ctx) {
     PROFILE_BEGIN();
 
-    device->EndFrame();
-
+    // return command buffer within the frame which submitted it
     ctx->encoder.Destroy();
 
+    device->EndFrame();
+
     PROFILE_END();
 }
 
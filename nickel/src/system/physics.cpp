@@ -2,23 +2,26 @@
 
 namespace nickel::physics {
 
-void PhysicsInit(gecs::commands cmds) {
-    cmds.emplace_resource<World>();
+void PhysicsInit(gecs::commands cmds,
+                 gecs::resource<gecs::mut<JobPool>> jobPool) {
+    World world;
+    world.SetJobPool(&jobPool.get());
+    cmds.emplace_resource<World>(std::move(world));
 }
 
 void PhysicsUpdate(gecs::resource<gecs::mut<World>> world,
+                   gecs::resource<Time> time,
                    gecs::querier<gecs::mut<Body>, CollideShape> querier) {
-    for (auto&& [_, body, shape] : querier) {
-        for (auto& forceGen : world->forceGenerators) {
-            if (body.type == Body::Type::Dynamic) {
-                forceGen(body);
-            }
-        }
-    }
-
-    world->Step(0.3, querier);
+    world->Update(time->DeltaSeconds(), querier);
 }
 
+void PhysicsSyncTransform(
+    gecs::resource<World> world,
+    gecs::querier<Body, gecs::mut<Transform>> querier) {
+    auto alpha = world->GetInterpolationAlpha();
+    for (auto&& [_, body, transform] : querier) {
+        transform.translation = body.GetInterpolatedPos(alpha);
+    }
+}
 
-
-}
\ No newline at end of file
+}
@@ -7,16 +7,17 @@ RenderUIContext::RenderUIContext(rhi::Adapter adapter, rhi::Device device,
                                  const cgmath::Vec2& windowSize)
     : device_{device},
       camera{Camera::CreateOrtho(0, windowSize.w, -windowSize.h, 0, 1, 0,
-                                 {0, 0, windowSize.w, windowSize.h})} {
+                                 {0, 0, windowSize.w, windowSize.h})},
+      glyphAtlas{device} {
     auto api = adapter.RequestAdapterInfo().api;
     bindGroupLayout =
         createBindGroupLayout(ctx, adapter.Limits().supportSeparateSampler);
     pipelineLayout = createPipelineLayout();
     initPipelineShader(api);
     initPipelines(api);
-    vertexBuffer = createVertexBuffer();
     indexBuffer = createIndexBuffer();
     initDefaultBindGroup();
+    initGlyphAtlasBindGroups();
 }
 
 RenderUIContext::~RenderUIContext() {
@@ -26,7 +27,6 @@ RenderUIContext::~RenderUIContext() {
     defaultBindGroup.Destroy();
 
     indexBuffer.Destroy();
-    vertexBuffer.Destroy();
     fillPipeline.Destroy();
     linePipeline.Destroy();
     vertexShader.Destroy();
@@ -53,27 +53,17 @@ void RenderUIContext::AddElement(const cgmath::Rect& rect,
         UIVertex{{pos.x + size.w, pos.y + size.h}, textureClip.uv1, color},
     };
 
-    if (batchBreakInfos.empty()) {
+    if (batchBreakInfos.empty() ||
+        batchBreakInfos.back().texture != textureClip.handle ||
+        batchBreakInfos.back().pipeline != pipeline) {
         BatchBreakInfo breakInfo;
         breakInfo.texture = textureClip.handle;
         breakInfo.pipeline = pipeline;
-        breakInfo.start = this->vertices.size();
-        breakInfo.count++;
+        breakInfo.start = this->vertices.size() / 4;
 
         batchBreakInfos.emplace_back(std::move(breakInfo));
-    } else {
-        auto& lastBatch = batchBreakInfos.back();
-        if (lastBatch.texture != textureClip.handle ||
-            lastBatch.pipeline != pipeline) {
-            BatchBreakInfo breakInfo;
-            breakInfo.texture = textureClip.handle;
-            breakInfo.pipeline = pipeline;
-            breakInfo.start = this->vertices.size();
-            breakInfo.count++;
-
-            batchBreakInfos.emplace_back(std::move(breakInfo));
-        }
     }
+    batchBreakInfos.back().count++;
 
     for (int i = 0; i < vertices.size(); i++) {
         this->vertices.emplace_back(vertices[i]);
@@ -216,23 +206,16 @@ rhi::Buffer RenderUIContext::createIndexBuffer() {
     auto buffer = device_.CreateBuffer(desc);
     auto ptr = (uint32_t*)buffer.GetMappedRange();
     uint32_t indices[] = {0, 1, 2, 1, 2, 3};
-    for (int i = 0; i < MaxRectSize; i++) {
-        memcpy(ptr + i * 6, indices, sizeof(indices));
+    for (uint32_t i = 0; i < MaxRectSize; i++) {
+        for (uint32_t j = 0; j < 6; j++) {
+            ptr[i * 6 + j] = indices[j] + i * 4;
+        }
     }
     buffer.Unmap();
 
     return buffer;
 }
 
-rhi::Buffer RenderUIContext::createVertexBuffer() {
-    rhi::Buffer::Descriptor desc;
-    desc.mappedAtCreation = true;
-    desc.size = sizeof(float) * 9 * MaxRectSize;
-    desc.usage = rhi::BufferUsage::Vertex;
-
-    return device_.CreateBuffer(desc);
-}
-
 rhi::BindGroup RenderUIContext::FindBindGroup(TextureHandle handle) {
     if (auto it = bindGroups.find(handle); it != bindGroups.end()) {
         return it->second;
@@ -240,16 +223,11 @@ rhi::BindGroup RenderUIContext::FindBindGroup(TextureHandle handle) {
         auto mgr = ECS::Instance().World().res<TextureManager>();
         if (mgr->Has(handle)) {
             auto& texture = mgr->Get(handle);
-            rhi::BindGroup::Descriptor desc;
-            desc.layout = bindGroupLayout;
-            rhi::BindingPoint binding;
-            binding.binding = 1;
-            rhi::TextureBinding entry;
-            entry.view = texture.View();
-            binding.entry = entry;
-            desc.entries.push_back(binding);
-
-            return bindGroups.emplace(handle, device_.CreateBindGroup(desc))
+            if (!texture.IsReady()) {
+                return defaultBindGroup;
+            }
+            return bindGroups
+                .emplace(handle, createTextureBindGroup(texture.View()))
                 .first->second;
         } else {
             return defaultBindGroup;
@@ -257,18 +235,24 @@ rhi::BindGroup RenderUIContext::FindBindGroup(TextureHandle handle) {
     }
 }
 
-rhi::TextureView RenderUIContext::GetFontChar(FontHandle handle,
-                                              uint32_t code) {
-    auto mgr = ECS::Instance().World().res<FontManager>();
-    if (!mgr->Has(handle)) {
-        return {};
-    }
-
-    auto& font = mgr->Get(handle);
-
-    constexpr int size = 20;  // TODO: use custom size to generate font
+rhi::BindGroup RenderUIContext::createTextureBindGroup(
+    rhi::TextureView view) {
+    rhi::BindGroup::Descriptor desc;
+    desc.layout = bindGroupLayout;
+    rhi::BindingPoint binding;
+    binding.binding = 1;
+    rhi::TextureBinding entry;
+    entry.view = view;
+    binding.entry = entry;
+    desc.entries.push_back(binding);
+    return device_.CreateBindGroup(desc);
+}
 
-    auto glyph = font.GetGlyph(code, size);
+void RenderUIContext::initGlyphAtlasBindGroups() {
+    for (uint32_t i = 0; i < GlyphAtlas::PageCount; i++) {
+        bindGroups.emplace(glyphAtlas.GetPage(i),
+                           createTextureBindGroup(glyphAtlas.GetPageView(i)));
+    }
 }
 
 void RenderUIContext::initDefaultBindGroup() {
@@ -4,42 +4,43 @@ namespace nickel::ui {
 
 void Label::SetText(const utf8string& t) {
     text_ = t;
-    regenerateTextCache();
+    dirty_ = true;
 }
 
 void Label::SetPtSize(int size) {
     size_ = size;
-    regenerateTextCache();
+    dirty_ = true;
 }
 
 void Label::ChangeFont(FontHandle handle) {
     if (handle != font_) {
         font_ = handle;
-        regenerateTextCache();
+        dirty_ = true;
     }
 }
 
-void Label::regenerateTextCache() {
-    auto fontMgr = ECS::Instance().World().res_mut<FontManager>();
+void Label::UpdateLayout(GlyphAtlas& atlas) {
+    if (!dirty_) {
+        return;
+    }
+
+    auto fontMgr = ECS::Instance().World().res<FontManager>();
     if (!fontMgr->Has(font_)) {
         return;
     }
 
     auto& font = fontMgr->Get(font_);
     textSize_.Set(0, 0);
-    cache_.Clear();
     rects_.clear();
+    dirty_ = false;
 
     cgmath::Vec2 baseline;
 
     for (auto& c : text_) {
-        auto glyph = font.GetGlyph(c.to_uint64(), size_);
-        auto ch = Character{glyph};
-
+        auto value = c.to_uint64();
         cgmath::Rect rect;
 
         if (c.is_white_space()) {
-            auto value = c.to_uint64();
             if (value == ' ') {
                 baseline.x += size_;
             } else if (value == '\t') {
@@ -51,19 +52,24 @@ void Label::regenerateTextCache() {
             rect.position.x = baseline.x;
             rect.position.y = baseline.y + size_;
         } else {
-            rect.position.x = baseline.x + ch.bearing.x;
-            rect.position.y = baseline.y - ch.bearing.y + size_;
-            baseline.x += ch.size.w + ch.bearing.x;
-        }
+            auto glyph = atlas.Find(font, font_, size_, value);
+            if (!glyph) {
+                // atlas is full now, retry in next frame when pages are freed
+                dirty_ = true;
+                continue;
+            }
 
-        rect.size = ch.size;
+            rect.position.x = baseline.x + glyph->bearing.x;
+            rect.position.y = baseline.y - glyph->bearing.y + size_;
+            rect.size = glyph->size;
+            baseline.x += glyph->advance;
+        }
 
         textSize_.w = std::max(textSize_.w, rect.position.x + rect.size.w);
         textSize_.h = std::max(textSize_.h, rect.position.y + rect.size.h);
 
-        cache_.Push(std::move(ch));
-        rects_.push_back(rect);
+        rects_.push_back({static_cast<uint32_t>(value), rect});
     }
 }
 
-}  // namespace nickel::ui
\ No newline at end of file
+}  // namespace nickel::ui
@@ -85,46 +85,50 @@ void collectRenderElem(gecs::entity ent, const Style& style, const Button* btn,
 
     ctx.renderCtx.AddElement(rect, *color, texture, ctx.renderCtx.fillPipeline);
 
-    /*
-    color = &label->color;
-    auto& rects = label->GetRenderRects();
-    auto& boundingSize = label->GetBoundingBoxSize();
-    if (label) {
-        auto& textTextures = label->GetTextCache().Texts();
-        auto& texts = label->GetText();
-        for (int i = 0; i < texts.size(); i++) {
-            auto& c = textTextures[i];
-            auto& t = texts[i];
-
-            if (t.is_white_space()) {
-                continue;
-            }
+    if (!label) {
+        return;
+    }
 
-            if (i >= textTextures.size()) {
-                continue;
-            }
+    color = &label->color;
+    if (ctx.eventRecorder.entity == ent) {
+        if (ctx.eventRecorder.HasEvent(Event::Hover)) {
+            color = &label->hoverColor;
+        }
+        if (ctx.eventRecorder.HasEvent(Event::Press)) {
+            color = &label->pressColor;
+        }
+    }
 
-            cgmath::Rect region = {{}, c.size};
-            region.position = rects[i].position + rect.position +
-                              rect.size * 0.5 - boundingSize * 0.5;
-
-            if (ctx.eventRecorder.entity == ent) {
-                if (ctx.eventRecorder.HasEvent(Event::Hover)) {
-                    color = &label->hoverColor;
-                }
-                if (ctx.eventRecorder.HasEvent(Event::Press)) {
-                    color = &label->pressColor;
-                }
-            }
+    auto fontMgr = ECS::Instance().World().res<FontManager>();
+    if (!fontMgr->Has(label->GetFont())) {
+        return;
+    }
+    auto& font = fontMgr->Get(label->GetFont());
+
+    // glyphs share few atlas pages, so the whole text is one batch
+    auto offset = rect.position + rect.size * 0.5 -
+                  label->GetBoundingBoxSize() * 0.5;
+    for (auto& [code, charRect] : label->GetRenderRects()) {
+        if (charRect.size.w <= 0 || charRect.size.h <= 0) {
+            continue;
+        }
 
-            ctx.renderCtx.AddElement(region, *color, texture,
-                                     ctx.renderCtx.fillPipeline);
+        auto glyph = ctx.renderCtx.glyphAtlas.Find(font, label->GetFont(),
+                                                   label->GetPtSize(), code);
+        if (!glyph || !glyph->page) {
+            continue;
         }
+
+        cgmath::Rect region{charRect.position + offset, charRect.size};
+        ctx.renderCtx.AddElement(region, *color,
+                                 TextureClip{glyph->page, glyph->uv0,
+                                             glyph->uv1},
+                                 ctx.renderCtx.fillPipeline);
     }
-    */
 }
 
 void RenderUI(gecs::querier<Style, gecs::without<Parent>> querier,
+              gecs::resource<gecs::mut<rhi::Device>> device,
               gecs::resource<gecs::mut<UIContext>> ctx,
               gecs::resource<gecs::mut<RenderContext>> renderCtx,
               gecs::resource<gecs::mut<Camera>> camera,
@@ -133,25 +137,35 @@ void RenderUI(gecs::querier<Style, gecs::without<Parent>> querier,
 
     ctx->renderCtx.vertices.clear();
     ctx->renderCtx.batchBreakInfos.clear();
+    ctx->renderCtx.glyphAtlas.BeginFrame();
+    auto& transient = device->GetTransientAllocator();
 
     for (auto&& [entity, style] : querier) {
         auto contentRect =
             cgmath::Rect::FromCenter(style.GlobalCenter(), style.size * 0.5);
 
-        collectRenderElem(entity, style, reg.try_get<Button>(entity),
-                          reg.try_get<Label>(entity), ctx.get(),
-                          renderCtx.get());
+        Label* label = nullptr;
+        if (reg.has<Label>(entity)) {
+            label = &reg.get_mut<Label>(entity);
+            label->UpdateLayout(ctx->renderCtx.glyphAtlas);
+        }
+
+        collectRenderElem(entity, style, reg.try_get<Button>(entity), label,
+                          ctx.get(), renderCtx.get());
     }
 
-    Assert(ctx->renderCtx.vertices.size() < RenderUIContext::MaxRectSize * 4,
-           "ui vertex size out of range");
+    // new glyphs must be in texture before render pass samples them
+    ctx->renderCtx.glyphAtlas.Upload(renderCtx->encoder, transient);
 
-    auto ptr = ctx->renderCtx.vertexBuffer.GetMappedRange();
-    memcpy(ptr, ctx->renderCtx.vertices.data(),
-           sizeof(UIVertex) * ctx->renderCtx.vertices.size());
+    Assert(ctx->renderCtx.vertices.size() <= RenderUIContext::MaxRectSize * 4,
+           "ui vertex size out of range");
 
-    if (!ctx->renderCtx.vertexBuffer.IsMappingCoherence()) {
-        ctx->renderCtx.vertexBuffer.Flush();
+    auto verticesSize = sizeof(UIVertex) * ctx->renderCtx.vertices.size();
+    rhi::TransientAllocator::Allocation vertices;
+    if (verticesSize > 0) {
+        vertices = transient.Allocate(verticesSize);
+        memcpy(vertices.ptr, ctx->renderCtx.vertices.data(), verticesSize);
+        transient.Flush(vertices);
     }
 
     rhi::RenderPass::Descriptor desc;
@@ -178,15 +192,15 @@ void RenderUI(gecs::querier<Style, gecs::without<Parent>> querier,
         auto& viewport = camera->GetViewport();
         renderPass.SetViewport(viewport.position.x, viewport.position.y,
                                viewport.size.w, viewport.size.h);
-        renderPass.SetVertexBuffer(0, ctx->renderCtx.vertexBuffer, 0,
-                                   sizeof(UIVertex) * batch.count);
-        renderPass.SetIndexBuffer(
-            ctx->renderCtx.indexBuffer, rhi::IndexType::Uint32, 0,
-            sizeof(uint32_t) * ctx->renderCtx.vertices.size());
+        renderPass.SetVertexBuffer(0, vertices.buffer, vertices.offset,
+                                   verticesSize);
+        renderPass.SetIndexBuffer(ctx->renderCtx.indexBuffer,
+                                  rhi::IndexType::Uint32, 0,
+                                  ctx->renderCtx.indexBuffer.Size());
 
         auto bindGroup = ctx->renderCtx.FindBindGroup(batch.texture);
         renderPass.SetBindGroup(bindGroup);
-        renderPass.DrawIndexed(6 * batch.count, 1, batch.start * 4, 0, 0);
+        renderPass.DrawIndexed(6 * batch.count, 1, batch.start * 6, 0, 0);
     }
     renderPass.End();
 }
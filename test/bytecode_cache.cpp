@@ -0,0 +1,84 @@
+#include "script/bytecode_cache.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <fstream>
+
+using namespace nickel;
+
+namespace {
+
+std::filesystem::path makeTempDir() {
+    auto dir = std::filesystem::temp_directory_path() / "nickel_bytecode_cache";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+}  // namespace
+
+TEST_CASE("bytecode cache path") {
+    REQUIRE(GetBytecodeCachePath("res/foo.luau") ==
+            std::filesystem::path{"res/foo.luau.bytecode"});
+}
+
+TEST_CASE("bytecode cache key") {
+    REQUIRE(HashScriptSource("print(1)") == HashScriptSource("print(1)"));
+    REQUIRE(HashScriptSource("print(1)") != HashScriptSource("print(2)"));
+
+    ScriptCompileOptions options, other;
+    REQUIRE(options.Hash() == other.Hash());
+    other.optimizationLevel = 2;
+    REQUIRE(options.Hash() != other.Hash());
+    other = options;
+    other.debugLevel = 2;
+    REQUIRE(options.Hash() != other.Hash());
+}
+
+TEST_CASE("bytecode cache read and write") {
+    auto dir = makeTempDir();
+    auto cacheFile = GetBytecodeCachePath(dir / "foo.luau");
+    ScriptCompileOptions options;
+    auto hash = HashScriptSource("return 1");
+    std::string bytecode("\x06\x01\x00\x02payload", 11);
+
+    REQUIRE_FALSE(ReadBytecodeCache(cacheFile, hash, options));
+
+    REQUIRE(WriteBytecodeCache(cacheFile, hash, options, bytecode));
+    REQUIRE_FALSE(std::filesystem::exists(cacheFile.string() + ".tmp"));
+    auto cached = ReadBytecodeCache(cacheFile, hash, options);
+    REQUIRE(cached);
+    REQUIRE(*cached == bytecode);
+
+    SECTION("source changed") {
+        REQUIRE_FALSE(ReadBytecodeCache(cacheFile, HashScriptSource("return 2"),
+                                        options));
+    }
+
+    SECTION("options changed") {
+        auto other = options;
+        other.optimizationLevel = 2;
+        REQUIRE_FALSE(ReadBytecodeCache(cacheFile, hash, other));
+    }
+
+    SECTION("overwrite") {
+        auto newHash = HashScriptSource("return 2");
+        REQUIRE(WriteBytecodeCache(cacheFile, newHash, options, "\x06new"));
+        REQUIRE_FALSE(ReadBytecodeCache(cacheFile, hash, options));
+        REQUIRE(*ReadBytecodeCache(cacheFile, newHash, options) == "\x06new");
+    }
+
+    SECTION("truncated") {
+        auto size = std::filesystem::file_size(cacheFile);
+        std::filesystem::resize_file(cacheFile, size - 1);
+        REQUIRE_FALSE(ReadBytecodeCache(cacheFile, hash, options));
+    }
+
+    SECTION("garbage") {
+        std::ofstream(cacheFile, std::ios::binary) << "not a bytecode cache";
+        REQUIRE_FALSE(ReadBytecodeCache(cacheFile, hash, options));
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -221,3 +221,122 @@ TEST_CASE("matrix can be add, sub, multiply and divide", "[matrix]") {
         REQUIRE(result.y == 46);
     }
 }
+
+TEST_CASE("affine 2D transform is same as Mat44 composition", "[affine2d]") {
+    cgmath::Vec2 translation{3, -2};
+    float radians = cgmath::Deg2Rad(30.0f);
+    cgmath::Vec2 scale{2, 0.5};
+
+    auto affine = cgmath::Affine2D::FromTRS(translation, radians, scale);
+    auto mat = cgmath::CreateTranslation({translation.x, translation.y, 0}) *
+               cgmath::CreateZRotation(radians) *
+               cgmath::CreateScale({scale.x, scale.y, 1});
+
+    SECTION("convert to Mat44") {
+        auto converted = affine.ToMat44();
+        for (int i = 0; i < 16; i++) {
+            REQUIRE(cgmath::IsSameValue(converted.data[i], mat.data[i],
+                                        0.0001));
+        }
+    }
+
+    SECTION("compose") {
+        auto composed = cgmath::Affine2D::FromTranslation(translation) *
+                        cgmath::Affine2D::FromRotation(radians) *
+                        cgmath::Affine2D::FromScale(scale);
+        for (int i = 0; i < 6; i++) {
+            REQUIRE(cgmath::IsSameValue(composed.data[i], affine.data[i],
+                                        0.0001));
+        }
+    }
+
+    SECTION("transform points") {
+        cgmath::Vec2 points[3] = {
+            {0, 0},
+            {1, 0},
+            {-1, 4}
+        };
+        cgmath::Vec2 result[3];
+        cgmath::TransformPoints(affine, points, result, 3);
+        for (int i = 0; i < 3; i++) {
+            auto expect = mat * cgmath::Vec4{points[i].x, points[i].y, 0, 1};
+            REQUIRE(cgmath::IsSameValue(result[i].x, expect.x, 0.0001));
+            REQUIRE(cgmath::IsSameValue(result[i].y, expect.y, 0.0001));
+            REQUIRE(result[i] == affine.TransformPoint(points[i]));
+        }
+    }
+}
+
+TEST_CASE("float Vec3/Vec4/Mat44 give same bits as scalar loops", "[simd]") {
+    using Vec3f = cgmath::Vec<float, 3>;
+    using Vec4f = cgmath::Vec<float, 4>;
+    using Mat44f = cgmath::Mat<float, 4, 4>;
+
+    Vec4f a{1.1f, -2.3f, 3.7f, 0.3f}, b{0.7f, 5.9f, -1.3f, 3.1f};
+    Vec3f c{1.1f, -2.3f, 3.7f}, d{0.7f, 5.9f, -1.3f};
+
+    SECTION("vector operations") {
+        auto add = a + b, sub = a - b, mul = a * b, div = a / b,
+             scale = a * 0.3f, divScale = a / 0.3f;
+        for (int i = 0; i < 4; i++) {
+            REQUIRE(add.data[i] == a.data[i] + b.data[i]);
+            REQUIRE(sub.data[i] == a.data[i] - b.data[i]);
+            REQUIRE(mul.data[i] == a.data[i] * b.data[i]);
+            REQUIRE(div.data[i] == a.data[i] / b.data[i]);
+            REQUIRE(scale.data[i] == a.data[i] * 0.3f);
+            REQUIRE(divScale.data[i] == a.data[i] / 0.3f);
+        }
+
+        auto add3 = c + d, div3 = c / d;
+        for (int i = 0; i < 3; i++) {
+            REQUIRE(add3.data[i] == c.data[i] + d.data[i]);
+            REQUIRE(div3.data[i] == c.data[i] / d.data[i]);
+        }
+    }
+
+    Mat44f m1, m2;
+    for (int i = 0; i < 16; i++) {
+        m1.data[i] = 0.1f * i - 0.7f;
+        m2.data[i] = 1.3f - 0.23f * i;
+    }
+
+    SECTION("matrix multiply") {
+        auto result = m1 * m2;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                float sum = 0;
+                for (int k = 0; k < 4; k++) {
+                    sum += m1.Get(k, i) * m2.Get(j, k);
+                }
+                REQUIRE(result.Get(j, i) == sum);
+            }
+        }
+
+        auto v = m1 * a;
+        for (int i = 0; i < 4; i++) {
+            float sum = 0;
+            for (int k = 0; k < 4; k++) {
+                sum += m1.Get(k, i) * a.data[k];
+            }
+            REQUIRE(v.data[i] == sum);
+        }
+    }
+
+    SECTION("transform points in structure of arrays") {
+        constexpr int Count = 19;
+        float xs[Count], ys[Count], zs[Count], ox[Count], oy[Count],
+            oz[Count];
+        for (int i = 0; i < Count; i++) {
+            xs[i] = i * 0.37f;
+            ys[i] = -i * 1.1f;
+            zs[i] = 2.0f - i;
+        }
+        cgmath::TransformPoints(m1, xs, ys, zs, ox, oy, oz, Count);
+        for (int i = 0; i < Count; i++) {
+            auto p = m1 * Vec4f{xs[i], ys[i], zs[i], 1};
+            REQUIRE(ox[i] == p.x);
+            REQUIRE(oy[i] == p.y);
+            REQUIRE(oz[i] == p.z);
+        }
+    }
+}
@@ -206,3 +206,66 @@ TEST_CASE("gjk", "[2D]") {
         REQUIRE_FALSE(DoGjk(geom, geom, cgmath::Vec2{0, 0}, cgmath::Vec2{200, 2}));
     }
 }
+
+TEST_CASE("gjk on support functions", "[2D]") {
+    geom_type box = {
+        {-1, -1},
+        { 1, -1},
+        { 1,  1},
+        {-1,  1},
+    };
+
+    SECTION("polygon") {
+        geom_type moved = box;
+        for (auto& p : moved) {
+            p += cgmath::Vec2{1.5, 0};
+        }
+        geom2d::GjkSimplex<float> simplex;
+        REQUIRE(geom2d::GjkIntersect(geom2d::PolygonView<float>(box),
+                                     geom2d::PolygonView<float>(moved),
+                                     &simplex));
+        auto mtv = geom2d::EPA(simplex, geom2d::PolygonView<float>(box),
+                               geom2d::PolygonView<float>(moved));
+        REQUIRE(mtv);
+        REQUIRE(mtv->len == Approx(0.5));
+        REQUIRE(geom::IsSamePt(mtv->v, cgmath::Vec2{1, 0}));
+
+        for (auto& p : moved) {
+            p += cgmath::Vec2{2, 0};
+        }
+        auto closest = geom2d::GjkClosestPt(geom2d::PolygonView<float>(box),
+                                            geom2d::PolygonView<float>(moved));
+        REQUIRE(closest);
+        REQUIRE(closest->distance == Approx(1.5));
+        REQUIRE(closest->pt1.x == Approx(1));
+        REQUIRE(closest->pt2.x == Approx(2.5));
+    }
+
+    SECTION("implicit shapes") {
+        auto c1 = geom2d::Circle<float>::Create(cgmath::Vec2{0, 0}, 1);
+        auto c2 = geom2d::Circle<float>::Create(cgmath::Vec2{0, 3}, 1);
+        auto closest = geom2d::GjkClosestPt(c1, c2);
+        REQUIRE(closest);
+        REQUIRE(closest->distance == Approx(1).epsilon(0.001));
+
+        c2.center.y = 1.5;
+        geom2d::GjkSimplex<float> simplex;
+        REQUIRE(geom2d::GjkIntersect(c1, c2, &simplex));
+        auto mtv = geom2d::EPA(simplex, c1, c2);
+        REQUIRE(mtv);
+        REQUIRE(mtv->len == Approx(0.5).epsilon(0.01));
+        REQUIRE(mtv->v.y == Approx(1).epsilon(0.01));
+
+        auto capsule = geom2d::Capsule<float>::Create(cgmath::Vec2{-3, 0},
+                                                      cgmath::Vec2{3, 0}, 1);
+        auto obb = geom2d::OBB<float>::FromCenter(
+            cgmath::Vec2{0, 3}, cgmath::Vec2{1, 1}, cgmath::Deg2Rad(45.0f));
+        closest = geom2d::GjkClosestPt(capsule, obb);
+        REQUIRE(closest);
+        REQUIRE(closest->distance ==
+                Approx(3 - std::sqrt(2.0f) - 1).epsilon(0.001));
+
+        REQUIRE(geom2d::GjkIntersect(capsule, c1));
+        REQUIRE_FALSE(geom2d::GjkIntersect(obb, c1));
+    }
+}
@@ -0,0 +1,133 @@
+#include "common/hierarchy.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace nickel;
+
+struct HierarchyWorld {
+    gecs::world world;
+    gecs::world::registry_type* reg;
+
+    HierarchyWorld() {
+        reg = &world.regist_registry("test");
+        reg->commands().emplace_resource<TransformHierarchy>();
+        reg->commands().emplace_resource<JobPool>(0u);
+        reg->regist_update_system<UpdateGlobalTransform>();
+        world.start_with("test");
+        world.startup();
+    }
+
+    gecs::entity Create(const cgmath::Vec2& pos) {
+        auto cmds = reg->commands();
+        auto ent = cmds.create();
+        cmds.emplace<Transform>(ent, Transform::FromTranslation(pos));
+        cmds.emplace<GlobalTransform>(ent);
+        return ent;
+    }
+
+    void MoveAsChild(gecs::entity parent, gecs::entity child) {
+        HierarchyTool{*reg, parent}.MoveEntityAsChild(child);
+    }
+
+    cgmath::Vec2 WorldPos(gecs::entity ent) const {
+        return reg->get<GlobalTransform>(ent).mat.Translation();
+    }
+
+    uint32_t NodeCount() const {
+        return reg->res<TransformHierarchy>()->NodeCount();
+    }
+};
+
+TEST_CASE("transform hierarchy") {
+    HierarchyWorld w;
+
+    // a - b - c, d - e
+    auto a = w.Create({10, 0});
+    auto b = w.Create({5, 0});
+    auto c = w.Create({1, 0});
+    auto d = w.Create({0, 100});
+    auto e = w.Create({0, 1});
+    w.MoveAsChild(a, b);
+    w.MoveAsChild(b, c);
+    w.MoveAsChild(d, e);
+
+    w.world.update();
+    REQUIRE(w.NodeCount() == 5);
+    REQUIRE(w.WorldPos(b) == cgmath::Vec2{15, 0});
+    REQUIRE(w.WorldPos(c) == cgmath::Vec2{16, 0});
+    REQUIRE(w.WorldPos(e) == cgmath::Vec2{0, 101});
+
+    SECTION("dirty parent propagates to descendants") {
+        w.reg->get_mut<Transform>(a).translation = {20, 0};
+        w.world.update();
+        REQUIRE(w.WorldPos(a) == cgmath::Vec2{20, 0});
+        REQUIRE(w.WorldPos(b) == cgmath::Vec2{25, 0});
+        REQUIRE(w.WorldPos(c) == cgmath::Vec2{26, 0});
+
+        w.reg->get_mut<Transform>(b).translation = {0, 5};
+        w.world.update();
+        REQUIRE(w.WorldPos(a) == cgmath::Vec2{20, 0});
+        REQUIRE(w.WorldPos(c) == cgmath::Vec2{21, 5});
+    }
+
+    SECTION("unchanged subtree is not rewritten") {
+        // a rewrite would overwrite the marker
+        auto marker = cgmath::Affine2D::FromTranslation({999, 999});
+        w.reg->get_mut<GlobalTransform>(d).mat = marker;
+        w.reg->get_mut<GlobalTransform>(e).mat = marker;
+        w.reg->get_mut<GlobalTransform>(a).mat = marker;
+
+        w.reg->get_mut<Transform>(b).translation = {6, 0};
+        w.world.update();
+        REQUIRE(w.WorldPos(d) == cgmath::Vec2{999, 999});
+        REQUIRE(w.WorldPos(e) == cgmath::Vec2{999, 999});
+        REQUIRE(w.WorldPos(a) == cgmath::Vec2{999, 999});
+        REQUIRE(w.WorldPos(c) == cgmath::Vec2{17, 0});
+    }
+
+    SECTION("rebuild after reparenting") {
+        w.MoveAsChild(d, c);
+        w.world.update();
+        REQUIRE(w.NodeCount() == 5);
+        REQUIRE(w.WorldPos(c) == cgmath::Vec2{1, 100});
+
+        w.reg->get_mut<Transform>(a).translation = {0, 0};
+        w.reg->get_mut<Transform>(d).translation = {0, 50};
+        w.world.update();
+        REQUIRE(w.WorldPos(b) == cgmath::Vec2{5, 0});
+        REQUIRE(w.WorldPos(c) == cgmath::Vec2{1, 50});
+        REQUIRE(w.WorldPos(e) == cgmath::Vec2{0, 51});
+    }
+
+    SECTION("rebuild after destroying child") {
+        // child list still holds the dead entity
+        w.reg->commands().destroy(c);
+        w.world.update();
+        REQUIRE(w.NodeCount() == 4);
+
+        w.reg->get_mut<Transform>(a).translation = {0, 0};
+        w.world.update();
+        REQUIRE(w.WorldPos(b) == cgmath::Vec2{5, 0});
+        REQUIRE(w.WorldPos(e) == cgmath::Vec2{0, 101});
+    }
+
+    SECTION("rebuild after removing child transform") {
+        w.reg->commands().remove<Transform>(e);
+        w.world.update();
+        REQUIRE(w.NodeCount() == 4);
+
+        w.reg->get_mut<Transform>(d).translation = {0, 50};
+        w.world.update();
+        REQUIRE(w.WorldPos(d) == cgmath::Vec2{0, 50});
+    }
+
+    SECTION("new root is found without marking") {
+        auto f = w.Create({7, 7});
+        w.world.update();
+        REQUIRE(w.NodeCount() == 6);
+        REQUIRE(w.WorldPos(f) == cgmath::Vec2{7, 7});
+    }
+
+    w.world.shutdown();
+}
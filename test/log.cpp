@@ -0,0 +1,151 @@
+#include "common/log.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace logger;
+
+TEST_CASE("async log record encoding") {
+    std::ostringstream syncStream, asyncStream;
+    Logger syncLogger{syncStream};
+    Logger asyncLogger{asyncStream};
+    {
+        AsyncLogBackend backend{16, 0, asyncStream};
+        asyncLogger.SetAsyncBackend(&backend);
+        asyncLogger.Warning("func", "file.cpp", 12, "[", "tag", "]:", 1, -2,
+                            3u, 1.5f, true, 'c', std::string("str"),
+                            std::string_view("view"),
+                            std::vector<int>{1, 2});
+    }
+
+    syncLogger.Warning("func", "file.cpp", 12, "[", "tag", "]:", 1, -2, 3u,
+                       1.5f, true, 'c', std::string("str"),
+                       std::string_view("view"), std::vector<int>{1, 2});
+    REQUIRE(asyncStream.str() ==
+            syncStream.str());
+}
+
+TEST_CASE("async log keeps order and truncates long message") {
+    std::ostringstream stream;
+    Logger logger{stream};
+    AsyncLogBackend backend{64, 0, stream};
+    logger.SetAsyncBackend(&backend);
+
+    for (int i = 0; i < 10; i++) {
+        logger.Info("f", "a.cpp", 1, i);
+    }
+    logger.Info("f", "a.cpp", 2, std::string(1000, 'x'));
+    backend.Flush();
+
+    std::istringstream lines{stream.str()};
+    std::string line;
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(std::getline(lines, line));
+        REQUIRE(line == "[Info][a.cpp][f][1]" + std::to_string(i));
+    }
+    REQUIRE(std::getline(lines, line));
+    REQUIRE(line.size() < 1000);
+    REQUIRE(line.substr(line.size() - 3) == "...");
+    REQUIRE_FALSE(std::getline(lines, line));
+}
+
+TEST_CASE("async log rate limit and drop") {
+    SECTION("rate limit repeated messages") {
+        std::ostringstream stream;
+        Logger logger{stream};
+        AsyncLogBackend backend{64, 5, stream};
+        logger.SetAsyncBackend(&backend);
+
+        int accepted = 0;
+        for (int i = 0; i < 20; i++) {
+            logger.Warning("f", "a.cpp", 1, "same");
+        }
+        logger.Warning("f", "a.cpp", 2, "other");
+        backend.Flush();
+
+        std::istringstream lines{stream.str()};
+        std::string line;
+        while (std::getline(lines, line)) {
+            accepted++;
+        }
+        REQUIRE(accepted == 6);
+        REQUIRE(backend.DroppedCount() == 15);
+    }
+
+    SECTION("drop newest when full") {
+        std::ostringstream stream, report;
+        Logger logger{stream};
+        uint64_t pushed = 0;
+        {
+            AsyncLogBackend backend{2, 0, report};
+            logger.SetAsyncBackend(&backend);
+            for (int i = 0; i < 10000; i++) {
+                logger.Info("f", "a.cpp", 1, i);
+            }
+            backend.Flush();
+            pushed = 10000 - backend.DroppedCount();
+        }
+
+        std::istringstream lines{stream.str()};
+        std::string line;
+        uint64_t written = 0;
+        while (std::getline(lines, line)) {
+            written++;
+        }
+        REQUIRE(written == pushed);
+        if (pushed < 10000) {
+            REQUIRE(report.str().find("messages dropped") !=
+                    std::string::npos);
+        }
+    }
+
+    SECTION("fatal error is written before return") {
+        std::ostringstream stream;
+        Logger logger{stream};
+        AsyncLogBackend backend{16, 1, stream};
+        logger.SetAsyncBackend(&backend);
+        logger.FatalError("f", "a.cpp", 1, "fatal");
+        logger.FatalError("f", "a.cpp", 1, "fatal");
+        REQUIRE(stream.str() ==
+                "[FatalError][a.cpp][f][1]fatal\n"
+                "[FatalError][a.cpp][f][1]fatal\n");
+    }
+}
+
+TEST_CASE("async log from many threads") {
+    std::ostringstream stream;
+    Logger logger{stream};
+    AsyncLogBackend backend{1024, 0, stream};
+    logger.SetAsyncBackend(&backend);
+
+    constexpr int ThreadNum = 4;
+    constexpr int LogNum = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadNum; t++) {
+        threads.emplace_back([&logger, t] {
+            for (int i = 0; i < LogNum; i++) {
+                logger.Info("f", "a.cpp", 1, t, ":", i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    backend.Flush();
+
+    // messages of one thread keep their order
+    std::vector<int> next(ThreadNum, 0);
+    std::istringstream lines{stream.str()};
+    std::string line;
+    uint64_t written = 0;
+    while (std::getline(lines, line)) {
+        auto body = line.substr(std::string("[Info][a.cpp][f][1]").size());
+        auto colon = body.find(':');
+        int t = std::stoi(body.substr(0, colon));
+        int i = std::stoi(body.substr(colon + 1));
+        REQUIRE(i >= next[t]);
+        next[t] = i + 1;
+        written++;
+    }
+    REQUIRE(written + backend.DroppedCount() == ThreadNum * LogNum);
+}
@@ -0,0 +1,626 @@
+#include "physics/broad_phase.hpp"
+#include "physics/world.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace nickel;
+
+TEST_CASE("shape bounding box") {
+    SECTION("circle") {
+        auto shape = physics::CircleShape::FromCenter({1, 2}, 3);
+        auto aabb = physics::GetShapeAABB(shape, {10, 10});
+        REQUIRE(aabb.center == physics::Vec2{11, 12});
+        REQUIRE(aabb.halfLen == physics::Vec2{3, 3});
+    }
+
+    SECTION("rotated obb") {
+        auto shape = physics::OBBShape::FromCenter({}, {2, 1}, cgmath::PI * 0.5);
+        auto aabb = physics::GetShapeAABB(shape, {});
+        REQUIRE(geom::IsSamePt(aabb.halfLen, physics::Vec2{1, 2}));
+    }
+}
+
+TEST_CASE("broad phase") {
+    std::vector<physics::AABB> bounds;
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<physics::Real> posDist(0, 200);
+    std::uniform_real_distribution<physics::Real> sizeDist(1, 10);
+    for (int i = 0; i < 300; i++) {
+        bounds.push_back(physics::AABB::FromCenter(
+            {posDist(gen), posDist(gen)}, {sizeDist(gen), sizeDist(gen)}));
+    }
+
+    physics::BruteForceBroadPhase bruteForce;
+    physics::SweepAndPruneBroadPhase sap;
+
+    std::vector<physics::BroadPhasePair> expect, result;
+    bruteForce.FindPairs(bounds, expect);
+    REQUIRE_FALSE(expect.empty());
+
+    SECTION("sweep and prune find same pairs as brute force") {
+        sap.FindPairs(bounds, result);
+        REQUIRE(result == expect);
+
+        // move a little and check the incremental sort
+        for (auto& aabb : bounds) {
+            aabb.center.x += sizeDist(gen) - 5;
+        }
+        bruteForce.FindPairs(bounds, expect);
+        sap.FindPairs(bounds, result);
+        REQUIRE(result == expect);
+    }
+}
+
+TEST_CASE("manifold") {
+    physics::ManifoldSolver solver;
+    physics::CollideShape circle = physics::CircleShape::FromCenter({}, 10);
+    physics::CollideShape box =
+        physics::OBBShape::FromCenter({}, {100, 10}, 0.0);
+
+    SECTION("circle on box") {
+        physics::Manifold manifold;
+        REQUIRE(solver.GetContact(circle, {0, -15}, box, {}, manifold));
+        REQUIRE(manifold.pointCount == 1);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, -1}));
+    }
+
+    SECTION("swapped order flip normal") {
+        physics::Manifold manifold;
+        REQUIRE(solver.GetContact(box, {}, circle, {0, -15}, manifold));
+        REQUIRE(manifold.pointCount == 1);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, 1}));
+    }
+
+    SECTION("circle on rotated box corner") {
+        physics::CollideShape diamond =
+            physics::OBBShape::FromCenter({}, {10, 10}, cgmath::PI * 0.25);
+        physics::Manifold manifold;
+        REQUIRE(solver.GetContact(circle, {0, -20}, diamond, {}, manifold));
+        REQUIRE(manifold.pointCount == 1);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, -1}));
+        REQUIRE(manifold.depth == Approx(10 * std::sqrt(2.0f) - 10));
+    }
+
+    SECTION("box resting on box has two points") {
+        physics::CollideShape small =
+            physics::OBBShape::FromCenter({}, {10, 10}, 0.0);
+        physics::Manifold manifold;
+        REQUIRE(solver.GetContact(small, {30, -19}, box, {}, manifold));
+        REQUIRE(manifold.pointCount == 2);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, -1}));
+        REQUIRE(manifold.depth == Approx(1));
+
+        REQUIRE(solver.GetContact(small, {30, -21}, box, {}, manifold));
+        REQUIRE(manifold.pointCount == 0);
+    }
+
+    SECTION("polygons in any winding") {
+        physics::CollideShape ccw = physics::PolygonShape::From(
+            {{-10, -10}, {10, -10}, {10, 10}, {-10, 10}});
+        physics::CollideShape cw = physics::PolygonShape::From(
+            {{0, -10}, {-10, 10}, {10, 10}});
+        physics::Manifold manifold;
+        REQUIRE(solver.GetContact(cw, {0, -18}, ccw, {}, manifold));
+        REQUIRE(manifold.pointCount == 2);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, -1}));
+        REQUIRE(manifold.depth == Approx(2));
+
+        REQUIRE(solver.GetContact(ccw, {}, cw, {0, -18}, manifold));
+        REQUIRE(manifold.pointCount == 2);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, 1}));
+    }
+
+    SECTION("capsules") {
+        physics::CollideShape capsule = physics::CapsuleShape::FromCapsule(
+            geom2d::Capsule<physics::Real>::Create(physics::Vec2{-20, 0},
+                                                   physics::Vec2{20, 0}, 5));
+        physics::Manifold manifold;
+
+        // parallel
+        REQUIRE(solver.GetContact(capsule, {10, -8}, capsule, {}, manifold));
+        REQUIRE(manifold.pointCount == 2);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, -1}));
+        REQUIRE(manifold.depth == Approx(2));
+
+        // end to end
+        REQUIRE(solver.GetContact(capsule, {48, 0}, capsule, {}, manifold));
+        REQUIRE(manifold.pointCount == 1);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{1, 0}));
+        REQUIRE(manifold.depth == Approx(2));
+
+        // round end near box corner, faces overlap but shapes don't
+        REQUIRE(solver.GetContact(capsule, {124, -14}, box, {}, manifold));
+        REQUIRE(manifold.pointCount == 0);
+        REQUIRE(solver.GetContact(capsule, {123, -13}, box, {}, manifold));
+        REQUIRE(manifold.pointCount == 1);
+
+        // lying on box
+        REQUIRE(solver.GetContact(box, {}, capsule, {0, -14}, manifold));
+        REQUIRE(manifold.pointCount == 2);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, 1}));
+        REQUIRE(manifold.depth == Approx(1));
+
+        REQUIRE(solver.GetContact(circle, {0, -14}, capsule, {}, manifold));
+        REQUIRE(manifold.pointCount == 1);
+        REQUIRE(geom::IsSamePt(manifold.normal, physics::Vec2{0, -1}));
+        REQUIRE(manifold.depth == Approx(1));
+    }
+}
+
+TEST_CASE("contact solver") {
+    std::vector<physics::Body> bodies;
+    std::vector<physics::CollideShape> shapes;
+    bodies.reserve(6);
+    shapes.reserve(6);
+
+    bodies.push_back(physics::Body::CreateStatic({0, 100}));
+    shapes.emplace_back(physics::OBBShape::FromCenter({}, {100, 10}, 0.0));
+
+    // a stack of circles resting on the ground
+    for (int i = 0; i < 5; i++) {
+        bodies.push_back(physics::Body::CreateDynamic({0, 80.0f - i * 20}));
+        shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+    }
+
+    physics::World world;
+    world.forceGenerators.emplace_back(
+        [](physics::Body& body) { body.force += physics::Vec2{0, 980}; });
+    for (int i = 0; i < 600; i++) {
+        world.Step(1.0 / 60.0, bodies, shapes);
+    }
+
+    REQUIRE(bodies[1].pos.y - 80.0f < physics::LinearSlop * 2);
+    for (size_t i = 1; i < bodies.size(); i++) {
+        REQUIRE(std::abs(bodies[i].pos.x) < 0.001);
+        // keep stacked, penetration no more than slop
+        if (i + 1 < bodies.size()) {
+            auto dist = bodies[i].pos.y - bodies[i + 1].pos.y;
+            REQUIRE(dist > 20 - physics::LinearSlop * 2);
+            REQUIRE(dist < 20 + physics::LinearSlop * 2);
+        }
+    }
+}
+
+TEST_CASE("contact cache") {
+    physics::ManifoldSolver solver;
+    physics::CollideShape small =
+        physics::OBBShape::FromCenter({}, {10, 10}, 0.0);
+    physics::CollideShape box =
+        physics::OBBShape::FromCenter({}, {100, 10}, 0.0);
+
+    SECTION("feature ids are distinct and stable") {
+        physics::Manifold m1, m2;
+        REQUIRE(solver.GetContact(small, {30, -19}, box, {}, m1));
+        REQUIRE(solver.GetContact(small, {31, -18.5}, box, {}, m2));
+        REQUIRE(m1.pointCount == 2);
+        REQUIRE(m2.pointCount == 2);
+        REQUIRE(m1.ids[0] != m1.ids[1]);
+        REQUIRE(m1.ids[0] == m2.ids[0]);
+        REQUIRE(m1.ids[1] == m2.ids[1]);
+    }
+
+    SECTION("impulses follow ids when points swap") {
+        physics::Contact contact{};
+        contact.key = physics::MakeBodyPairKey(1, 2);
+        contact.manifold.pointCount = 2;
+        contact.manifold.ids[0] = 7;
+        contact.manifold.ids[1] = 9;
+        contact.normalImpulse[0] = 1;
+        contact.normalImpulse[1] = 2;
+        contact.tangentImpulse[0] = 3;
+        contact.tangentImpulse[1] = 4;
+
+        physics::ContactCache cache;
+        cache.Store({contact});
+
+        std::vector<physics::Contact> contacts(1);
+        contacts[0].key = contact.key;
+        contacts[0].manifold.pointCount = 2;
+        contacts[0].manifold.ids[0] = 9;
+        contacts[0].manifold.ids[1] = 7;
+        cache.Restore(contacts);
+        REQUIRE(contacts[0].normalImpulse[0] == 2);
+        REQUIRE(contacts[0].normalImpulse[1] == 1);
+        REQUIRE(contacts[0].tangentImpulse[0] == 4);
+        REQUIRE(contacts[0].tangentImpulse[1] == 3);
+
+        // one point left, still matched by id
+        contacts[0] = physics::Contact{};
+        contacts[0].key = contact.key;
+        contacts[0].manifold.pointCount = 1;
+        contacts[0].manifold.ids[0] = 9;
+        cache.Restore(contacts);
+        REQUIRE(contacts[0].normalImpulse[0] == 2);
+
+        // new feature starts cold
+        contacts[0] = physics::Contact{};
+        contacts[0].key = contact.key;
+        contacts[0].manifold.pointCount = 1;
+        contacts[0].manifold.ids[0] = 5;
+        cache.Restore(contacts);
+        REQUIRE(contacts[0].normalImpulse[0] == 0);
+    }
+}
+
+TEST_CASE("island") {
+    auto createScene = [](std::vector<physics::Body>& bodies,
+                          std::vector<physics::CollideShape>& shapes) {
+        bodies.reserve(64);
+        shapes.reserve(64);
+
+        // a shared ground must not link stacks into one island
+        bodies.push_back(physics::Body::CreateStatic({0, 100}));
+        shapes.emplace_back(physics::OBBShape::FromCenter({}, {1000, 10}, 0.0));
+
+        for (int stack = 0; stack < 8; stack++) {
+            for (int i = 0; i < 4; i++) {
+                bodies.push_back(physics::Body::CreateDynamic(
+                    {-800.0f + stack * 200, 80.0f - i * 21}));
+                shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+            }
+        }
+    };
+
+    std::vector<physics::Body> serialBodies, parallelBodies, sharedBodies;
+    std::vector<physics::CollideShape> serialShapes, parallelShapes,
+        sharedShapes;
+    createScene(serialBodies, serialShapes);
+    createScene(parallelBodies, parallelShapes);
+    createScene(sharedBodies, sharedShapes);
+
+    auto gravity = [](physics::Body& body) {
+        body.force += physics::Vec2{0, 980};
+    };
+
+    // keep all islands awake
+    physics::World serialWorld;
+    serialWorld.EnableSleeping(false);
+    serialWorld.forceGenerators.emplace_back(gravity);
+    physics::World parallelWorld;
+    parallelWorld.EnableSleeping(false);
+    parallelWorld.forceGenerators.emplace_back(gravity);
+    parallelWorld.SetWorkerCount(3);
+    JobPool sharedPool{2};
+    physics::World sharedWorld;
+    sharedWorld.EnableSleeping(false);
+    sharedWorld.forceGenerators.emplace_back(gravity);
+    sharedWorld.SetJobPool(&sharedPool);
+
+    for (int i = 0; i < 120; i++) {
+        serialWorld.Step(1.0 / 60.0, serialBodies, serialShapes);
+        parallelWorld.Step(1.0 / 60.0, parallelBodies, parallelShapes);
+        // a step nested in a job of the same pool runs on the caller thread
+        sharedPool.ParallelFor(2, [&](size_t job) {
+            if (job == 0) {
+                sharedWorld.Step(1.0 / 60.0, sharedBodies, sharedShapes);
+            }
+        });
+    }
+
+    SECTION("each stack is an island") {
+        REQUIRE(serialWorld.GetIslandCount() == 8);
+        REQUIRE(parallelWorld.GetIslandCount() == 8);
+    }
+
+    SECTION("same result whatever thread count") {
+        for (size_t i = 0; i < serialBodies.size(); i++) {
+            REQUIRE(serialBodies[i].pos == parallelBodies[i].pos);
+            REQUIRE(serialBodies[i].vel == parallelBodies[i].vel);
+            REQUIRE(serialBodies[i].pos == sharedBodies[i].pos);
+            REQUIRE(serialBodies[i].vel == sharedBodies[i].vel);
+        }
+    }
+}
+
+TEST_CASE("sleeping") {
+    std::vector<physics::Body> bodies;
+    std::vector<physics::CollideShape> shapes;
+    bodies.reserve(8);
+    shapes.reserve(8);
+
+    // static bodies overlap each other, like tiles
+    for (int i = 0; i < 3; i++) {
+        bodies.push_back(physics::Body::CreateStatic({i * 190.0f, 100}));
+        shapes.emplace_back(physics::OBBShape::FromCenter({}, {100, 10}, 0.0));
+    }
+    for (int i = 0; i < 3; i++) {
+        bodies.push_back(physics::Body::CreateDynamic({0, 80.0f - i * 20}));
+        shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+    }
+
+    physics::World world;
+    world.forceGenerators.emplace_back(
+        [](physics::Body& body) { body.force += physics::Vec2{0, 980}; });
+    for (int i = 0; i < 300; i++) {
+        world.Step(1.0 / 60.0, bodies, shapes);
+    }
+
+    SECTION("resting stack falls asleep") {
+        for (size_t i = 3; i < bodies.size(); i++) {
+            REQUIRE(bodies[i].sleeping);
+            REQUIRE(bodies[i].vel == physics::Vec2{});
+        }
+
+        auto positions = bodies;
+        world.Step(1.0 / 60.0, bodies, shapes);
+        REQUIRE(world.GetIslandCount() == 0);
+        for (size_t i = 0; i < bodies.size(); i++) {
+            REQUIRE(bodies[i].pos == positions[i].pos);
+        }
+    }
+
+    SECTION("sleeping pairs keep cached impulses") {
+        REQUIRE(world.GetCachedContactCount() == 3);
+        world.Step(1.0 / 60.0, bodies, shapes);
+        REQUIRE(world.GetCachedContactCount() == 3);
+
+        // a body moving far away doesn't drop them
+        bodies.push_back(physics::Body::CreateDynamic({380, 0}));
+        shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+        world.Step(1.0 / 60.0, bodies, shapes);
+        REQUIRE(world.GetIslandCount() == 1);
+        REQUIRE(world.GetCachedContactCount() == 3);
+    }
+
+    SECTION("touched by awake body wake whole stack") {
+        bodies.push_back(physics::Body::CreateDynamic({0, 0}));
+        shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+        bodies.back().vel = physics::Vec2{0, 200};
+
+        for (int i = 0; i < 10; i++) {
+            world.Step(1.0 / 60.0, bodies, shapes);
+        }
+        for (size_t i = 3; i < bodies.size(); i++) {
+            REQUIRE_FALSE(bodies[i].sleeping);
+        }
+    }
+
+    SECTION("touching top of stack wakes it in one step") {
+        bodies.push_back(physics::Body::CreateDynamic({0, 21}));
+        shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+        world.Step(1.0 / 60.0, bodies, shapes);
+        for (size_t i = 3; i < bodies.size(); i++) {
+            REQUIRE_FALSE(bodies[i].sleeping);
+        }
+        REQUIRE(world.GetIslandCount() == 1);
+    }
+
+    SECTION("applying force wake body and its island") {
+        bodies[3].force = physics::Vec2{100, 0};
+        world.Step(1.0 / 60.0, bodies, shapes);
+        for (size_t i = 3; i < bodies.size(); i++) {
+            REQUIRE_FALSE(bodies[i].sleeping);
+        }
+    }
+
+    SECTION("woken by user wakes its island") {
+        bodies[5].WakeUp();
+        world.Step(1.0 / 60.0, bodies, shapes);
+        for (size_t i = 3; i < bodies.size(); i++) {
+            REQUIRE_FALSE(bodies[i].sleeping);
+        }
+    }
+}
+
+TEST_CASE("dynamic AABB tree") {
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<physics::Real> posDist(0, 500);
+    std::uniform_real_distribution<physics::Real> sizeDist(1, 10);
+    std::uniform_real_distribution<physics::Real> moveDist(-20, 20);
+
+    physics::DynamicAABBTree tree{1};
+    std::vector<physics::AABB> bounds;
+    std::vector<uint32_t> proxies;
+    for (uint32_t i = 0; i < 500; i++) {
+        bounds.push_back(physics::AABB::FromCenter(
+            {posDist(gen), posDist(gen)}, {sizeDist(gen), sizeDist(gen)}));
+        proxies.push_back(tree.CreateProxy(bounds.back(), i));
+    }
+
+    auto check = [&]() {
+        for (int i = 0; i < 50; i++) {
+            auto query = physics::AABB::FromCenter(
+                {posDist(gen), posDist(gen)}, {20, 20});
+            std::vector<uint32_t> expect, result;
+            for (uint32_t j = 0; j < bounds.size(); j++) {
+                if (proxies[j] != physics::DynamicAABBTree::NullNode &&
+                    geom::IsAABBIntersect(query, bounds[j])) {
+                    expect.push_back(j);
+                }
+            }
+            tree.Query(query, [&](uint32_t proxy) {
+                auto idx = tree.GetUserData(proxy);
+                if (geom::IsAABBIntersect(query, bounds[idx])) {
+                    result.push_back(idx);
+                }
+                return true;
+            });
+            std::sort(result.begin(), result.end());
+            REQUIRE(result == expect);
+        }
+    };
+
+    check();
+    // balanced, much lower than proxy count
+    REQUIRE(tree.GetHeight() < 20);
+
+    SECTION("move and destroy") {
+        for (uint32_t i = 0; i < bounds.size(); i++) {
+            if (i % 3 == 0) {
+                tree.DestroyProxy(proxies[i]);
+                proxies[i] = physics::DynamicAABBTree::NullNode;
+            } else {
+                bounds[i].center += physics::Vec2{moveDist(gen), moveDist(gen)};
+                tree.MoveProxy(proxies[i], bounds[i]);
+            }
+        }
+        REQUIRE(tree.ProxyCount() == 333);
+        check();
+    }
+
+    SECTION("small move keeps proxy in place") {
+        auto aabb = bounds[0];
+        aabb.center.x += 0.5;
+        REQUIRE_FALSE(tree.MoveProxy(proxies[0], aabb));
+    }
+}
+
+TEST_CASE("raycast shape") {
+    physics::Vec2 from{-100, 0}, to{100, 0};
+
+    SECTION("circle") {
+        auto shape = physics::CircleShape::FromCenter({}, 10);
+        auto hit = physics::RaycastShape(shape, {50, 0}, from, to);
+        REQUIRE(hit);
+        REQUIRE(hit->fraction == Approx(0.7));
+        REQUIRE(geom::IsSamePt(hit->normal, physics::Vec2{-1, 0}));
+        REQUIRE_FALSE(physics::RaycastShape(shape, {50, 20}, from, to));
+        // start inside
+        REQUIRE_FALSE(physics::RaycastShape(shape, from, from, to));
+    }
+
+    SECTION("rotated box") {
+        auto shape =
+            physics::OBBShape::FromCenter({}, {10, 10}, cgmath::PI * 0.25);
+        auto hit = physics::RaycastShape(shape, {}, from, to);
+        REQUIRE(hit);
+        REQUIRE(hit->point.x == Approx(-10 * std::sqrt(2.0f)));
+        REQUIRE(std::abs(hit->normal.y) == Approx(std::sqrt(0.5f)));
+    }
+
+    SECTION("polygon in any winding") {
+        std::vector<physics::Vec2> pts{{0, -10}, {10, 10}, {-10, 10}};
+        for (int i = 0; i < 2; i++) {
+            auto shape = physics::PolygonShape::From(pts);
+            auto hit = physics::RaycastShape(shape, {}, {0, -100}, {0, 100});
+            REQUIRE(hit);
+            REQUIRE(geom::IsSamePt(hit->point, physics::Vec2{0, -10}));
+            hit = physics::RaycastShape(shape, {}, {-100, 5}, {100, 5});
+            REQUIRE(hit);
+            REQUIRE(hit->point.x == Approx(-7.5));
+            std::reverse(pts.begin(), pts.end());
+        }
+    }
+
+    SECTION("capsule") {
+        auto shape = physics::CapsuleShape::FromCapsule(
+            geom2d::Capsule<physics::Real>::Create(physics::Vec2{0, -20},
+                                                   physics::Vec2{0, 20}, 5));
+        auto hit = physics::RaycastShape(shape, {}, from, to);
+        REQUIRE(hit);
+        REQUIRE(hit->point.x == Approx(-5));
+        REQUIRE(geom::IsSamePt(hit->normal, physics::Vec2{-1, 0}));
+
+        hit = physics::RaycastShape(shape, {}, {0, -100}, {0, 100});
+        REQUIRE(hit);
+        REQUIRE(hit->point.y == Approx(-25));
+    }
+}
+
+TEST_CASE("world query") {
+    std::vector<physics::Body> bodies;
+    std::vector<physics::CollideShape> shapes;
+    for (int i = 0; i < 10; i++) {
+        bodies.push_back(physics::Body::CreateStatic({i * 50.0f, 0}));
+        shapes.emplace_back(physics::CircleShape::FromCenter({}, 10));
+    }
+    bodies.push_back(physics::Body::CreateStatic({225, 100}));
+    shapes.emplace_back(physics::OBBShape::FromCenter({}, {300, 10}, 0.0));
+
+    physics::World world;
+    world.Step(1.0 / 60.0, bodies, shapes);
+
+    SECTION("raycast find closest") {
+        auto hit = world.Raycast({-100, 0}, {1000, 0});
+        REQUIRE(hit);
+        REQUIRE(hit->id == 0);
+        REQUIRE(hit->point.x == Approx(-10));
+
+        hit = world.Raycast({125, -100}, {125, 1000});
+        REQUIRE(hit);
+        REQUIRE(hit->id == 10);
+        REQUIRE(hit->point.y == Approx(90));
+
+        REQUIRE_FALSE(world.Raycast({-100, 50}, {1000, 50}));
+    }
+
+    SECTION("batched raycast is same as single") {
+        world.SetWorkerCount(2);
+        std::vector<physics::RaycastInput> rays;
+        for (int i = 0; i < 100; i++) {
+            rays.push_back({{i * 5.0f, -100}, {i * 5.0f, 200}});
+        }
+        std::vector<std::optional<physics::RaycastHit>> hits;
+        world.Raycast(rays, hits);
+        REQUIRE(hits.size() == rays.size());
+        for (size_t i = 0; i < rays.size(); i++) {
+            auto hit = world.Raycast(rays[i].from, rays[i].to);
+            REQUIRE(hits[i].has_value() == hit.has_value());
+            if (hit) {
+                REQUIRE(hits[i]->id == hit->id);
+            }
+        }
+    }
+
+    SECTION("aabb query") {
+        std::vector<uint32_t> ids;
+        world.QueryAABB(physics::AABB::FromCenter({75, 0}, {30, 5}), ids);
+        std::sort(ids.begin(), ids.end());
+        REQUIRE(ids == std::vector<uint32_t>{1, 2});
+
+        std::vector<uint32_t> offsets;
+        world.QueryAABB({physics::AABB::FromCenter({0, 0}, {1, 1}),
+                         physics::AABB::FromCenter({0, -50}, {1, 1}),
+                         physics::AABB::FromCenter({450, 10}, {1, 85})},
+                        ids, offsets);
+        REQUIRE(offsets == std::vector<uint32_t>{0, 1, 1, 3});
+        std::sort(ids.begin() + 1, ids.end());
+        REQUIRE(ids == std::vector<uint32_t>{0, 9, 10});
+    }
+
+    SECTION("shape cast") {
+        auto box = physics::OBBShape::FromCenter({}, {5, 5}, 0.0);
+        auto hit = world.ShapeCast(box, {25, -100}, {25, 300});
+        REQUIRE(hit);
+        REQUIRE(hit->id == 10);
+        REQUIRE(hit->fraction * 400 - 100 == Approx(85).margin(0.1));
+        REQUIRE(geom::IsSamePt(hit->normal, physics::Vec2{0, -1}));
+
+        hit = world.ShapeCast(box, {-100, 0}, {300, 0});
+        REQUIRE(hit);
+        REQUIRE(hit->id == 0);
+        REQUIRE(hit->fraction * 400 - 100 == Approx(-15).margin(0.1));
+
+        // overlapped at start, unless ignored
+        hit = world.ShapeCast(box, {0, 0}, {0, -100});
+        REQUIRE(hit);
+        REQUIRE(hit->fraction == 0);
+        REQUIRE_FALSE(world.ShapeCast(box, {0, 0}, {0, -100}, 0));
+    }
+
+    SECTION("static shape edited in place is queried") {
+        static_cast<physics::CircleShape&>(*shapes[0].shape).shape.radius = 40;
+        static_cast<physics::OBBShape&>(*shapes[10].shape).shape.halfLen = {
+            300, 30};
+        world.Step(1.0 / 60.0, bodies, shapes);
+
+        auto hit = world.Raycast({-100, 0}, {1000, 0});
+        REQUIRE(hit);
+        REQUIRE(hit->id == 0);
+        REQUIRE(hit->point.x == Approx(-40));
+
+        hit = world.Raycast({125, -100}, {125, 1000});
+        REQUIRE(hit);
+        REQUIRE(hit->id == 10);
+        REQUIRE(hit->point.y == Approx(70));
+    }
+
+    SECTION("removed bodies leave index") {
+        bodies.pop_back();
+        shapes.pop_back();
+        world.Step(1.0 / 60.0, bodies, shapes);
+        REQUIRE_FALSE(world.Raycast({125, -100}, {125, 1000}));
+    }
+}
@@ -0,0 +1,83 @@
+#include "common/range_allocator.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace nickel;
+
+TEST_CASE("range allocator allocate and free") {
+    RangeAllocator allocator{1024};
+    REQUIRE(allocator.Empty());
+    REQUIRE(allocator.LargestFreeRange() == 1024);
+
+    auto a = allocator.Allocate(100);
+    auto b = allocator.Allocate(200);
+    auto c = allocator.Allocate(300);
+    REQUIRE(a == 0);
+    REQUIRE(b == 100);
+    REQUIRE(c == 300);
+    REQUIRE(allocator.UsedSize() == 600);
+    REQUIRE(allocator.AllocationCount() == 3);
+    REQUIRE(allocator.Allocate(1000) == RangeAllocator::InvalidOffset);
+
+    allocator.Free(b);
+    REQUIRE(allocator.FreeRangeCount() == 2);
+    REQUIRE(allocator.LargestFreeRange() == 424);
+
+    // merge with both neighbours
+    allocator.Free(a);
+    allocator.Free(c);
+    REQUIRE(allocator.Empty());
+    REQUIRE(allocator.UsedSize() == 0);
+    REQUIRE(allocator.FreeRangeCount() == 1);
+    REQUIRE(allocator.LargestFreeRange() == 1024);
+}
+
+TEST_CASE("range allocator alignment") {
+    RangeAllocator allocator{1024};
+    auto a = allocator.Allocate(10);
+    auto b = allocator.Allocate(64, 256);
+    REQUIRE(a == 0);
+    REQUIRE(b == 256);
+
+    // padding before aligned range is still usable
+    auto c = allocator.Allocate(200);
+    REQUIRE(c == 10);
+
+    allocator.Free(a);
+    allocator.Free(b);
+    allocator.Free(c);
+    REQUIRE(allocator.FreeRangeCount() == 1);
+    REQUIRE(allocator.LargestFreeRange() == 1024);
+}
+
+TEST_CASE("range allocator best fit") {
+    RangeAllocator allocator{1024};
+    auto a = allocator.Allocate(100);
+    auto hole1 = allocator.Allocate(300);
+    auto b = allocator.Allocate(100);
+    auto hole2 = allocator.Allocate(50);
+    auto c = allocator.Allocate(100);
+    allocator.Free(hole1);
+    allocator.Free(hole2);
+
+    // smallest hole which can hold it
+    REQUIRE(allocator.Allocate(40) == hole2);
+    REQUIRE(allocator.Allocate(60) == hole1);
+
+    (void)a, (void)b, (void)c;
+}
+
+TEST_CASE("linear allocator") {
+    LinearAllocator allocator{256};
+    REQUIRE(allocator.Allocate(10) == 0);
+    REQUIRE(allocator.Allocate(16, 16) == 16);
+    REQUIRE(allocator.Allocate(300) == LinearAllocator::InvalidOffset);
+    REQUIRE(allocator.UsedSize() == 32);
+
+    allocator.Reset();
+    REQUIRE(allocator.UsedSize() == 0);
+    REQUIRE(allocator.PeakUsedSize() == 32);
+    REQUIRE(allocator.Allocate(256) == 0);
+    REQUIRE(allocator.Allocate(1) == LinearAllocator::InvalidOffset);
+}
@@ -0,0 +1,93 @@
+#include "nickel.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <fstream>
+
+using namespace nickel;
+
+namespace {
+
+/**
+ * @brief script counts its updates in entity's rotation as
+ * `offset + count * 10 + sandboxed`, and bumps witness's rotation on quit
+ */
+void writeScript(const std::filesystem::path& path, gecs::entity witness,
+                 int offset) {
+    std::ofstream file(path, std::ios::trunc);
+    file << "local sandboxed = not pcall(function() string.upper = nil end)\n"
+            "    and not pcall(function() _G.leak = 1 end)\n"
+            "count = 0\n"
+            "function on_update(entity: number)\n"
+            "    count = count + 1\n"
+            "    nickel.ecs.GetTransform(entity).rotation = "
+         << offset
+         << " + count * 10 + (sandboxed and 1 or 0)\n"
+            "end\n"
+            "function on_quit()\n"
+            "    local t = nickel.ecs.GetTransform("
+         << std::underlying_type_t<gecs::entity>(witness)
+         << ")\n"
+            "    t.rotation = t.rotation + 1\n"
+            "end\n";
+}
+
+}  // namespace
+
+TEST_CASE("shared script VM") {
+    auto dir = std::filesystem::temp_directory_path() / "nickel_script_vm";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto path = dir / "counter.luau";
+
+    auto& world = ECS::Instance().World();
+    auto& reg = world.regist_registry("ScriptTest");
+    world.start_with("ScriptTest");
+    auto cmds = reg.commands();
+    cmds.emplace_resource<Keyboard>();
+    auto& mgr = cmds.emplace_resource<ScriptManager>(ScriptManager::Mode::Shared);
+    reg.regist_update_system<ScriptUpdateSystem>()
+        .regist_shutdown_system<ScriptShutdownSystem>();
+    world.startup();
+
+    auto witness = cmds.create();
+    cmds.emplace<Transform>(witness);
+    writeScript(path, witness, 0);
+    auto handle = mgr.Load(path);
+    REQUIRE(handle);
+
+    std::vector<gecs::entity> entities;
+    for (int i = 0; i < 2; i++) {
+        auto ent = cmds.create();
+        cmds.emplace<Transform>(ent);
+        cmds.emplace<Script>(ent, Script{handle, ent});
+        entities.push_back(ent);
+    }
+    auto a = entities[0], b = entities[1];
+
+    // a shared env would count twice per frame
+    world.update();
+    world.update();
+    REQUIRE(mgr.InstanceCount() == 2);
+    REQUIRE(reg.get<Transform>(a).rotation == 21);
+    REQUIRE(reg.get<Transform>(b).rotation == 21);
+
+    // destroyed entity runs on_quit and leaves the VM
+    cmds.destroy(b);
+    world.update();
+    REQUIRE(mgr.InstanceCount() == 1);
+    REQUIRE(reg.get<Transform>(witness).rotation == 1);
+    REQUIRE(reg.get<Transform>(a).rotation == 31);
+
+    // reloaded script recreates instances with fresh state
+    writeScript(path, witness, 100);
+    mgr.Get(handle) = LuaScript(path);
+    world.update();
+    REQUIRE(mgr.InstanceCount() == 1);
+    REQUIRE(reg.get<Transform>(witness).rotation == 2);
+    REQUIRE(reg.get<Transform>(a).rotation == 111);
+
+    world.shutdown();
+    std::filesystem::remove_all(dir);
+}
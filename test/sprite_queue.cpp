@@ -0,0 +1,159 @@
+#include "graphics/sprite_queue.hpp"
+#include "graphics/sprite.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <random>
+
+using namespace nickel;
+
+namespace {
+
+// queue only keeps addresses of render states, never reads them
+template <typename T>
+const T& fakeState() {
+    alignas(T) static unsigned char storage[sizeof(T)];
+    return *reinterpret_cast<const T*>(storage);
+}
+
+SpriteRenderQueue::Key makeKey(int layer, HandleInnerIDType material,
+                               HandleInnerIDType texture) {
+    return SpriteRenderQueue::MakeKey(
+        layer, Material2DHandle::ForceCastFromIntegral(material),
+        TextureHandle::ForceCastFromIntegral(texture));
+}
+
+void push(SpriteRenderQueue& queue, uint32_t entity,
+          SpriteRenderQueue::Key key) {
+    static Transform transform;
+    queue.Push(static_cast<gecs::entity>(entity), key, transform,
+               fakeState<Sprite>(), fakeState<Material2D>(),
+               fakeState<Texture>());
+}
+
+bool isSorted(const SpriteRenderQueue& queue) {
+    auto& entries = queue.Entries();
+    for (size_t i = 1; i < entries.size(); i++) {
+        auto& a = entries[i - 1];
+        auto& b = entries[i];
+        if (b.key < a.key || (a.key == b.key && b.entity < a.entity)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("sprite sort key") {
+    REQUIRE(makeKey(-1, 9, 9) < makeKey(0, 1, 1));
+    REQUIRE(makeKey(0, 9, 9) < makeKey(1, 1, 1));
+    REQUIRE(makeKey(0, 1, 9) < makeKey(0, 2, 1));
+    REQUIRE(makeKey(0, 1, 1) < makeKey(0, 1, 2));
+
+    // full handle ids are kept
+    REQUIRE(makeKey(0, 1, 1) != makeKey(0, 1 + 65536, 1));
+    REQUIRE(makeKey(0, 1, 1) != makeKey(0, 1, 1 + 65536));
+    REQUIRE(makeKey(0, 65536, 1) < makeKey(0, 65537, 1));
+    REQUIRE(makeKey(0, 0xFFFFFFFF, 1) < makeKey(1, 0, 0));
+}
+
+TEST_CASE("sprite render queue") {
+    constexpr uint32_t Count = 200;
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> layerDist(-3, 3);
+    std::uniform_int_distribution<HandleInnerIDType> idDist(1, 1 << 20);
+    auto randomKey = [&] {
+        return makeKey(layerDist(gen), idDist(gen), idDist(gen));
+    };
+
+    SpriteRenderQueue queue;
+    std::vector<SpriteRenderQueue::Key> keys(Count);
+    for (auto& key : keys) {
+        key = randomKey();
+    }
+
+    auto pushAll = [&] {
+        queue.BeginFrame();
+        for (uint32_t i = 0; i < Count; i++) {
+            push(queue, i, keys[i]);
+        }
+    };
+
+    pushAll();
+    REQUIRE(queue.DirtyCount() == Count);
+    queue.Sort();
+    REQUIRE(queue.Entries().size() == Count);
+    REQUIRE(isSorted(queue));
+
+    SECTION("unchanged keys are not dirty") {
+        pushAll();
+        REQUIRE(queue.DirtyCount() == 0);
+        queue.Sort();
+        REQUIRE(isSorted(queue));
+    }
+
+    SECTION("key change in colliding handle bits is seen") {
+        keys[7] = makeKey(0, 1, 1);
+        pushAll();
+        queue.Sort();
+        keys[7] = makeKey(0, 1 + 65536, 1);
+        pushAll();
+        REQUIRE(queue.DirtyCount() == 1);
+    }
+
+    SECTION("few changes sort incrementally") {
+        for (int frame = 0; frame < 10; frame++) {
+            for (int i = 0; i < 5; i++) {
+                keys[gen() % Count] = randomKey();
+            }
+            pushAll();
+            REQUIRE(queue.DirtyCount() <= 5);
+            queue.Sort();
+            REQUIRE(queue.Entries().size() == Count);
+            REQUIRE(isSorted(queue));
+        }
+    }
+
+    SECTION("many changes sort fully") {
+        for (int frame = 0; frame < 3; frame++) {
+            for (auto& key : keys) {
+                key = randomKey();
+            }
+            pushAll();
+            queue.Sort();
+            REQUIRE(queue.Entries().size() == Count);
+            REQUIRE(isSorted(queue));
+        }
+    }
+
+    SECTION("sprites not pushed are removed") {
+        queue.BeginFrame();
+        for (uint32_t i = 0; i < Count; i += 2) {
+            push(queue, i, keys[i]);
+        }
+        REQUIRE(queue.DirtyCount() == 0);
+        queue.Sort();
+        REQUIRE(queue.Entries().size() == Count / 2);
+        REQUIRE(isSorted(queue));
+        for (auto& entry : queue.Entries()) {
+            REQUIRE(static_cast<uint32_t>(entry.entity) % 2 == 0);
+        }
+
+        // indices stay valid after removal, key changes are still found
+        keys[4] = randomKey();
+        queue.BeginFrame();
+        for (uint32_t i = 0; i < Count; i += 2) {
+            push(queue, i, keys[i]);
+        }
+        REQUIRE(queue.DirtyCount() == 1);
+        queue.Sort();
+        REQUIRE(queue.Entries().size() == Count / 2);
+        REQUIRE(isSorted(queue));
+        for (auto& entry : queue.Entries()) {
+            REQUIRE(entry.key == keys[static_cast<uint32_t>(entry.entity)]);
+        }
+    }
+}
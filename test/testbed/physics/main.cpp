@@ -30,11 +30,13 @@ struct Control {};
 void TestbedStartup(gecs::commands cmds,
                     gecs::resource<gecs::mut<physics::World>> world) {
     world->forceGenerators.emplace_back([](physics::Body& b) {
-        b.force += cgmath::Vec2{0, 0.98};
+        // gravity in pixel/s^2, scale by mass so all bodies fall equally
+        b.force += cgmath::Vec2{0, 980} / b.massInv;
     });
 
     auto ent2 = cmds.create();
     cmds.emplace<physics::Body>(ent2, physics::Body::CreateStatic({500, 500}));
+    cmds.emplace<Transform>(ent2, Transform::FromTranslation({500, 500}));
     cmds.emplace<physics::CollideShape>(
         ent2, physics::OBBShape::FromCenter({}, {400, 25}, 0.0));
 
@@ -46,21 +48,24 @@ void TestbedStartup(gecs::commands cmds,
     // cmds.emplace<Control>(ent3);
 }
 
-void RenderBodies(gecs::querier<physics::Body> bodies,
+// draw from `Transform`, which holds interpolated body position
+void RenderBodies(gecs::querier<physics::Body, Transform> bodies,
                   gecs::resource<gecs::mut<Renderer2D>> renderer) {
-    for (auto&& [_, body] : bodies) {
-        renderer->DrawCircle(body.pos, 5, {0, 1, 0, 1});
+    for (auto&& [_, body, transform] : bodies) {
+        renderer->DrawCircle(transform.translation, 5, {0, 1, 0, 1});
     }
 }
 
-void RenderShapes(gecs::querier<physics::Body, physics::CollideShape> querier,
-                  gecs::resource<gecs::mut<Renderer2D>> renderer) {
-    for (auto&& [_, body, shape] : querier) {
+void RenderShapes(
+    gecs::querier<physics::Body, Transform, physics::CollideShape> querier,
+    gecs::resource<gecs::mut<Renderer2D>> renderer) {
+    for (auto&& [_, body, transform, shape] : querier) {
+        auto& pos = transform.translation;
         switch (shape.shape->GetType()) {
             case physics::Shape::Type::Circle: {
                 auto& c = physics::shape_cast<const physics::CircleShape&>(
                     *shape.shape);
-                renderer->DrawCircle(c.shape.center + body.pos, c.shape.radius,
+                renderer->DrawCircle(c.shape.center + pos, c.shape.radius,
                                      {1, 0, 1, 1});
             } break;
             case physics::Shape::Type::OBB: {
@@ -71,10 +76,10 @@ void RenderShapes(gecs::querier<physics::Body, physics::CollideShape> querier,
                 auto&& [xAxis, yAxis] = s.GetAxis();
                 renderer->DrawLineLoop(
                     std::vector<cgmath::Vec2>{
-                        body.pos + s.center + (-xAxis - yAxis) * s.halfLen,
-                        body.pos + s.center + (xAxis - yAxis) * s.halfLen,
-                        body.pos + s.center + (xAxis + yAxis) * s.halfLen,
-                        body.pos + s.center + (-xAxis + yAxis) * s.halfLen,
+                        pos + s.center + (-xAxis - yAxis) * s.halfLen,
+                        pos + s.center + (xAxis - yAxis) * s.halfLen,
+                        pos + s.center + (xAxis + yAxis) * s.halfLen,
+                        pos + s.center + (-xAxis + yAxis) * s.halfLen,
                     },
                     {1, 0, 1, 1});
             } break;
@@ -105,7 +110,10 @@ void ShootCircle(gecs::commands cmds, gecs::resource<Mouse> mouse,
         auto ent = cmds.create();
         auto& body = cmds.emplace<physics::Body>(
             ent, physics::Body::CreateDynamic(cgmath::Vec2{400, 200}));
-        body.force = cgmath::Normalize(mouse->Position() - body.pos) * 10;
+        // a one-frame force would act on 0~N fixed steps depending on frame
+        // time, so give it initial velocity instead
+        body.vel = cgmath::Normalize(mouse->Position() - body.pos) * 500;
+        cmds.emplace<Transform>(ent, Transform::FromTranslation(body.pos));
         auto& shape = cmds.emplace<physics::CollideShape>(
             ent, physics::CircleShape::FromCenter(cgmath::Vec2{}, 30));
     }
@@ -114,6 +122,8 @@ void ShootCircle(gecs::commands cmds, gecs::resource<Mouse> mouse,
         auto ent1 = cmds.create();
         cmds.emplace<physics::Body>(
             ent1, physics::Body::CreateDynamic(cgmath::Vec2{200, 200}));
+        cmds.emplace<Transform>(ent1,
+                                Transform::FromTranslation({200, 200}));
         auto& shape = cmds.emplace<physics::CollideShape>(
             ent1, physics::CircleShape::FromCenter(cgmath::Vec2{}, 30));
     }
@@ -137,6 +147,7 @@ void BootstrapSystem(gecs::world& world,
         .regist_startup_system<TestbedStartup>()
         .regist_update_system<ShootCircle>()
         .regist_update_system<physics::PhysicsUpdate>()
+        .regist_update_system<physics::PhysicsSyncTransform>()
         .regist_update_system<RenderBodies>()
         .regist_update_system<RenderShapes>()
         .regist_update_system<plugin::ImGuiStart>()
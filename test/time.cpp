@@ -0,0 +1,63 @@
+#include "common/timer.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <thread>
+
+using namespace nickel;
+
+constexpr uint64_t Ms = 1'000'000;
+
+TEST_CASE("frame timing without pacing") {
+    Time::SetFPS(0);
+    Time time;
+    auto initDelta = time.SmoothedDeltaSeconds();
+    REQUIRE(time.HistoryCount() == 0);
+    REQUIRE(time.AverageFrameNs() == 0);
+
+    for (int i = 0; i < 5; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2 + i));
+        time.Tick();
+    }
+
+    REQUIRE(time.HistoryCount() == 5);
+    for (size_t i = 0; i < time.HistoryCount(); i++) {
+        auto& timing = time.GetFrameTiming(i);
+        // newest first, frame i ago slept 2 + (4 - i) ms
+        REQUIRE(timing.frame >= (6 - i) * Ms);
+        REQUIRE(timing.work + timing.wait == timing.frame);
+        REQUIRE(timing.wait < Ms);
+    }
+    REQUIRE(time.ElapseNs() == time.GetFrameTiming(0).frame);
+
+    REQUIRE(time.AverageFrameNs() >= 4 * Ms);
+    REQUIRE(time.AverageFrameNs() <= time.MaxFrameNs());
+    REQUIRE(time.MaxFrameNs() >= 6 * Ms);
+
+    // moves toward real delta, but slowly
+    REQUIRE(time.SmoothedDeltaSeconds() > initDelta);
+    REQUIRE(time.SmoothedDeltaSeconds() < time.MaxFrameNs() / 1e9);
+
+    for (size_t i = 0; i < Time::HistorySize + 10; i++) {
+        time.Tick();
+    }
+    REQUIRE(time.HistoryCount() == Time::HistorySize);
+
+    Time::SetFPS(60);
+}
+
+TEST_CASE("frame pacing follows FPS change") {
+    Time::SetFPS(30);
+    Time time;
+    time.Tick();
+    REQUIRE(time.GetFrameTiming().frame >= 30 * Ms);
+
+    // next frame must not wait for the old 33ms deadline
+    Time::SetFPS(240);
+    time.Tick();
+    REQUIRE(time.GetFrameTiming().frame >= 4 * Ms);
+    REQUIRE(time.GetFrameTiming().frame < 20 * Ms);
+
+    Time::SetFPS(60);
+}
@@ -0,0 +1,152 @@
+#include "common/timer_wheel.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <map>
+#include <random>
+#include <set>
+
+using namespace nickel;
+
+TEST_CASE("timer wheel schedule and cancel") {
+    TimerWheel wheel;
+    std::vector<TimerWheel::Expired> expired;
+
+    auto a = wheel.Schedule(10, 1);
+    auto b = wheel.Schedule(10, 2);
+    auto c = wheel.Schedule(300, 3);
+    REQUIRE(wheel.Size() == 3);
+    REQUIRE(wheel.RemainingTicks(c) == 300);
+
+    REQUIRE(wheel.Cancel(b));
+    REQUIRE_FALSE(wheel.Cancel(b));
+    REQUIRE_FALSE(wheel.IsScheduled(b));
+
+    wheel.Advance(9, expired);
+    REQUIRE(expired.empty());
+    wheel.Advance(1, expired);
+    REQUIRE(expired.size() == 1);
+    REQUIRE(expired[0].entry == a);
+    REQUIRE(expired[0].userData == 1);
+    REQUIRE_FALSE(wheel.IsScheduled(a));
+
+    // node is reused, old id stays invalid
+    auto d = wheel.Schedule(1, 4);
+    REQUIRE(d != a);
+    REQUIRE_FALSE(wheel.Cancel(a));
+    REQUIRE(wheel.IsScheduled(d));
+
+    expired.clear();
+    wheel.Advance(290, expired);
+    REQUIRE(expired.size() == 2);
+    REQUIRE(expired[0].userData == 4);
+    REQUIRE(expired[1].userData == 3);
+    REQUIRE(wheel.CurrentTick() == 300);
+    REQUIRE(wheel.Size() == 0);
+
+    // zero delay expires in next tick
+    expired.clear();
+    wheel.Schedule(0, 5);
+    wheel.Advance(1, expired);
+    REQUIRE(expired.size() == 1);
+}
+
+TEST_CASE("timer wheel clear") {
+    TimerWheel wheel;
+    std::vector<TimerWheel::Expired> expired;
+
+    auto a = wheel.Schedule(10, 1);
+    auto b = wheel.Schedule(20, 2);
+    wheel.Cancel(b);
+    wheel.Clear();
+    REQUIRE(wheel.Size() == 0);
+    REQUIRE_FALSE(wheel.IsScheduled(a));
+
+    // nodes are reused, ids before clear never match new timers
+    auto c = wheel.Schedule(10, 3);
+    auto d = wheel.Schedule(10, 4);
+    auto e = wheel.Schedule(10, 5);
+    REQUIRE(wheel.Size() == 3);
+    for (auto old : {a, b}) {
+        REQUIRE(old != c);
+        REQUIRE(old != d);
+        REQUIRE_FALSE(wheel.Cancel(old));
+    }
+    REQUIRE(wheel.Size() == 3);
+
+    wheel.Advance(10, expired);
+    REQUIRE(expired.size() == 3);
+    REQUIRE_FALSE(wheel.IsScheduled(e));
+}
+
+TEST_CASE("timer wheel repeating timer") {
+    TimerWheel wheel;
+    std::vector<TimerWheel::Expired> expired;
+
+    auto three = wheel.Schedule(5, 1, 100, 3);
+    auto forever = wheel.Schedule(1000, 2, 1000, -1);
+
+    wheel.Advance(205, expired);
+    REQUIRE(expired.size() == 3);
+    REQUIRE_FALSE(wheel.IsScheduled(three));
+
+    expired.clear();
+    wheel.Advance(100000 - 205, expired);
+    REQUIRE(expired.size() == 100);
+    REQUIRE(wheel.IsScheduled(forever));
+    REQUIRE(wheel.RemainingTicks(forever) == 1000);
+    REQUIRE(wheel.Cancel(forever));
+}
+
+TEST_CASE("timer wheel matches brute force") {
+    std::mt19937 gen{1};
+    TimerWheel wheel;
+    std::vector<TimerWheel::Expired> expired;
+
+    // expire tick -> userData, cancelled ones removed
+    std::multimap<uint64_t, uint64_t> expect;
+    std::map<uint64_t, std::pair<TimerWheel::EntryID, uint64_t>> live;
+    uint64_t userData = 0;
+
+    for (int round = 0; round < 2000; round++) {
+        int op = gen() % 10;
+        if (op < 6) {
+            // mostly short cooldowns, some far ones across wheels
+            uint64_t delay = gen() % 4 == 0 ? gen() % (1 << 22) : gen() % 500;
+            auto entry = wheel.Schedule(delay, userData);
+            auto expire = wheel.CurrentTick() + std::max<uint64_t>(delay, 1);
+            expect.emplace(expire, userData);
+            live[userData] = {entry, expire};
+            userData++;
+        } else if (op < 8 && !live.empty()) {
+            auto it = std::next(live.begin(), gen() % live.size());
+            REQUIRE(wheel.Cancel(it->second.first));
+            auto [first, last] = expect.equal_range(it->second.second);
+            for (auto e = first; e != last; ++e) {
+                if (e->second == it->first) {
+                    expect.erase(e);
+                    break;
+                }
+            }
+            live.erase(it);
+        } else {
+            uint64_t ticks = gen() % 3 == 0 ? gen() % 100000 : gen() % 64;
+            expired.clear();
+            wheel.Advance(ticks, expired);
+
+            std::multiset<uint64_t> got, want;
+            for (auto& e : expired) {
+                got.insert(e.userData);
+                live.erase(e.userData);
+            }
+            auto end = expect.upper_bound(wheel.CurrentTick());
+            for (auto it = expect.begin(); it != end; ++it) {
+                want.insert(it->second);
+            }
+            expect.erase(expect.begin(), end);
+            REQUIRE(got == want);
+        }
+        REQUIRE(wheel.Size() == expect.size());
+    }
+}
@@ -0,0 +1,137 @@
+#include "graphics/rhi/vk/memory.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace nickel::rhi::vulkan;
+
+// headless device, works on software ICDs(e.g. lavapipe) in CI
+struct HeadlessDevice final {
+    vk::Instance instance;
+    vk::PhysicalDevice phyDevice;
+    vk::Device device;
+
+    HeadlessDevice() {
+        vk::ApplicationInfo appInfo;
+        appInfo.setApiVersion(VK_API_VERSION_1_1);
+        vk::InstanceCreateInfo instInfo;
+        instInfo.setPApplicationInfo(&appInfo);
+        auto inst = vk::createInstance(instInfo);
+        if (inst.result != vk::Result::eSuccess) {
+            return;
+        }
+        instance = inst.value;
+
+        auto phyDevices = instance.enumeratePhysicalDevices();
+        if (phyDevices.result != vk::Result::eSuccess ||
+            phyDevices.value.empty()) {
+            return;
+        }
+        phyDevice = phyDevices.value[0];
+
+        float priority = 1.0f;
+        vk::DeviceQueueCreateInfo queueInfo;
+        queueInfo.setQueueFamilyIndex(0).setQueuePriorities(priority);
+        vk::DeviceCreateInfo devInfo;
+        devInfo.setQueueCreateInfos(queueInfo);
+        auto dev = phyDevice.createDevice(devInfo);
+        if (dev.result == vk::Result::eSuccess) {
+            device = dev.value;
+        }
+    }
+
+    ~HeadlessDevice() {
+        if (device) {
+            device.destroy();
+        }
+        if (instance) {
+            instance.destroy();
+        }
+    }
+
+    explicit operator bool() const { return static_cast<bool>(device); }
+};
+
+static vk::MemoryRequirements bufferRequirements(uint64_t size) {
+    vk::MemoryRequirements requirements;
+    requirements.setSize(size).setAlignment(256).setMemoryTypeBits(~0u);
+    return requirements;
+}
+
+constexpr auto HostVisible = vk::MemoryPropertyFlagBits::eHostVisible;
+constexpr auto Buffer = MemoryAllocator::ResourceType::Buffer;
+
+TEST_CASE("vulkan memory allocator") {
+    HeadlessDevice device;
+    if (!device) {
+        WARN("no vulkan device found, skip test");
+        return;
+    }
+
+    {
+        MemoryAllocator allocator{device.phyDevice, device.device};
+
+        SECTION("suballocate from one block") {
+            auto a = allocator.Allocate(bufferRequirements(1000), HostVisible,
+                                        Buffer);
+            auto b = allocator.Allocate(bufferRequirements(1000), HostVisible,
+                                        Buffer);
+            REQUIRE(a);
+            REQUIRE(b);
+            REQUIRE(a.block);
+            REQUIRE(a.block == b.block);
+            REQUIRE(a.memory == b.memory);
+            REQUIRE(a.offset != b.offset);
+            REQUIRE(a.offset % 256 == 0);
+            REQUIRE(b.offset % 256 == 0);
+            REQUIRE(a.mapped);
+            REQUIRE(b.mapped);
+
+            auto stat = allocator.GetStatistics();
+            REQUIRE(stat.blockCount == 1);
+            REQUIRE(stat.allocationCount == 2);
+            REQUIRE(stat.dedicatedCount == 0);
+
+            allocator.Free(a);
+            allocator.Free(b);
+        }
+
+        SECTION("freed block is reused") {
+            auto a = allocator.Allocate(bufferRequirements(4096), HostVisible,
+                                        Buffer);
+            REQUIRE(a);
+            auto memory = a.memory;
+            allocator.Free(a);
+
+            // one empty block is kept in pool
+            auto stat = allocator.GetStatistics();
+            REQUIRE(stat.blockCount == 1);
+            REQUIRE(stat.allocationCount == 0);
+            REQUIRE(stat.usedBytes == 0);
+
+            auto b = allocator.Allocate(bufferRequirements(4096), HostVisible,
+                                        Buffer);
+            REQUIRE(b);
+            REQUIRE(b.memory == memory);
+            REQUIRE(b.offset == 0);
+            REQUIRE(allocator.GetStatistics().blockCount == 1);
+            allocator.Free(b);
+        }
+
+        SECTION("large resource gets dedicated memory") {
+            auto a = allocator.Allocate(bufferRequirements(48 * 1024 * 1024),
+                                        HostVisible, Buffer);
+            REQUIRE(a);
+            REQUIRE_FALSE(a.block);
+            REQUIRE(a.offset == 0);
+
+            auto stat = allocator.GetStatistics();
+            REQUIRE(stat.blockCount == 0);
+            REQUIRE(stat.dedicatedCount == 1);
+            REQUIRE(stat.dedicatedBytes >= 48 * 1024 * 1024);
+
+            allocator.Free(a);
+            REQUIRE(allocator.GetStatistics().dedicatedCount == 0);
+        }
+    }
+}